@@ -47,6 +47,12 @@ app.post('/upload', function(req, res) {
 
   let uploadFile = req.files.uploadFile;
 
+  // Validate the upload straight from memory, so invalid files never reach uploads/
+  let result = library.validImageBufferToJSON(uploadFile.data, uploadFile.data.length, schemaFile);
+  if (result == null) {
+    return res.status(400).send('Invalid SVG file.');
+  }
+
   // Use the mv() method to place the file somewhere on your server
   uploadFile.mv('uploads/' + uploadFile.name, function(err) {
     if(err) {
@@ -73,9 +79,14 @@ app.get('/uploads/:name', function(req , res){
 
 
 var library = ffi.Library('./parser/bin/libsvgparser.so', {
-  'validImageToJSON': ['string', ['string', 'string']]
+  'validImageToJSON': ['string', ['string', 'string']],
+  'validImageBufferToJSON': ['string', ['pointer', 'int', 'string']],
+  'validImageBoundsToJSON': ['string', ['string', 'string']]
 });
 
+// Schema every SVG is validated against
+const schemaFile = "parser/bin/testFiles/svg.xsd";
+
 //Sample endpoint
 app.get('/fileInput', function(req , res){
   const fs = require('fs');
@@ -85,7 +96,7 @@ app.get('/fileInput', function(req , res){
   let images = [];
   files.forEach(file => {
     //console.log('This is the file: ' + file + "\n");
-    var result = JSON.parse(library.validImageToJSON('./uploads/' + file, "parser/bin/testFiles/svg.xsd"));
+    var result = JSON.parse(library.validImageToJSON('./uploads/' + file, schemaFile));
     //console.log('Should be an object: ' + result + '\n');
 
     if (result != null) {
@@ -112,5 +123,15 @@ app.get('/fileInput', function(req , res){
   });
 });
 
+//Bounding box of an uploaded image, so the page can fit it to a viewport without loading it
+app.get('/fileBounds/:name', function(req , res){
+  let result = library.validImageBoundsToJSON('./uploads/' + path.basename(req.params.name), schemaFile);
+  if (result == null) {
+    return res.status(400).send('Invalid SVG file.');
+  }
+
+  res.send(JSON.parse(result));
+});
+
 app.listen(portNum);
 console.log('Running app at localhost: ' + portNum);
@@ -14,6 +14,14 @@
 #include <stdbool.h>
 #include <assert.h>
 
+/*
+ * Two implementations of this API exist, selected at build time:
+ *  - LinkedListAPI.c (default): every element is kept in its own doubly linked Node
+ *  - VectorListAPI.c (compiled with -DLIST_VECTOR, e.g. make LIST=vector): the elements are
+ *    kept in one growable array, so iteration is cache friendly and getElementAt() is O(1)
+ * Callers must only use the functions below (and the length field), so they work with both
+ */
+
 /**
  * Node of a linked list. This list is doubly linked, meaning that it has points to both the node immediately in front 
  * of it, as well as the node immediately behind it.
@@ -24,12 +32,53 @@ typedef struct listNode{
     struct listNode* next;
 } Node;
 
+/**
+ * Optional allocator for a list.
+ * A list created with an allocator takes its List struct and all of its Nodes from it, and never
+ * frees them (or the data stored in them) - everything is released at once by the allocator's owner.
+ **/
+typedef struct listAllocator{
+    void* (*alloc)(void* context, size_t size);
+    void* context;
+} ListAllocator;
+
+/**
+ * Counters of the node pool used by the linked list (see getListPoolStats).
+ * Nodes are carved out of slabs and recycled through a per-thread free list, instead of
+ * being malloc'd and freed one at a time.
+ **/
+typedef struct listPoolStats{
+    //Nodes taken from the free list
+    unsigned long hits;
+    //Nodes that had to be carved from a slab because the free list was empty
+    unsigned long misses;
+    //Slabs malloc'd so far
+    unsigned long slabs;
+} ListPoolStats;
+
 /**
  * Metadata head of the list. 
  * Contains no actual data but contains
  * information about the list (head and tail) as well as the function pointers
  * for working with the abstracted list data.
+ *
+ * index is an optional lookup structure owned by whoever created the list (e.g. the attribute
+ * name index in SVGHelpers.c), freed with freeIndex.  Since it may point at the elements, every
+ * change other than insertBack() frees it; the owner rebuilds it when it is needed again.
  **/
+#ifdef LIST_VECTOR
+typedef struct listHead{
+    void** elements;
+    int capacity;
+    int length;
+    void (*deleteData)(void* toBeDeleted);
+    int (*compare)(const void* first,const void* second);
+    char* (*printData)(void* toBePrinted);
+    ListAllocator* allocator;
+    void* index;
+    void (*freeIndex)(void* index);
+} List;
+#else
 typedef struct listHead{
     Node* head;
     Node* tail;
@@ -37,7 +86,11 @@ typedef struct listHead{
     void (*deleteData)(void* toBeDeleted);
     int (*compare)(const void* first,const void* second);
     char* (*printData)(void* toBePrinted);
+    ListAllocator* allocator;
+    void* index;
+    void (*freeIndex)(void* index);
 } List;
+#endif
 
 
 /**
@@ -45,9 +98,16 @@ typedef struct listHead{
  * It represents an abstract object for iterating through the list.
  * The list implemntation is hidden from the user
  **/
+#ifdef LIST_VECTOR
+typedef struct iter{
+    List* list;
+    int index;
+} ListIterator;
+#else
 typedef struct iter{
     Node* current;
 } ListIterator;
+#endif
 
 
 /** Function to initialize the list metadata head with the appropriate function pointers.
@@ -64,6 +124,20 @@ List* initializeList(char* (*printFunction)(void* toBePrinted),void (*deleteFunc
 
 
 
+/** Same as initializeList(), but the List struct and all of its Nodes are taken from allocator.
+* freeList(), clearList() and deleteDataFromList() never free memory of such a list, nor the data in it.
+*@pre function pointer arguments must not be NULL
+*@post List structure has been allocated and initialized
+*@return On success returns newly allocated List struct. Returns NULL if any of the arguments are invalid or allocation fails
+*@param printFunction - function pointer to print a single node of the list
+*@param deleteFunction - function pointer to delete a single piece of data from the list
+*@param compareFunction - function pointer to compare two nodes of the list in order to test for equality or order
+*@param allocator - allocator the list memory is taken from.  If NULL, the list behaves like one from initializeList()
+**/
+List* initializeListWithAllocator(char* (*printFunction)(void* toBePrinted),void (*deleteFunction)(void* toBeDeleted),int (*compareFunction)(const void* first,const void* second), ListAllocator* allocator);
+
+
+
 /**Function for creating a node for the linked list. 
 * This node contains abstracted (void *) data as well as previous and next
 * pointers to connect to other nodes in the list
@@ -200,6 +274,32 @@ void* nextElement(ListIterator* iter);
 int getLength(List* list);
 
 
+/**Returns the element at a position in the list. Does not alter list structure.
+ *O(1) for the array-backed list, O(index) for the linked list.
+ *@pre List must exist, but does not have to have elements.
+ *@param list - a pointer to the List struct.
+ *@param index - position of the element, starting at 0
+ *@return on success: pointer to the data at index.  on failure: NULL (e.g. index out of range)
+ **/
+void* getElementAt(List* list, int index);
+
+
+/**Returns the node pool counters of the calling thread.
+ *The array-backed list does not use nodes, so all counters are 0 for it.
+ *@return the counters
+ **/
+ListPoolStats getListPoolStats(void);
+
+
+/**Frees the slabs of the node pool.  Slabs of threads that have exited are kept for
+ *other threads until then.  Nothing is freed unless the calling thread is the only one
+ *still using the pool and every node taken from the pool has been returned.
+ *The array-backed list has no pool, so it always succeeds.
+ *@return true if the slabs were freed
+ **/
+bool releaseListPool(void);
+
+
 /** Function that searches for an element in the list using a comparator function.
  * If an element is found, a pointer to the data of that element is returned
  * Returns NULL if the element is not found.
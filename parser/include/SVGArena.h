@@ -0,0 +1,97 @@
+#ifndef SVGARENA_H
+#define SVGARENA_H
+
+#include <stddef.h>
+
+#include "SVGParser.h"
+#include "SVGSchema.h"
+#include "LinkedListAPI.h"
+
+//Default size of one arena chunk.  Larger allocations get a chunk of their own
+#define ARENA_CHUNK_SIZE 65536
+
+//One contiguous region of an arena.  Memory is handed out from data[] front to back
+typedef struct arenaChunk {
+    struct arenaChunk* next;
+    size_t size;
+    size_t used;
+    //Keeps data[] aligned for any type
+    max_align_t align[];
+} ArenaChunk;
+
+//Heap object that was handed to an arena (e.g. through addComponent), deleted when the arena is freed
+typedef struct arenaCleanup {
+    void* data;
+    void (*deleteData)(void* toBeDeleted);
+    struct arenaCleanup* next;
+} ArenaCleanup;
+
+//Bump allocator that owns every object of one SVG document
+struct svgArena {
+    //Chunk currently being allocated from, followed by all older chunks
+    ArenaChunk* chunks;
+    //Size of regular chunks
+    size_t chunkSize;
+    //Number of chunks allocated so far
+    int numChunks;
+    //Heap objects adopted by the arena
+    ArenaCleanup* cleanups;
+    //Allocator given to every List of the document
+    ListAllocator listAllocator;
+};
+
+/**
+ * @brief Creates an empty arena
+ * @param chunkSize - size of each chunk, or 0 for ARENA_CHUNK_SIZE
+ * @return SVGArena* or NULL
+ */
+SVGArena* createArena(size_t chunkSize);
+
+/**
+ * @brief Allocates size bytes from the arena.  The memory cannot be freed individually
+ * @param arena
+ * @param size
+ * @return void* or NULL
+ */
+void* arenaAlloc(SVGArena* arena, size_t size);
+
+/**
+ * @brief Copies a string into the arena
+ * @param arena
+ * @param str
+ * @return char*
+ */
+char* arenaStrdup(SVGArena* arena, const char* str);
+
+/**
+ * @brief Hands a heap object to the arena, so it is deleted together with the arena
+ * @param arena
+ * @param data
+ * @param deleteData
+ */
+void arenaAdopt(SVGArena* arena, void* data, void (*deleteData)(void* toBeDeleted));
+
+/**
+ * @brief Deletes every adopted object, then frees every chunk of the arena
+ * @param arena
+ */
+void freeArena(SVGArena* arena);
+
+/**
+ * @brief Same as createSVG(), but every object of the document (the SVG struct, groups,
+ * shapes, attributes and list nodes) is allocated from one arena owned by the SVG.
+ * deleteSVG() then only has to free the arena's chunks
+ * @param fileName
+ * @return SVG* or NULL
+ */
+SVG* createArenaSVG(const char* fileName);
+
+/**
+ * @brief Same as createValidSVGWithSchema(), but the SVG is allocated from an arena
+ * @param fileName
+ * @param schema
+ * @return SVG* or NULL
+ */
+SVG* createValidArenaSVG(const char* fileName, const SVGSchema* schema);
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef SVGBOUNDS_H
+#define SVGBOUNDS_H
+
+#include <stdbool.h>
+
+#include "SVGParser.h"
+
+//Axis-aligned bounding box, in the coordinates the shapes are written in.
+//Transforms, stroke widths and units are not applied
+typedef struct {
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+    //true if there is nothing to bound (e.g. an empty group).  The coordinates are then 0
+    bool empty;
+} SVGBounds;
+
+//Bounds of every group of an SVG struct and of the struct itself, cached in its views
+typedef struct {
+    //groups[i] belongs to the i-th group of the group view
+    SVGBounds* groups;
+    int capacity;
+    //Open-addressing table from Group* to its position in the group view plus one (0 = empty slot)
+    int* slots;
+    int numSlots;
+    //Union of every shape in the struct
+    SVGBounds image;
+} SVGBoundsCache;
+
+/**
+ * @brief Returns bounds with nothing in them
+ * @return SVGBounds
+ */
+SVGBounds emptyBounds(void);
+
+/**
+ * @brief Returns the smallest bounds that contain both a and b
+ * @param a
+ * @param b
+ * @return SVGBounds
+ */
+SVGBounds unionBounds(SVGBounds a, SVGBounds b);
+
+/**
+ * @brief Returns the bounds of a rectangle
+ * @param rect
+ * @return SVGBounds - empty if rect is NULL
+ */
+SVGBounds getRectBounds(const Rectangle* rect);
+
+/**
+ * @brief Returns the bounds of a circle
+ * @param circle
+ * @return SVGBounds - empty if circle is NULL
+ */
+SVGBounds getCircleBounds(const Circle* circle);
+
+/**
+ * @brief Returns the exact bounds of a path, including the extrema of its curves and arcs.
+ * Compiles the path data on first use (see SVGPath.h)
+ * @param path
+ * @return SVGBounds - empty if path is NULL or has no commands
+ */
+SVGBounds getPathBounds(Path* path);
+
+/**
+ * @brief Returns the bounds of everything in a group, including nested groups.
+ * The bounds of every group are computed together on the first call after the struct
+ * changes, and cached until the next addComponent() or setAttribute()
+ * @param img - the struct the group belongs to
+ * @param group
+ * @return SVGBounds - empty if the group has no shapes or is not in img
+ */
+SVGBounds getGroupBounds(const SVG* img, const Group* group);
+
+/**
+ * @brief Returns the bounds of every shape in the struct, cached like getGroupBounds()
+ * @param img
+ * @return SVGBounds - empty if img is NULL or has no shapes
+ */
+SVGBounds getSVGBounds(const SVG* img);
+
+/**
+ * @brief Returns bounds as a JSON string: {"x":,"y":,"w":,"h":}, or {} if they are empty
+ * @param bounds
+ * @return char*
+ */
+char* boundsToJSON(SVGBounds bounds);
+
+/**
+ * @brief Returns the bounds of a valid SVG file as JSON (see boundsToJSON()), so callers
+ * can measure an image without loading it themselves
+ * @param fileName
+ * @param schemaFile
+ * @return char* or NULL if the file is not a valid SVG
+ */
+char* validImageBoundsToJSON(const char* fileName, const char* schemaFile);
+
+#endif
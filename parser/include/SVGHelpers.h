@@ -11,6 +11,43 @@
 /*Defining the PI constant*/
 #define PI 3.14159265358979323846
 
+/**
+ * @brief Reads a number (optional sign, digits with an optional '.', optional exponent)
+ * from the start of str.  Only '.' is accepted as the decimal point, whatever the locale
+ * @param str 
+ * @param value - set to the number if one was found
+ * @return const char* just past the number, or NULL if str does not start with one
+ */
+const char *parseNumber(const char *str, double *value);
+
+/**
+ * @brief Reads a length attribute (a number with optional units, e.g. "2.5cm" or "1e-3px")
+ * in one pass, without copying it.  Only '.' is accepted as the decimal point, whatever
+ * the locale.  Like atof(), anything after the number is ignored, and a string that
+ * does not start with a number reads as 0
+ * @param str 
+ * @param value - set to the number, may be NULL
+ * @param units - set to the interned letters right after the number, or to NULL if the
+ * intern table is full (shapes use setShapeUnits() instead).  May be NULL
+ * @return true if str started with a number
+ * @return false otherwise
+ */
+bool parseLength(const char *str, float *value, const char **units);
+
+/**
+ * @brief Points the units of a shape at the first length characters of units.  Known
+ * units are shared through the intern table.  Others get a copy of their own: from the
+ * arena if there is one, otherwise a malloc'd copy that deleteRectangle()/deleteCircle()
+ * free.  A malloc'd copy the units pointed at before is freed
+ * @param arena - arena of the shape, may be NULL
+ * @param slot - the units field of a Rectangle or Circle
+ * @param units 
+ * @param length 
+ * @return true 
+ * @return false if memory ran out - the units are unchanged then
+ */
+bool setShapeUnits(SVGArena *arena, const char **slot, const char *units, size_t length);
+
 /**
  * @brief Finds any objects that are within a Group object
  * @param list 
@@ -18,6 +55,73 @@
  */
 void parseGroupWithinGroup(List* list, Group* group);
 
+/*
+ * The create/add helpers below take an optional arena (see SVGArena.h).  When it is
+ * NULL, every object is allocated with malloc, like the rest of the parser
+ */
+
+/**
+ * @brief Allocates an empty Rectangle
+ * @param arena 
+ * @return Rectangle* 
+ */
+Rectangle *createRectangle(SVGArena *arena);
+
+/**
+ * @brief Allocates an empty Circle
+ * @param arena 
+ * @return Circle* 
+ */
+Circle *createCircle(SVGArena *arena);
+
+/**
+ * @brief Allocates a Path with enough room for its data
+ * @param arena 
+ * @param data 
+ * @return Path* 
+ */
+Path *createPath(SVGArena *arena, const char *data);
+
+/**
+ * @brief Allocates an empty Group
+ * @param arena 
+ * @return Group* 
+ */
+Group *createGroup(SVGArena *arena);
+
+/**
+ * @brief Applies one XML attribute of a rect element to a Rectangle
+ * @param arena 
+ * @param rect 
+ * @param attrName 
+ * @param cont 
+ * @return true
+ * @return false if memory ran out or the units could not be interned
+ */
+bool addRectAttribute(SVGArena *arena, Rectangle *rect, const char *attrName, const char *cont);
+
+/**
+ * @brief Applies one XML attribute of a circle element to a Circle
+ * @param arena 
+ * @param circle 
+ * @param attrName 
+ * @param cont 
+ * @return true
+ * @return false if memory ran out or the units could not be interned
+ */
+bool addCircleAttribute(SVGArena *arena, Circle *circle, const char *attrName, const char *cont);
+
+/**
+ * @brief Applies one XML attribute of a path element to a Path (except 'd')
+ * @param arena 
+ * @param path 
+ * @param attrName 
+ * @param cont 
+ * @return true
+ * @return false if memory ran out
+ */
+bool addPathAttribute(SVGArena *arena, Path *path, const char *attrName, const char *cont);
+
 /**
  * @brief Parses all data that is required for Path object 
  * @param tmp_Node 
@@ -46,6 +150,63 @@ Rectangle *parseRectData(xmlNode *tmp_Node);
  */
 Group *parseGroupData(xmlNode *tmp_Node);
 
+/**
+ * @brief Allocates an Attribute with enough room for its value
+ * @param arena 
+ * @param name 
+ * @param value 
+ * @return Attribute* 
+ */
+Attribute *createAttribute(SVGArena *arena, const char *name, const char *value);
+
+/**
+ * @brief Allocates an SVG object with default values and empty lists.
+ * If arena is not NULL, the SVG takes ownership of it
+ * @param arena 
+ * @return SVG* 
+ */
+SVG *createSVGObject(SVGArena *arena);
+
+/**
+ * @brief Tells whether img was created by the library (createSVGObject() and everything
+ * built on it).  Only then are its arena, views, stats and generations trusted
+ * @param img 
+ * @return true 
+ * @return false for NULL and for structs built by hand or copied
+ */
+bool isLibrarySVG(const SVG *img);
+
+/**
+ * @brief Builds an SVG object from the root <svg> node of a parsed document
+ * @param root_element 
+ * @return SVG* 
+ */
+SVG *parseSVGRoot(xmlNode *root_element);
+
+/**
+ * @brief Recomputes the totals of an SVG struct with one walk over its group tree.
+ * Does nothing for structs built by hand, which keep no totals
+ * @param img 
+ */
+void computeSVGStats(SVG *img);
+
+/**
+ * @brief Returns the totals of an SVG struct.  They are filled in when the struct is
+ * created and kept up to date by addComponent() and setAttribute(), so this is O(1)
+ * unless the struct was changed directly (see markSVGChanged).  A struct built by hand
+ * is counted again by every call, into a buffer of the calling thread that the next call reuses
+ * @param img 
+ * @return const SVGStats* or NULL if img is NULL
+ */
+const SVGStats *getSVGStats(const SVG *img);
+
+/**
+ * @brief Must be called after changing the lists of an SVG struct directly, instead of
+ * through addComponent()/setAttribute().  Drops the cached views, totals and id index
+ * @param img 
+ */
+void markSVGChanged(SVG *img);
+
 /********************************* A2 Functions *************************************/
 
 /**
@@ -118,12 +279,32 @@ bool validateGroup(List *groupList);
  */
 xmlDoc* svgToXML(const SVG *tmpImage);
 
+/**
+ * @brief Finds the first attribute with the given name in a list of attributes.
+ * Lists with more than a handful of attributes are looked up through a hash index
+ * that is kept on the list, so repeated lookups do not rescan it
+ * @param list 
+ * @param name 
+ * @return Attribute* or NULL
+ */
+Attribute *findAttribute(List *list, const char *name);
+
+/**
+ * @brief Returns the value of the attribute with the given name in a list of attributes
+ * @param list 
+ * @param name 
+ * @return const char* or NULL if there is no such attribute
+ */
+const char *getAttributeValue(List *list, const char *name);
+
 /**
  * @brief Set the Other Attribute object for either Rect, Circ, Path, Group or SVG_Image
  * @param list 
  * @param newAttribute 
+ * @return true if newAttribute was appended to the list
+ * @return false if an existing attribute was updated instead
  */
-void setOtherAttribute(List *list, Attribute *newAttribute);
+bool setOtherAttribute(List *list, Attribute *newAttribute);
 
 /**
  * @brief Helper function to return a JSON string of an SVG Object
@@ -131,4 +312,14 @@ void setOtherAttribute(List *list, Attribute *newAttribute);
  * @param schemaFile 
  * @return char* 
  */
-char* validImageToJSON(const char* fileName, const char* schemaFile);
\ No newline at end of file
+char* validImageToJSON(const char* fileName, const char* schemaFile);
+
+/**
+ * @brief Same as validImageToJSON(), but for SVG contents that are already in memory
+ * (e.g. an upload that has not been written to disk)
+ * @param buffer 
+ * @param length 
+ * @param schemaFile 
+ * @return char* 
+ */
+char* validImageBufferToJSON(const char* buffer, int length, const char* schemaFile);
\ No newline at end of file
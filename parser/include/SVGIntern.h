@@ -0,0 +1,86 @@
+#ifndef SVGINTERN_H
+#define SVGINTERN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+//Most bytes of string data the intern table will hold.  Past this, internString()
+//returns NULL and callers keep their own copy, so hostile documents cannot grow it forever.
+//The SVG attribute names and units below are always interned, however full the table is
+#define INTERN_MAX_BYTES (4 * 1024 * 1024)
+
+//Interned copies of the attribute names the parser handles itself.  A name returned by
+//internString() or findInternedString() can be compared with these by pointer
+extern const char SVG_NAME_X[];
+extern const char SVG_NAME_Y[];
+extern const char SVG_NAME_WIDTH[];
+extern const char SVG_NAME_HEIGHT[];
+extern const char SVG_NAME_CX[];
+extern const char SVG_NAME_CY[];
+extern const char SVG_NAME_R[];
+extern const char SVG_NAME_D[];
+extern const char SVG_NAME_ID[];
+
+//Interned empty string, used as the units of shapes that have none
+extern const char SVG_UNITS_NONE[];
+
+/**
+ * @brief Returns the process-wide copy of str, adding it to the table if needed.
+ * Interned strings are never freed or modified, and equal strings always get the
+ * same pointer.  Safe to call from any thread
+ * @param str
+ * @return const char* or NULL if str is NULL or the table is full
+ */
+const char* internString(const char* str);
+
+/**
+ * @brief Same as internString(), for the first length characters of str (which does
+ * not have to be NUL terminated)
+ * @param str
+ * @param length
+ * @return const char* or NULL if str is NULL or the table is full
+ */
+const char* internSpan(const char* str, size_t length);
+
+/**
+ * @brief Same as internString(), but never adds to the table
+ * @param str
+ * @return const char* or NULL if str has not been interned
+ */
+const char* findInternedString(const char* str);
+
+/**
+ * @brief Returns whether str is itself an interned string (and so must not be freed),
+ * rather than just equal to one
+ * @param str
+ * @return true
+ * @return false
+ */
+bool isInternedString(const char* str);
+
+/**
+ * @brief Returns the first length characters of units interned
+ * @param units
+ * @param length
+ * @return const char* or NULL if the table is full (see setShapeUnits() in SVGHelpers.h)
+ */
+const char* internUnits(const char* units, size_t length);
+
+/**
+ * @brief Returns a heap copy of the first length characters of str, for a string that
+ * could not be interned.  The copy is recorded, so releaseOwnedString() can tell it apart
+ * from interned strings and from strings that belong to the caller.  Safe to call from any thread
+ * @param str
+ * @param length
+ * @return char* or NULL if memory ran out
+ */
+char* copyOwnedSpan(const char* str, size_t length);
+
+/**
+ * @brief Frees a copy made by copyOwnedSpan().  Any other string is left alone
+ * @param str
+ * @return true if str was such a copy
+ */
+bool releaseOwnedString(const char* str);
+
+#endif
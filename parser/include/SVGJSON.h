@@ -0,0 +1,139 @@
+#ifndef SVGJSON_H
+#define SVGJSON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "SVGParser.h"
+#include "StringBuilder.h"
+
+//Digits after the decimal point when no precision is given - the same as the *ToJSON functions
+#define SVG_JSON_DEFAULT_PRECISION 2
+//Largest precision accepted.  Larger values are clamped to it
+#define SVG_JSON_MAX_PRECISION 9
+
+//Receives the text of a JSON export (see TextSink in StringBuilder.h, which also has sinks
+//for files, file descriptors and StringBuilders)
+typedef TextSink SVGJSONSink;
+
+//Deepest nesting of objects and arrays the tokenizer accepts
+#define JSON_MAX_DEPTH 512
+
+//Kinds of tokens returned by nextJSONToken()
+typedef enum {
+    JSON_OBJECT_START,
+    JSON_OBJECT_END,
+    JSON_ARRAY_START,
+    JSON_ARRAY_END,
+    //The name of an object member.  Its value is the next token
+    JSON_KEY,
+    JSON_STRING,
+    JSON_NUMBER,
+    JSON_TRUE,
+    JSON_FALSE,
+    JSON_NULL,
+    //The whole text has been read
+    JSON_END,
+    //The text is not valid JSON.  Every later call returns JSON_ERROR as well
+    JSON_ERROR
+} JSONTokenType;
+
+//One token.  It points into the text being read - nothing is copied or allocated
+typedef struct {
+    JSONTokenType type;
+    //For keys and strings, the characters between the quotes, still escaped
+    const char* start;
+    size_t length;
+    //true if a key or string contains backslash escapes (see decodeJSONString())
+    bool escaped;
+} JSONToken;
+
+//Single-pass pull tokenizer over a JSON text.  It checks the whole grammar (commas, colons,
+//nesting, string escapes and number syntax) but hands out only keys, values and brackets
+typedef struct {
+    const char* pos;
+    const char* end;
+    //What may come next.  Private to the tokenizer
+    int state;
+    int depth;
+    //For every open container, true if it is an object and false if it is an array
+    bool objects[JSON_MAX_DEPTH];
+} JSONTokenizer;
+
+/*The document JSON holds the whole struct, including every nested group:
+{"namespace":"","title":"","descr":"","attributes":[{"name":"","value":""}],
+ "rectangles":[{"x":,"y":,"w":,"h":,"units":"","attributes":[]}],
+ "circles":[{"cx":,"cy":,"r":,"units":"","attributes":[]}],
+ "paths":[{"d":"","attributes":[]}],
+ "groups":[{"attributes":[],"rectangles":[],"circles":[],"paths":[],"groups":[]}]}
+Shapes use the same keys as rectToJSON() etc.  Strings are escaped, and numbers that are not
+finite are written as null*/
+
+/**
+ * @brief Streams the document JSON of an SVG struct to a sink in a single traversal.
+ * The text is handed over in chunks of a few kilobytes, so memory use does not depend on
+ * the size of the document
+ * @param img
+ * @param precision - digits after the decimal point, or a negative number for the default
+ * @param sink
+ * @param context - passed to every call of sink
+ * @return true
+ * @return false if img or sink is NULL, or sink stopped the export
+ */
+bool writeSVGJSON(const SVG* img, int precision, SVGJSONSink sink, void* context);
+
+/**
+ * @brief Streams the document JSON of an SVG struct to an open file
+ * @param img
+ * @param precision
+ * @param file
+ * @return true
+ * @return false if writing failed
+ */
+bool writeSVGJSONToFile(const SVG* img, int precision, FILE* file);
+
+/**
+ * @brief Streams the document JSON of an SVG struct to a file descriptor (a file, pipe or socket)
+ * @param img
+ * @param precision
+ * @param fd
+ * @return true
+ * @return false if writing failed
+ */
+bool writeSVGJSONToFd(const SVG* img, int precision, int fd);
+
+/**
+ * @brief Returns the document JSON of an SVG struct as one string.  Only meant for images
+ * small enough to hold twice in memory - stream bigger ones with writeSVGJSON()
+ * @param img
+ * @param precision
+ * @return char* or NULL if img is NULL or memory ran out
+ */
+char* SVGtoDocumentJSON(const SVG* img, int precision);
+
+/**
+ * @brief Starts tokenizing a JSON text
+ * @param tokenizer
+ * @param text - must stay unchanged while the tokens are in use
+ * @param length
+ */
+void initJSONTokenizer(JSONTokenizer* tokenizer, const char* text, size_t length);
+
+/**
+ * @brief Returns the next token of the text
+ * @param tokenizer
+ * @return JSONToken - JSON_END after the last one, JSON_ERROR if the text is not valid JSON
+ */
+JSONToken nextJSONToken(JSONTokenizer* tokenizer);
+
+/**
+ * @brief Writes the unescaped characters of a key or string token, followed by a NUL.
+ * \u escapes are written as UTF-8.  Never writes more than token->length + 1 bytes
+ * @param token
+ * @param dest
+ * @return size_t - number of characters written, not counting the NUL
+ */
+size_t decodeJSONString(const JSONToken* token, char* dest);
+
+#endif
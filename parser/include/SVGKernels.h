@@ -0,0 +1,57 @@
+#ifndef SVGKERNELS_H
+#define SVGKERNELS_H
+
+/*
+ * Numeric kernels over float columns (see SVGRectColumns/SVGCircleColumns in SVGViews.h).
+ * On x86-64 they use AVX2 when the CPU supports it and SSE2 otherwise; everywhere else a
+ * plain C loop is used.  Every implementation gives exactly the same results as the scalar
+ * code in numRectsWithArea()/numCirclesWithArea():
+ *  - a rectangle's area is the float product height * width
+ *  - a circle's area is r * r (float) times PI (double), rounded back to float
+ */
+
+/**
+ * @brief Name of the kernel implementation used on this machine ("avx2", "sse2" or "scalar")
+ * @return const char*
+ */
+const char* svgKernelName(void);
+
+/**
+ * @brief Computes the area of every rectangle into out
+ * @param width
+ * @param height
+ * @param n
+ * @param out - room for n floats
+ */
+void computeRectAreas(const float* width, const float* height, int n, float* out);
+
+/**
+ * @brief Computes the area of every circle into out
+ * @param r
+ * @param n
+ * @param out - room for n floats
+ */
+void computeCircleAreas(const float* r, int n, float* out);
+
+/**
+ * @brief Counts the rectangles whose area is in the range (lo, hi] - lo is exclusive
+ * @param width
+ * @param height
+ * @param n
+ * @param lo
+ * @param hi
+ * @return int
+ */
+int countRectAreasInRange(const float* width, const float* height, int n, float lo, float hi);
+
+/**
+ * @brief Counts the circles whose area is in the range (lo, hi] - lo is exclusive
+ * @param r
+ * @param n
+ * @param lo
+ * @param hi
+ * @return int
+ */
+int countCircleAreasInRange(const float* r, int n, float lo, float hi);
+
+#endif
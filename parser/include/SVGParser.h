@@ -15,7 +15,8 @@ typedef enum COMP{
 
 //Represents a generic SVG element/XML node Attribute
 typedef struct  {
-    //Attribute name.  Must not be NULL
+    //Attribute name.  Must not be NULL.  Names created by the parser are interned
+    //(see SVGIntern.h) and shared between attributes, so never modify them in place
 	char* 	name;
     //Attribute value.  May be empty
 	char	value[]; 
@@ -49,8 +50,9 @@ typedef struct {
     //Rectangle height.  Must be >= 0
     float height;
 
-    //Units for the rectable coordinates and size.  May be empty.
-    char units[50];
+    //Units for the rectable coordinates and size.  Interned (see SVGIntern.h), or a copy
+    //of its own for units the table cannot hold - never free or modify it.  Must not be NULL.  May be empty.
+    const char* units;
 
     //Additional rectangle attributes - i.e. attributes of the rect XML element.  
 	//All objects in the list will be of type Attribute.  It must not be NULL.  It may be empty.
@@ -67,8 +69,9 @@ typedef struct {
     //Circle radius. Must be >= 0
     float r;
 
-    //Units for the circle coordinates and size.  May be empty.
-    char units[50];
+    //Units for the circle coordinates and size.  Interned (see SVGIntern.h), or a copy
+    //of its own for units the table cannot hold - never free or modify it.  Must not be NULL.  May be empty.
+    const char* units;
 
     //Additional circle attributes - i.e. attributes of the circle XML element.  
     //All objects in the list will be of type Attribute.  It must not be NULL.  It may be empty.
@@ -76,6 +79,9 @@ typedef struct {
 
 } Circle;
 
+//Compiled form of a path's data - see SVGPath.h
+typedef struct svgPathCommands SVGPathCommands;
+
 //Represents a path primitive - i.e. a sequence of points connected with lines or curves
 typedef struct {
     
@@ -83,11 +89,35 @@ typedef struct {
     //All objects in the list will be of type Attribute.  It must not be NULL.  It may be empty.
     List* otherAttributes;
 
+    //data compiled into absolute commands, built on first use by getPathCommands().
+    //May be NULL.  addComponent() sets it to NULL, so paths built by the caller may leave it unset
+    SVGPathCommands* commands;
+
     //Path data.  Must not be NULL
     char data[];
 
 } Path;
 
+//Arena allocator that can own all memory of an SVG struct - see SVGArena.h
+typedef struct svgArena SVGArena;
+typedef struct svgViews SVGViews;
+
+//Totals of an SVG struct, kept up to date by the library so the summary functions do not
+//have to walk the group tree
+typedef struct {
+    //Every rectangle, circle, path and group, including the ones inside (nested) groups
+    int numRect;
+    int numCirc;
+    int numPaths;
+    int numGroups;
+    //Other attributes of the SVG itself and of every component, as counted by numAttr()
+    int numAttributes;
+    //Deepest nesting of groups.  0 if there are no groups, 1 if no group is inside another
+    int maxGroupDepth;
+    //false if the totals must be recomputed before they are used
+    bool valid;
+} SVGStats;
+
 // The main struct, representing an svg element of the format
 // While a full SVG struct might have multiple svg components, we will assume that all of our input
 // structs will only have one
@@ -120,8 +150,40 @@ typedef struct {
     //All objects in the list will be of type Attribute.  It must not be NULL.  It may be empty.  
     //Do not put the namespace here, since it already has its own field
     List* otherAttributes;
+
+    //The fields below are only read in structs the library created (see self), so they
+    //may be left unset in structs built by hand
+
+    //Arena that owns every object of this struct (see createArenaSVG), or NULL if they were
+    //allocated individually
+    SVGArena* arena;
+
+    //Cached flattened component views (see SVGViews.h), or NULL until first used
+    SVGViews* views;
+    //Incremented by every change made through addComponent() and setAttribute(), so cached
+    //data built from an older generation is known to be stale
+    unsigned long generation;
+    //Totals of the struct (see getSVGStats in SVGHelpers.h)
+    SVGStats stats;
+    //Incremented when elements are added or an id attribute is set, so the id index
+    //(see getElementById) is only rebuilt when ids may have changed
+    unsigned long idGeneration;
+
+    //Address of the struct itself if the library created it (see isLibrarySVG in
+    //SVGHelpers.h).  A struct built by hand or copied from another one does not match,
+    //so the library takes its uncached paths and never follows the fields above
+    const void* self;
 } SVG;
 
+//Handle of one element of an SVG struct.  Elements never move in memory, so a handle
+//stays valid until the SVG is deleted
+typedef struct {
+    //SVG_IMG for the svg element itself, otherwise the type of the component
+    elementType type;
+    //The SVG, Rectangle, Circle, Path or Group.  NULL if the handle refers to nothing
+    void* element;
+} SVGElementHandle;
+
 //A1
 
 /* Public API - main */
@@ -238,6 +300,34 @@ bool validateSVG(const SVG* img, const char* schemaFile);
 **/
 SVG* createValidSVG(const char* fileName, const char* schemaFile);
 
+/** Function to create an SVG struct from SVG contents that are already in memory,
+ * e.g. an uploaded file, without writing them to disk first.
+ *@pre buffer is not NULL and holds length bytes of SVG/XML text.  It does not need to be NUL terminated
+ *@post Either:
+        A valid SVG struct has been created and its address was returned
+		or 
+		An error occurred, and NULL was returned
+ *@return the pinter to the new struct or NULL
+ *@param buffer - the SVG contents
+ *@param length - the number of bytes in buffer
+**/
+SVG* createSVGFromBuffer(const char* buffer, int length);
+
+/** Function to create an SVG struct from SVG contents that are already in memory.
+ * Same as createValidSVG(), the document must be valid according to the schema file.
+ *@pre buffer is not NULL and holds length bytes of SVG/XML text.
+       Schema file name is not NULL/empty, and represents a valid schema file
+ *@post Either:
+        A valid SVG struct has been created and its address was returned
+		or 
+		An error occurred, or the SVG contents were invalid, and NULL was returned
+ *@return the pinter to the new struct or NULL
+ *@param buffer - the SVG contents
+ *@param length - the number of bytes in buffer
+ *@param schemaFile - the name of a schema file
+**/
+SVG* createValidSVGFromBuffer(const char* buffer, int length, const char* schemaFile);
+
 /** Function to writing an SVG struct into a file in SVG format.
  *@pre
     SVG struct exists, is valid, and and is not NULL.
@@ -265,6 +355,27 @@ bool writeSVG(const SVG* img, const char* fileName);
  **/
 bool setAttribute(SVG* img, elementType elemType, int elemIndex, Attribute* newAttribute);
 
+/** Function to finding any element of an SVG - including the ones inside (nested) groups - by
+ *  its 'id' attribute.  Ids are indexed on first use, so lookups are O(1) until an element
+ *  is added or an id is changed.  If several elements share an id, the svg element wins,
+ *  then rectangles, circles, paths and groups, each in getRects() etc. order
+ *@return a handle to the element, with element set to NULL if there is no such id
+ *@param
+    img - a pointer to an SVG struct
+    id - the id to look for
+ **/
+SVGElementHandle getElementById(const SVG* img, const char* id);
+
+/** Same as setAttribute(), but for an element handle, so it works on elements inside groups
+ *@return a boolean value indicating success or failure of the function
+ **/
+bool setElementAttribute(SVG* img, SVGElementHandle handle, Attribute* newAttribute);
+
+/** Same as setAttribute(), but for the element with the given id (see getElementById)
+ *@return false if there is no element with that id, otherwise the same as setAttribute()
+ **/
+bool setAttributeById(SVG* img, const char* id, Attribute* newAttribute);
+
 /** Function to adding an element - Circle, Rectangle, or Path - to an SVG
  *@pre
     SVG object exists, is valid, and and is not NULL.
@@ -371,7 +482,7 @@ char* SVGtoJSON(const SVG* img);
 /** Function to converting a JSON string into an SVG struct
 *@pre JSON string is not NULL
 *@post String has not been modified in any way
-*@return A newly allocated and initialized SVG struct
+*@return A newly allocated and initialized SVG struct, or NULL if str is not valid JSON
 *@param str - a pointer to a string
 **/
 SVG* JSONtoSVG(const char* svgString);
@@ -379,7 +490,7 @@ SVG* JSONtoSVG(const char* svgString);
 /** Function to converting a JSON string into a Rectangle struct
 *@pre JSON string is not NULL
 *@post Rectangle has not been modified in any way
-*@return A newly allocated and initialized Rectangle struct
+*@return A newly allocated and initialized Rectangle struct, or NULL if str is not valid JSON
 *@param str - a pointer to a string
 **/
 Rectangle* JSONtoRect(const char* svgString);
@@ -387,7 +498,7 @@ Rectangle* JSONtoRect(const char* svgString);
 /** Function to converting a JSON string into a Circle struct
 *@pre JSON string is not NULL
 *@post Circle has not been modified in any way
-*@return A newly allocated and initialized Circle struct
+*@return A newly allocated and initialized Circle struct, or NULL if str is not valid JSON
 *@param str - a pointer to a string
 **/
 Circle* JSONtoCircle(const char* svgString);
@@ -0,0 +1,104 @@
+#ifndef SVGPATH_H
+#define SVGPATH_H
+
+#include <stdbool.h>
+
+#include "SVGParser.h"
+
+//Opcodes of a compiled path.  All coordinates are absolute - relative commands are
+//resolved, H/V become lines and S/T get their reflected control point spelled out
+typedef enum {
+    //x y - starts a new subpath
+    PATH_MOVE,
+    //x y
+    PATH_LINE,
+    //x1 y1 x2 y2 x y
+    PATH_CUBIC,
+    //x1 y1 x y
+    PATH_QUAD,
+    //rx ry rotation cx cy startAngle sweepAngle x y - an elliptical arc in centre form,
+    //with its radii already scaled up if they were too small.  Angles are in radians
+    PATH_ARC,
+    //x y - closes the subpath, returning to its starting point (x, y)
+    PATH_CLOSE
+} SVGPathOp;
+
+//Number of coordinates of each SVGPathOp, indexed by opcode
+extern const int SVG_PATH_OP_COORDS[];
+
+//A path's data parsed once into an opcode array and a packed coordinate buffer.
+//Both live in the same block of memory as the struct
+struct svgPathCommands {
+    //Number of opcodes in ops
+    int numOps;
+    //Number of floats in coords
+    int numCoords;
+    //false if the data had an error.  The commands before the error are kept,
+    //since that is what an SVG renderer would draw
+    bool complete;
+    //Coordinates of every command, in order
+    float* coords;
+    //One SVGPathOp per command
+    unsigned char* ops;
+};
+
+//One command of a compiled path, as returned by nextPathCommand()
+typedef struct {
+    SVGPathOp op;
+    //SVG_PATH_OP_COORDS[op] coordinates.  Points into the compiled path
+    const float* coords;
+} SVGPathCommand;
+
+//Iterates over the commands of a compiled path
+typedef struct {
+    const SVGPathCommands* commands;
+    int op;
+    int coord;
+    SVGPathCommand current;
+} SVGPathIterator;
+
+/**
+ * @brief Returns the compiled commands of a path, compiling its data on first use.
+ * The result is cached on the path until its 'd' attribute changes.
+ * Not safe to call for the same path from several threads at once
+ * @param path
+ * @return const SVGPathCommands* or NULL if path is NULL or memory ran out
+ */
+const SVGPathCommands* getPathCommands(Path* path);
+
+/**
+ * @brief Drops the compiled commands of a path.  Must be called whenever its data changes
+ * @param path
+ */
+void invalidatePathCommands(Path* path);
+
+/**
+ * @brief Compiles path data into a new SVGPathCommands, which must be freed with
+ * freePathCommands()
+ * @param data
+ * @return SVGPathCommands* or NULL if data is NULL or memory ran out
+ */
+SVGPathCommands* compilePathData(const char* data);
+
+/**
+ * @brief Frees commands returned by compilePathData()
+ * @param commands
+ */
+void freePathCommands(SVGPathCommands* commands);
+
+/**
+ * @brief Creates an iterator over compiled commands
+ * @param commands - may be NULL, in which case there are no commands
+ * @return SVGPathIterator
+ */
+SVGPathIterator createPathIterator(const SVGPathCommands* commands);
+
+/**
+ * @brief Returns the next command, or NULL after the last one.  The command is only
+ * valid until the next call
+ * @param iter
+ * @return const SVGPathCommand*
+ */
+const SVGPathCommand* nextPathCommand(SVGPathIterator* iter);
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef SVGSCHEMA_H
+#define SVGSCHEMA_H
+
+#include <stdbool.h>
+#include <libxml/xmlschemas.h>
+#include <libxml/hash.h>
+
+#include "SVGParser.h"
+
+//Represents a compiled SVG schema (svg.xsd plus the xlink/namespace schemas it imports)
+//that can be shared by any number of createValidSVG/validateSVG calls
+typedef struct {
+    //Name of the schema file the handle was compiled from.  Must not be NULL
+    char* fileName;
+    //Compiled schema.  Never modified after loading, so it is safe to share.  Must not be NULL
+    xmlSchemaPtr schema;
+} SVGSchema;
+
+/**
+ * @brief Compiles a schema file once so it can be reused for many documents.
+ * The handle must be released with releaseSVGSchema()
+ * @param schemaFile
+ * @return SVGSchema* or NULL if the schema could not be compiled
+ */
+SVGSchema* loadSVGSchema(const char* schemaFile);
+
+/**
+ * @brief Frees a schema handle created by loadSVGSchema()
+ * @param schema
+ */
+void releaseSVGSchema(SVGSchema* schema);
+
+/**
+ * @brief Returns the process-wide compiled schema for schemaFile, compiling it on
+ * first use.  The handle is owned by the cache - do not release it
+ * @param schemaFile
+ * @return const SVGSchema* or NULL if the schema could not be compiled
+ */
+const SVGSchema* getCachedSVGSchema(const char* schemaFile);
+
+/**
+ * @brief Releases every schema held by the process-wide cache
+ */
+void releaseCachedSVGSchemas(void);
+
+/**
+ * @brief Frees libxml2's global parser state.  This is skipped while any schema
+ * handle is alive, since the compiled schemas point into libxml2's built-in types.
+ * Also frees the list node pool if no list node is in use (see releaseListPool)
+ */
+void cleanupSVGParser(void);
+
+/**
+ * @brief Validates a parsed XML document against a compiled schema
+ * @param doc
+ * @param schema
+ * @return true
+ * @return false
+ */
+bool validateDocWithSchema(xmlDoc* doc, const SVGSchema* schema);
+
+/**
+ * @brief Validates the XML an SVG struct is written as (see writeSVG) against a compiled
+ * schema.  The struct is fed to the schema validator as SAX events in a single traversal,
+ * so no xmlDoc is built and no XML text is printed
+ * @param img
+ * @param schema
+ * @return true
+ * @return false
+ */
+bool validateStructWithSchema(const SVG* img, const SVGSchema* schema);
+
+/**
+ * @brief Adds the value of an id attribute to a set of ids.  Values are compared after
+ * collapsing their whitespace, like the schema validator compares xs:ID values.
+ * The validator only checks that ids are unique when it validates a document, so
+ * validation without one (SAX events or an xmlTextReader) calls this for every id
+ * @param ids - created with xmlHashCreate()
+ * @param value
+ * @return true
+ * @return false if ids already has the id, or memory ran out
+ */
+bool addUniqueId(xmlHashTablePtr ids, const char* value);
+
+/**
+ * @brief Same as createValidSVG(), but validates against an already compiled schema
+ * @param fileName
+ * @param schema
+ * @return SVG* or NULL
+ */
+SVG* createValidSVGWithSchema(const char* fileName, const SVGSchema* schema);
+
+/**
+ * @brief Same as createValidSVGFromBuffer(), but validates against an already compiled schema
+ * @param buffer
+ * @param length
+ * @param schema
+ * @return SVG* or NULL
+ */
+SVG* createValidSVGFromBufferWithSchema(const char* buffer, int length, const SVGSchema* schema);
+
+/**
+ * @brief Same as validateSVG(), but validates against an already compiled schema
+ * @param img
+ * @param schema
+ * @return true
+ * @return false
+ */
+bool validateSVGWithSchema(const SVG* img, const SVGSchema* schema);
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef SVGSNAPSHOT_H
+#define SVGSNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SVGParser.h"
+
+//First bytes of every snapshot
+#define SVG_SNAPSHOT_MAGIC "SVGSNAP"
+//Version of the format written by this library.  Snapshots of other versions are rejected
+#define SVG_SNAPSHOT_VERSION 1
+//Written in the native byte order, so a snapshot made on a machine of the other byte order
+//reads back as a different number and is rejected
+#define SVG_SNAPSHOT_BYTE_ORDER 0x01020304u
+
+/*A snapshot is a binary copy of an SVG struct that can be loaded back without parsing any
+text.  It holds a header followed by 8-byte aligned sections of fixed-size records:
+
+  strings     SVGSnapshotString[numStrings]  - where each string is in the string data
+  string data NUL-terminated characters of every distinct string (names, values, units, ...)
+  attributes  SVGSnapshotAttribute[numAttributes]
+  rectangles  SVGSnapshotRect[numRects]
+  circles     SVGSnapshotCircle[numCircles]
+  paths       SVGSnapshotPath[numPaths]
+  groups      SVGSnapshotGroup[numGroups]
+
+Records refer to strings by index and to their attributes and children by ranges of indices,
+and sections are found through offsets from the start of the file, so a snapshot can be
+mapped anywhere in memory.  Records are laid out in a fixed order: the svg element, then
+every group in breadth-first order, each followed by its shapes (with their attributes) and
+its child groups.  The loader checks that every range starts where the previous one ended,
+so every record is used exactly once and a damaged snapshot cannot form a cycle*/
+
+//Position of one string in the string data
+typedef struct {
+    uint32_t offset;
+    //Number of characters, not counting the NUL
+    uint32_t length;
+} SVGSnapshotString;
+
+typedef struct {
+    uint32_t name;
+    uint32_t value;
+} SVGSnapshotAttribute;
+
+typedef struct {
+    float x;
+    float y;
+    float width;
+    float height;
+    uint32_t units;
+    uint32_t firstAttribute;
+    uint32_t numAttributes;
+} SVGSnapshotRect;
+
+typedef struct {
+    float cx;
+    float cy;
+    float r;
+    uint32_t units;
+    uint32_t firstAttribute;
+    uint32_t numAttributes;
+} SVGSnapshotCircle;
+
+typedef struct {
+    uint32_t data;
+    uint32_t firstAttribute;
+    uint32_t numAttributes;
+} SVGSnapshotPath;
+
+//A group, or the components of the svg element itself
+typedef struct {
+    uint32_t firstAttribute;
+    uint32_t numAttributes;
+    uint32_t firstRect;
+    uint32_t numRects;
+    uint32_t firstCircle;
+    uint32_t numCircles;
+    uint32_t firstPath;
+    uint32_t numPaths;
+    uint32_t firstGroup;
+    uint32_t numGroups;
+} SVGSnapshotGroup;
+
+typedef struct {
+    //SVG_SNAPSHOT_MAGIC, NUL-padded
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    //Size of the whole snapshot in bytes
+    uint64_t fileSize;
+
+    //Offsets of the sections from the start of the snapshot
+    uint64_t stringsOffset;
+    uint64_t stringDataOffset;
+    uint64_t stringDataSize;
+    uint64_t attributesOffset;
+    uint64_t rectsOffset;
+    uint64_t circlesOffset;
+    uint64_t pathsOffset;
+    uint64_t groupsOffset;
+
+    uint32_t numStrings;
+    uint32_t numAttributes;
+    uint32_t numRects;
+    uint32_t numCircles;
+    uint32_t numPaths;
+    uint32_t numGroups;
+
+    //Strings of the svg element
+    uint32_t namespace;
+    uint32_t title;
+    uint32_t description;
+    SVGSnapshotGroup root;
+    uint32_t reserved;
+} SVGSnapshotHeader;
+
+/**
+ * @brief Encodes an SVG struct as a snapshot in memory
+ * @param img
+ * @param length - set to the size of the snapshot
+ * @return void* - must be freed by the caller, or NULL if img is NULL, memory ran out or
+ * the struct is too big for the format (over 4G strings or records of one kind)
+ */
+void* SVGtoSnapshot(const SVG* img, size_t* length);
+
+/**
+ * @brief Writes a snapshot of an SVG struct to a file, replacing it if it exists
+ * @param img
+ * @param fileName
+ * @return true
+ * @return false if the snapshot could not be made or written
+ */
+bool writeSVGSnapshot(const SVG* img, const char* fileName);
+
+/**
+ * @brief Builds an SVG struct from a snapshot in memory.  The struct is allocated from an
+ * arena (see SVGArena.h) and does not refer to data afterwards
+ * @param data - does not have to be aligned
+ * @param length
+ * @return SVG* or NULL if data is not a complete, consistent snapshot of this version
+ */
+SVG* SVGFromSnapshot(const void* data, size_t length);
+
+/**
+ * @brief Maps a snapshot file into memory and builds an SVG struct from it, without reading
+ * the file into a buffer first
+ * @param fileName
+ * @return SVG* or NULL if the file cannot be read or is not a valid snapshot
+ */
+SVG* loadSVGSnapshot(const char* fileName);
+
+#endif
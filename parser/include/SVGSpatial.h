@@ -0,0 +1,100 @@
+#ifndef SVGSPATIAL_H
+#define SVGSPATIAL_H
+
+#include <stdbool.h>
+
+#include "SVGParser.h"
+#include "SVGBounds.h"
+#include "LinkedListAPI.h"
+
+//Maximum number of children of a node of the spatial index
+#define SPATIAL_NODE_SIZE 8
+
+//One node of the spatial index (an R-tree).  bounds[i] bounds children[i], which is the
+//position of a child node, or of an entry if the node is a leaf
+typedef struct {
+    SVGBounds bounds[SPATIAL_NODE_SIZE];
+    int children[SPATIAL_NODE_SIZE];
+    int count;
+    //Position of the parent node, or -1 for the root
+    int parent;
+    bool leaf;
+} SVGSpatialNode;
+
+//One rectangle, circle or path in the spatial index
+typedef struct {
+    SVGElementHandle handle;
+    SVGBounds bounds;
+    //Leaf node holding the entry, or -1 if it has nothing to bound (e.g. a path without data)
+    int leaf;
+    //Position of the element in the rect, circle or path view, so results can be sorted
+    int position;
+} SVGSpatialEntry;
+
+//R-tree over the bounds of every shape of an SVG struct, cached in its views
+typedef struct {
+    SVGSpatialNode* nodes;
+    int numNodes;
+    int nodesCapacity;
+    //Position of the root node
+    int root;
+    SVGSpatialEntry* entries;
+    int numEntries;
+    int entriesCapacity;
+    //Open-addressing table from an element to its entry plus one (0 = empty slot)
+    int* slots;
+    int numSlots;
+} SVGSpatialIndex;
+
+/**
+ * @brief Turns the spatial index of the struct on or off.  Turning it on bulk-loads the index
+ * over every rectangle, circle and path (including the ones inside groups).
+ * While it is on, addComponent() and setAttribute() update the index in place, and any other
+ * change (see markSVGChanged()) makes the next query load it again.  Does nothing for
+ * structs built by hand (see isLibrarySVG() in SVGHelpers.h)
+ * @param img
+ * @param enabled
+ */
+void enableSpatialIndex(const SVG* img, bool enabled);
+
+/**
+ * @brief Returns every rectangle, circle and path whose bounds (see SVGBounds.h) intersect
+ * area, touching edges included.  Uses the spatial index if it is enabled, otherwise
+ * scans every shape.
+ * The result is in document order: the rectangles in getRects() order, then the circles
+ * in getCircles() order, then the paths in getPaths() order.
+ * Each element of the List is a new SVGElementHandle*, freed by freeList(), but the
+ * elements the handles point to belong to the struct
+ * @param img
+ * @param area
+ * @return List* or NULL if img is NULL
+ */
+List* getElementsInBounds(const SVG* img, SVGBounds area);
+
+/**
+ * @brief Returns every rectangle, circle and path under the point (x, y), in the same order
+ * and form as getElementsInBounds().  Rectangles and circles are tested exactly, paths by
+ * their bounds only
+ * @param img
+ * @param x
+ * @param y
+ * @return List* or NULL if img is NULL
+ */
+List* getElementsAtPoint(const SVG* img, float x, float y);
+
+/**
+ * @brief Updates the spatial index after the given element was added to the struct or
+ * had an attribute set.  Called by addComponent() and setAttribute() right after they
+ * change the struct - if anything else changed it first, the index is loaded again instead
+ * @param img
+ * @param handle
+ */
+void updateSpatialIndex(SVG* img, SVGElementHandle handle);
+
+/**
+ * @brief Frees the memory of a spatial index.  Called by freeSVGViews()
+ * @param index
+ */
+void freeSpatialIndex(SVGSpatialIndex* index);
+
+#endif
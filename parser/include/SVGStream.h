@@ -0,0 +1,83 @@
+#ifndef SVGSTREAM_H
+#define SVGSTREAM_H
+
+#include <libxml/xmlreader.h>
+
+#include "SVGParser.h"
+#include "SVGSchema.h"
+
+//Element counts of an SVG image, as reported by SVGtoJSON()
+typedef struct {
+    //Every rectangle in the image, including the ones inside groups
+    int numRect;
+    //Every circle in the image, including the ones inside groups
+    int numCirc;
+    //Every path in the image, including the ones inside groups
+    int numPaths;
+    //Every group in the image, including nested groups
+    int numGroups;
+} SVGCounts;
+
+/**
+ * @brief Same as createSVG(), but builds the SVG struct while the file is being read
+ * with an xmlTextReader, so libxml2 never holds the whole document tree in memory
+ * @param fileName
+ * @return SVG* or NULL
+ */
+SVG* createSVGStreaming(const char* fileName);
+
+/**
+ * @brief Same as createValidSVGWithSchema(), but validates and builds the SVG struct
+ * in a single streaming pass over the file.
+ * Note: libxml2's streaming validator cannot check that xs:ID values are unique
+ * across the document, since it does not keep the elements it has already read
+ * @param fileName
+ * @param schema
+ * @return SVG* or NULL if the file could not be read or is not valid
+ */
+SVG* createValidSVGStreaming(const char* fileName, const SVGSchema* schema);
+
+/**
+ * @brief Drives an already opened reader to the end of the document, building an
+ * SVG struct from the elements as they stream past.  If schema is not NULL, the
+ * document is validated in the same pass.  If arena is not NULL, every object is
+ * allocated from it and the returned SVG owns it (it is freed on failure).
+ * The reader is not freed
+ * @param reader
+ * @param schema
+ * @param arena
+ * @return SVG* or NULL
+ */
+SVG* buildSVGFromReader(xmlTextReaderPtr reader, const SVGSchema* schema, SVGArena* arena);
+
+/**
+ * @brief Validates a file and counts its rects, circles, paths and groups in a single
+ * streaming pass, without building an SVG struct.  The counts match what getRects(),
+ * getCircles(), getPaths() and getGroups() would return for createValidSVGStreaming()
+ * @param fileName
+ * @param schema
+ * @param counts
+ * @return true
+ * @return false if the file could not be read or is not valid
+ */
+bool countValidSVGStreaming(const char* fileName, const SVGSchema* schema, SVGCounts* counts);
+
+/**
+ * @brief Same as buildSVGFromReader(), but only counts the elements that would have
+ * been added to the SVG struct.  The reader is not freed
+ * @param reader
+ * @param schema
+ * @param counts
+ * @return true
+ * @return false
+ */
+bool countSVGFromReader(xmlTextReaderPtr reader, const SVGSchema* schema, SVGCounts* counts);
+
+/**
+ * @brief Returns the counts in the same JSON format as SVGtoJSON()
+ * @param counts
+ * @return char*
+ */
+char* SVGCountsToJSON(const SVGCounts* counts);
+
+#endif
@@ -0,0 +1,295 @@
+#ifndef SVGVIEWS_H
+#define SVGVIEWS_H
+
+#include <stdbool.h>
+
+#include "SVGParser.h"
+#include "SVGBounds.h"
+#include "SVGSpatial.h"
+
+//Borrowed, read-only array of every component of one type in an SVG struct, including the
+//ones inside (nested) groups.  The components are in the same order as getRects() etc. return them
+typedef struct {
+    //Pointers to the components in the SVG struct.  Do not free them
+    void** elements;
+    //Number of components in elements
+    int length;
+    //Number of slots allocated for elements
+    int capacity;
+} SVGView;
+
+//Numeric fields of every rectangle in the struct, one contiguous array per field
+//(structure of arrays).  Element i belongs to the i-th rectangle of the rect view
+typedef struct {
+    float* x;
+    float* y;
+    float* width;
+    float* height;
+    int length;
+    int capacity;
+} SVGRectColumns;
+
+//Numeric fields of every circle in the struct, one contiguous array per field.
+//Element i belongs to the i-th circle of the circle view
+typedef struct {
+    float* cx;
+    float* cy;
+    float* r;
+    int length;
+    int capacity;
+} SVGCircleColumns;
+
+//Areas of every rectangle or circle, sorted in ascending order (NaN areas last).
+//order[i] is the position in the rect/circle view of the shape with area areas[i]
+typedef struct {
+    float* areas;
+    int* order;
+    int length;
+    int capacity;
+} SVGAreaIndex;
+
+//One distinct path data string in the path data index
+typedef struct {
+    //64-bit FNV-1a hash and length of the data.  Strings are only compared when both match
+    unsigned long long hash;
+    size_t length;
+    //Position in the path view of the first path with this data, or -1 for an empty bucket
+    int first;
+    //Number of paths with this data
+    int count;
+} SVGPathBucket;
+
+//Hash table (open addressing, linear probing) of the data of every path in the struct
+typedef struct {
+    //capacity is a power of two, at least twice the number of paths
+    SVGPathBucket* buckets;
+    int capacity;
+    //next[i] is the position of the next path with the same data as path i, or -1
+    int* next;
+    int nextCapacity;
+    //Number of distinct data strings
+    int numDistinct;
+} SVGPathIndex;
+
+//One id in the id index
+typedef struct {
+    unsigned long long hash;
+    //Value of the element's id attribute, or NULL for an empty bucket
+    const char* id;
+    SVGElementHandle handle;
+} SVGIdBucket;
+
+//Hash table (open addressing, linear probing) from the 'id' attribute to its element
+typedef struct {
+    //capacity is a power of two, at least twice the number of ids
+    SVGIdBucket* buckets;
+    int capacity;
+    int numIds;
+} SVGIdIndex;
+
+//Flattened views of an SVG struct, built on first use and rebuilt after the struct changes
+struct svgViews {
+    //Value of SVG->generation when the views were built
+    unsigned long generation;
+    SVGView rects;
+    SVGView circles;
+    SVGView paths;
+    SVGView groups;
+
+    //The columns are only built when a numeric query needs them
+    bool hasColumns;
+    //Value of SVG->generation when the columns were built
+    unsigned long columnsGeneration;
+    SVGRectColumns rectColumns;
+    SVGCircleColumns circleColumns;
+
+    //Set by enableAreaIndex().  The index itself is only built when an area query needs it
+    bool useAreaIndex;
+    bool hasAreaIndex;
+    //Value of SVG->generation when the area index was built
+    unsigned long areaIndexGeneration;
+    SVGAreaIndex rectAreas;
+    SVGAreaIndex circleAreas;
+    //The path data index is built by the first path data query after every change
+    bool hasPathIndex;
+    //Value of SVG->generation when the path data index was built
+    unsigned long pathIndexGeneration;
+    SVGPathIndex pathIndex;
+
+    //The id index only depends on SVG->idGeneration, so editing other attributes keeps it
+    bool hasIdIndex;
+    unsigned long idIndexGeneration;
+    SVGIdIndex idIndex;
+
+    //Group and image bounds are computed together by the first bounds query after every change
+    bool hasBounds;
+    //Value of SVG->generation when the bounds were computed
+    unsigned long boundsGeneration;
+    SVGBoundsCache bounds;
+
+    //Set by enableSpatialIndex().  addComponent() and setAttribute() keep the index up to
+    //date, anything else makes the next spatial query load it again
+    bool useSpatialIndex;
+    bool hasSpatialIndex;
+    //Value of SVG->generation the spatial index matches
+    unsigned long spatialGeneration;
+    //Value of SVG->generation when the positions of the spatial index entries were set
+    unsigned long spatialOrderGeneration;
+    SVGSpatialIndex spatial;
+};
+
+/*Views are borrowed from the SVG struct: they stay valid until the next addComponent(),
+setAttribute() or deleteSVG() on it, and must not be freed by the caller.
+Building a view changes the cache of the struct, so the same SVG must not be read
+from several threads at once before the first call has returned.
+Structs built by hand (see isLibrarySVG in SVGHelpers.h) have no cache: their views are
+rebuilt by every call, in a buffer of the calling thread, and only stay valid until the
+next call on that thread.  The area and spatial indexes cannot be enabled on them*/
+
+/**
+ * @brief Returns every rectangle in the struct, including the ones inside groups
+ * @param img
+ * @return const SVGView* or NULL if img is NULL
+ */
+const SVGView* getRectView(const SVG* img);
+
+/**
+ * @brief Returns every circle in the struct, including the ones inside groups
+ * @param img
+ * @return const SVGView* or NULL if img is NULL
+ */
+const SVGView* getCircleView(const SVG* img);
+
+/**
+ * @brief Returns every path in the struct, including the ones inside groups
+ * @param img
+ * @return const SVGView* or NULL if img is NULL
+ */
+const SVGView* getPathView(const SVG* img);
+
+/**
+ * @brief Returns every group in the struct, including nested groups
+ * @param img
+ * @return const SVGView* or NULL if img is NULL
+ */
+const SVGView* getGroupView(const SVG* img);
+
+/**
+ * @brief Returns the numeric fields of every rectangle as columns (see SVGKernels.h)
+ * @param img
+ * @return const SVGRectColumns* or NULL if img is NULL
+ */
+const SVGRectColumns* getRectColumns(const SVG* img);
+
+/**
+ * @brief Returns the numeric fields of every circle as columns (see SVGKernels.h)
+ * @param img
+ * @return const SVGCircleColumns* or NULL if img is NULL
+ */
+const SVGCircleColumns* getCircleColumns(const SVG* img);
+
+/**
+ * @brief Counts the rectangles whose area (height * width) is in [minArea, maxArea]
+ * @param img
+ * @param minArea
+ * @param maxArea
+ * @return int
+ */
+int numRectsWithAreaBetween(const SVG* img, float minArea, float maxArea);
+
+/**
+ * @brief Counts the circles whose area (r * r * PI) is in [minArea, maxArea]
+ * @param img
+ * @param minArea
+ * @param maxArea
+ * @return int
+ */
+int numCirclesWithAreaBetween(const SVG* img, float minArea, float maxArea);
+
+/**
+ * @brief Turns the sorted area index of the struct on or off.  While it is on, the area
+ * queries (numRectsWithArea, numCirclesWithArea and the *WithAreaBetween functions) are
+ * answered by binary search.  The index is sorted on the first query after every change
+ * to the struct, so it only pays off when several queries are made per change.
+ * Does nothing for structs built by hand
+ * @param img
+ * @param enabled
+ */
+void enableAreaIndex(const SVG* img, bool enabled);
+
+/**
+ * @brief Counts the rectangles with ceil(area) == ceil(area) of the argument, using the area
+ * index if it is enabled.  Returns -1 if the index is not enabled, so the caller can scan instead
+ * @param img
+ * @param area
+ * @return int
+ */
+int indexedRectsWithArea(const SVG* img, float area);
+
+/**
+ * @brief Same as indexedRectsWithArea(), for circles
+ * @param img
+ * @param area
+ * @return int
+ */
+int indexedCirclesWithArea(const SVG* img, float area);
+
+/**
+ * @brief Returns the rectangles whose area is in [minArea, maxArea], in document order.
+ * Like getRects(), the List is new but the rectangles in it belong to the struct
+ * @param img
+ * @param minArea
+ * @param maxArea
+ * @return List* or NULL if img is NULL
+ */
+List* getRectsWithAreaBetween(const SVG* img, float minArea, float maxArea);
+
+/**
+ * @brief Returns the circles whose area is in [minArea, maxArea], in document order.
+ * Like getCircles(), the List is new but the circles in it belong to the struct
+ * @param img
+ * @param minArea
+ * @param maxArea
+ * @return List* or NULL if img is NULL
+ */
+List* getCirclesWithAreaBetween(const SVG* img, float minArea, float maxArea);
+
+/**
+ * @brief Counts the paths whose data is exactly data, using the path data index
+ * @param img
+ * @param data
+ * @return int or -1 if the index could not be built
+ */
+int indexedPathsWithData(const SVG* img, const char* data);
+
+/**
+ * @brief Finds every set of two or more paths that share the same data.
+ * Each element of the returned List is a List of the paths (in document order) of one set.
+ * The paths belong to the struct: freeList() on the returned List only frees the Lists
+ * @param img
+ * @return List* or NULL if img is NULL
+ */
+List* getDuplicatePathGroups(const SVG* img);
+
+/**
+ * @brief Returns the up to date views of the struct, building them if needed
+ * @param img
+ * @return SVGViews* or NULL if img is NULL or memory ran out
+ */
+SVGViews* getSVGViews(const SVG* img);
+
+/**
+ * @brief Marks the struct as changed, so the cached views are rebuilt on their next use.
+ * Code that changes the lists of an SVG struct directly should call markSVGChanged(),
+ * which also drops the cached totals
+ * @param img
+ */
+void invalidateSVGViews(SVG* img);
+
+/**
+ * @brief Frees the cached views.  Called by deleteSVG()
+ * @param views
+ */
+void freeSVGViews(SVGViews* views);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef SVGWRITER_H
+#define SVGWRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "SVGParser.h"
+#include "StringBuilder.h"
+
+//Receives the text of an SVG export (see TextSink in StringBuilder.h, which also has sinks
+//for files, file descriptors and StringBuilders)
+typedef TextSink SVGWriteSink;
+
+//Layout of the written XML
+typedef enum {
+    //Every element on its own line, indented by nesting depth - what writeSVG() writes
+    SVG_WRITE_PRETTY,
+    //No whitespace between elements, for files that are only read by programs
+    SVG_WRITE_COMPACT
+} SVGWriteFormat;
+
+/*The writers below emit the XML straight from the struct with an xmlTextWriter, element by
+element, instead of building an xmlDoc first, so saving does not hold a second copy of the
+image in memory.  Like writeSVG(), they fail if the namespace is empty*/
+
+/**
+ * @brief Streams the SVG XML of an SVG struct to a sink in a single traversal
+ * @param img
+ * @param format
+ * @param sink
+ * @param context - passed to every call of sink
+ * @return true
+ * @return false if img or sink is NULL, the namespace is empty or sink stopped the export
+ */
+bool writeSVGToSink(const SVG* img, SVGWriteFormat format, SVGWriteSink sink, void* context);
+
+/**
+ * @brief Writes the SVG XML of an SVG struct to a file, replacing it if it exists
+ * @param img
+ * @param fileName
+ * @param format
+ * @return true
+ * @return false if the file could not be written
+ */
+bool writeSVGToFile(const SVG* img, const char* fileName, SVGWriteFormat format);
+
+/**
+ * @brief Writes the SVG XML of an SVG struct to a file descriptor (a file, pipe or socket).
+ * The descriptor is left open
+ * @param img
+ * @param fd
+ * @param format
+ * @return true
+ * @return false if writing failed
+ */
+bool writeSVGToFd(const SVG* img, int fd, SVGWriteFormat format);
+
+/**
+ * @brief Returns the SVG XML of an SVG struct as one string
+ * @param img
+ * @param format
+ * @return char* - must be freed by the caller, or NULL if the struct cannot be written
+ */
+char* SVGtoXMLString(const SVG* img, SVGWriteFormat format);
+
+#endif
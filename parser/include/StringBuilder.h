@@ -0,0 +1,101 @@
+#ifndef STRINGBUILDER_H
+#define STRINGBUILDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+//Growable string that the toString and JSON functions are written into.  The buffer doubles
+//whenever it runs out of room, so building a string of n characters takes O(n) time
+typedef struct {
+    //NUL-terminated contents, or NULL while nothing has been allocated
+    char* data;
+    //Number of characters in data, not counting the NUL
+    size_t length;
+    //Number of bytes allocated for data
+    size_t capacity;
+    //Set when memory runs out.  Later appends are ignored and finishString() returns NULL
+    bool failed;
+} StringBuilder;
+
+//Receives exported text piece by piece, in order - the SVG and JSON writers stream through
+//it.  The text is not NUL-terminated and is only valid during the call.  Returns false to
+//stop the export
+typedef bool (*TextSink)(const char* text, size_t length, void* context);
+
+/**
+ * @brief Creates an empty builder
+ * @param capacity - number of characters to make room for up front (may be 0)
+ * @return StringBuilder
+ */
+StringBuilder createStringBuilder(size_t capacity);
+
+/**
+ * @brief Appends the first length characters of chars
+ * @param builder
+ * @param chars
+ * @param length
+ */
+void appendChars(StringBuilder* builder, const char* chars, size_t length);
+
+/**
+ * @brief Appends a NUL-terminated string.  NULL appends nothing
+ * @param builder
+ * @param str
+ */
+void appendString(StringBuilder* builder, const char* str);
+
+/**
+ * @brief Appends one character
+ * @param builder
+ * @param c
+ */
+void appendChar(StringBuilder* builder, char c);
+
+/**
+ * @brief Appends printf-style formatted text, of any length
+ * @param builder
+ * @param format
+ */
+void appendFormat(StringBuilder* builder, const char* format, ...);
+
+/**
+ * @brief Hands the built string to the caller, who must free it, and leaves the builder empty
+ * @param builder
+ * @return char* - "" if nothing was appended, NULL if memory ran out
+ */
+char* finishString(StringBuilder* builder);
+
+/**
+ * @brief Frees the contents of a builder that will not be finished
+ * @param builder
+ */
+void discardString(StringBuilder* builder);
+
+/**
+ * @brief TextSink that writes to an open file
+ * @param text
+ * @param length
+ * @param context - the FILE*
+ * @return false if the file did not take all of the text
+ */
+bool fileSink(const char* text, size_t length, void* context);
+
+/**
+ * @brief TextSink that writes to a file descriptor, retrying partial writes
+ * @param text
+ * @param length
+ * @param context - pointer to the int file descriptor
+ * @return false if write() failed
+ */
+bool fdSink(const char* text, size_t length, void* context);
+
+/**
+ * @brief TextSink that appends to a StringBuilder
+ * @param text
+ * @param length
+ * @param context - the StringBuilder*
+ * @return false once the builder ran out of memory
+ */
+bool builderSink(const char* text, size_t length, void* context);
+
+#endif
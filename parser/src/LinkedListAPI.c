@@ -1,5 +1,193 @@
+/*pthread_key_t is POSIX, not C11*/
+#define _POSIX_C_SOURCE 200809L
+
 #include "LinkedListAPI.h"
 #include "assert.h"
+#include "StringBuilder.h"
+
+/*The array-backed implementation in VectorListAPI.c is used instead when LIST_VECTOR is defined*/
+#ifndef LIST_VECTOR
+
+#include <pthread.h>
+
+/*Number of nodes in one slab of the node pool*/
+#define NODE_SLAB_SIZE 256
+
+/*Block of nodes handed out by the node pool*/
+typedef struct nodeSlab{
+    struct nodeSlab* next;
+    Node nodes[NODE_SLAB_SIZE];
+} NodeSlab;
+
+/*Every thread has its own pool, so no locking is needed.  A node freed by another thread
+than the one that allocated it simply joins the freeing thread's free list.
+Slabs are only returned to malloc by releaseListPool(), since nodes from them may still be in use*/
+static _Thread_local NodeSlab* nodeSlabs = NULL;
+static _Thread_local int slabNodesUsed = NODE_SLAB_SIZE;
+static _Thread_local Node* freeNodes = NULL;
+static _Thread_local ListPoolStats poolStats = {0, 0, 0};
+//Nodes taken from the pool by this thread minus nodes returned by it.  Negative when the
+//thread frees nodes of other threads, so only the sum over all threads is meaningful
+static _Thread_local long nodesInUse = 0;
+static _Thread_local bool poolRegistered = false;
+
+/*When a thread exits, its slabs and free nodes move to the depot, and threads that run out
+of nodes take the free ones from there before allocating a new slab*/
+static pthread_mutex_t depotLock = PTHREAD_MUTEX_INITIALIZER;
+static NodeSlab* depotSlabs = NULL;
+static Node* depotNodes = NULL;
+//Sum of nodesInUse of the threads that have exited
+static long depotNodesInUse = 0;
+//Threads that have used the pool and not exited yet
+static int poolThreads = 0;
+static pthread_key_t poolKey;
+static pthread_once_t poolKeyOnce = PTHREAD_ONCE_INIT;
+
+/** Moves the pool of the calling thread to the depot.  Runs when a thread that used
+* the pool exits
+*@param value the thread's value of poolKey, unused
+**/
+static void releaseThreadPool(void* value){
+    (void)value;
+
+    /*The unused end of the current slab is handed over as free nodes too*/
+    while (nodeSlabs != NULL && slabNodesUsed < NODE_SLAB_SIZE){
+        Node* tmpNode = &nodeSlabs->nodes[slabNodesUsed++];
+        tmpNode->next = freeNodes;
+        freeNodes = tmpNode;
+    }
+
+    pthread_mutex_lock(&depotLock);
+    while (nodeSlabs != NULL){
+        NodeSlab* slab = nodeSlabs;
+        nodeSlabs = slab->next;
+        slab->next = depotSlabs;
+        depotSlabs = slab;
+    }
+    while (freeNodes != NULL){
+        Node* tmpNode = freeNodes;
+        freeNodes = tmpNode->next;
+        tmpNode->next = depotNodes;
+        depotNodes = tmpNode;
+    }
+    depotNodesInUse += nodesInUse;
+    poolThreads--;
+    pthread_mutex_unlock(&depotLock);
+
+    nodesInUse = 0;
+    poolRegistered = false;
+}
+
+static void createPoolKey(void){
+    pthread_key_create(&poolKey, &releaseThreadPool);
+}
+
+/** Makes sure the pool of the calling thread is moved to the depot when the thread exits
+**/
+static void registerPool(void){
+    pthread_once(&poolKeyOnce, &createPoolKey);
+
+    /*Key destructors only run for threads with a non-NULL value*/
+    pthread_setspecific(poolKey, (void*)&poolKey);
+    pthread_mutex_lock(&depotLock);
+    poolThreads++;
+    pthread_mutex_unlock(&depotLock);
+    poolRegistered = true;
+}
+
+/** Takes a node from the pool - from the free list if possible, otherwise from the depot
+* or the current slab
+*@return a node, or NULL if a new slab could not be allocated
+**/
+static Node* poolAllocNode(void){
+    if (freeNodes != NULL){
+        Node* tmpNode = freeNodes;
+        freeNodes = tmpNode->next;
+        poolStats.hits++;
+        nodesInUse++;
+        return tmpNode;
+    }
+
+    if (!poolRegistered){
+        registerPool();
+    }
+
+    if (slabNodesUsed == NODE_SLAB_SIZE){
+        /*Nodes left behind by exited threads are used up before the pool grows*/
+        pthread_mutex_lock(&depotLock);
+        freeNodes = depotNodes;
+        depotNodes = NULL;
+        pthread_mutex_unlock(&depotLock);
+
+        if (freeNodes != NULL){
+            return poolAllocNode();
+        }
+
+        NodeSlab* slab = malloc(sizeof(NodeSlab));
+        if (slab == NULL){
+            return NULL;
+        }
+        slab->next = nodeSlabs;
+        nodeSlabs = slab;
+        slabNodesUsed = 0;
+        poolStats.slabs++;
+    }
+
+    poolStats.misses++;
+    nodesInUse++;
+    return &nodeSlabs->nodes[slabNodesUsed++];
+}
+
+/** Returns a node to the pool's free list
+*@param node a node that was taken from poolAllocNode()
+**/
+static void poolFreeNode(Node* node){
+    if (!poolRegistered){
+        registerPool();
+    }
+
+    node->next = freeNodes;
+    freeNodes = node;
+    nodesInUse--;
+}
+
+bool releaseListPool(void){
+    pthread_mutex_lock(&depotLock);
+
+    /*Slabs can only be freed once no node of any thread is in use, and other threads
+    cannot be asked to give up their slabs*/
+    bool released = (poolThreads == (poolRegistered ? 1 : 0) && depotNodesInUse + nodesInUse == 0);
+    if (released){
+        while (depotSlabs != NULL){
+            NodeSlab* slab = depotSlabs;
+            depotSlabs = slab->next;
+            free(slab);
+        }
+        while (nodeSlabs != NULL){
+            NodeSlab* slab = nodeSlabs;
+            nodeSlabs = slab->next;
+            free(slab);
+        }
+        depotNodes = NULL;
+        depotNodesInUse = 0;
+        nodesInUse = 0;
+        freeNodes = NULL;
+        slabNodesUsed = NODE_SLAB_SIZE;
+
+        if (poolRegistered){
+            poolThreads--;
+            poolRegistered = false;
+            pthread_setspecific(poolKey, NULL);
+        }
+    }
+
+    pthread_mutex_unlock(&depotLock);
+    return released;
+}
+
+ListPoolStats getListPoolStats(void){
+    return poolStats;
+}
 
 /** Function to initialize the list metadata head to the appropriate function pointers. Allocates memory to the struct.
 *@return pointer to the list head
@@ -13,7 +201,31 @@ List * initializeList(char* (*printFunction)(void* toBePrinted),void (*deleteFun
     assert(deleteFunction != NULL);
     assert(compareFunction != NULL);
 
-    List * tmpList = malloc(sizeof(List));
+    return initializeListWithAllocator(printFunction, deleteFunction, compareFunction, NULL);
+}
+
+/** Same as initializeList(), but the List struct and all of its Nodes are taken from allocator.
+*@return pointer to the list head
+*@param printFunction function pointer to print a single node of the list
+*@param deleteFunction function pointer to delete a single piece of data from the list
+*@param compareFunction function pointer to compare two nodes of the list in order to test for equality or order
+*@param allocator allocator the list memory is taken from, or NULL for malloc
+**/
+List * initializeListWithAllocator(char* (*printFunction)(void* toBePrinted),void (*deleteFunction)(void* toBeDeleted),int (*compareFunction)(const void* first,const void* second), ListAllocator* allocator){
+    assert(printFunction != NULL);
+    assert(deleteFunction != NULL);
+    assert(compareFunction != NULL);
+
+    List * tmpList;
+    if (allocator != NULL){
+        tmpList = allocator->alloc(allocator->context, sizeof(List));
+    }else{
+        tmpList = malloc(sizeof(List));
+    }
+
+    if (tmpList == NULL){
+        return NULL;
+    }
 	
 	tmpList->head = NULL;
 	tmpList->tail = NULL;
@@ -23,11 +235,24 @@ List * initializeList(char* (*printFunction)(void* toBePrinted),void (*deleteFun
 	tmpList->deleteData = deleteFunction;
 	tmpList->compare = compareFunction;
 	tmpList->printData = printFunction;
+	tmpList->allocator = allocator;
+	tmpList->index = NULL;
+	tmpList->freeIndex = NULL;
 	
 	return tmpList;
 }
 
 
+/** Frees the lookup index of a list, since it may no longer match the list
+*@param list pointer to the List struct
+**/
+static void dropIndex(List* list){
+    if (list->index != NULL && list->freeIndex != NULL){
+        list->freeIndex(list->index);
+    }
+    list->index = NULL;
+}
+
 /** Deletes the entire linked list, freeing all memory.
 * uses the supplied function pointer to release allocated memory for the data
 *@pre 'List' type must exist and be used in order to keep track of the linked list.
@@ -35,9 +260,16 @@ List * initializeList(char* (*printFunction)(void* toBePrinted),void (*deleteFun
 *@return  on success: NULL, on failure: head of list
 **/
 void freeList(List* list){	
+    if (list == NULL){
+		return;
+	}
 
     clearList(list);
-	free(list);
+
+    /*Memory of allocator-backed lists belongs to the allocator*/
+    if (list->allocator == NULL){
+	    free(list);
+    }
 }
 
 /** Clears the list: frees the contents of the list - Node structs and data stored in them - 
@@ -52,6 +284,8 @@ void clearList(List* list){
     if (list == NULL){
 		return;
 	}
+
+	dropIndex(list);
 	
 	if (list->head == NULL && list->tail == NULL){
 		return;
@@ -60,10 +294,13 @@ void clearList(List* list){
 	Node* tmp;
 	
 	while (list->head != NULL){
-		list->deleteData(list->head->data);
 		tmp = list->head;
 		list->head = list->head->next;
-		free(tmp);
+
+		if (list->allocator == NULL){
+			list->deleteData(tmp->data);
+			poolFreeNode(tmp);
+		}
 	}
 	
 	list->head = NULL;
@@ -94,6 +331,32 @@ Node* initializeNode(void* data){
 	return tmpNode;
 }
 
+/** Creates a node for a specific list, taking it from the list's allocator if it has one,
+* or from the node pool otherwise
+*@return On success returns a node that can be added to list. On failure, returns NULL.
+*@param list the list the node will be added to
+*@param data a void * pointer to any data type
+**/
+static Node* initializeListNode(List* list, void* data){
+	Node* tmpNode;
+
+	if (list->allocator == NULL){
+		tmpNode = poolAllocNode();
+	}else{
+		tmpNode = (Node*)list->allocator->alloc(list->allocator->context, sizeof(Node));
+	}
+	
+	if (tmpNode == NULL){
+		return NULL;
+	}
+	
+	tmpNode->data = data;
+	tmpNode->previous = NULL;
+	tmpNode->next = NULL;
+	
+	return tmpNode;
+}
+
 /**Inserts a Node at the front of a linked list.  List metadata is updated
 * so that head and tail pointers are correct.
 *@pre 'List' type must exist and be used in order to keep track of the linked list.
@@ -105,9 +368,12 @@ void insertBack(List* list, void* toBeAdded){
 		return;
 	}
 	
-	(list->length)++;
+	Node* newNode = initializeListNode(list, toBeAdded);
+	if (newNode == NULL){
+		return;
+	}
 
-	Node* newNode = initializeNode(toBeAdded);
+	(list->length)++;
 	
     if (list->head == NULL && list->tail == NULL){
         list->head = newNode;
@@ -129,10 +395,15 @@ void insertFront(List* list, void* toBeAdded){
 	if (list == NULL || toBeAdded == NULL){
 		return;
 	}
+
+	dropIndex(list);
 	
-	(list->length)++;
+	Node* newNode = initializeListNode(list, toBeAdded);
+	if (newNode == NULL){
+		return;
+	}
 
-	Node* newNode = initializeNode(toBeAdded);
+	(list->length)++;
 	
     if (list->head == NULL && list->tail == NULL){
         list->head = newNode;
@@ -179,6 +450,8 @@ void* deleteDataFromList(List* list, void* toBeDeleted){
 	
 	while(tmp != NULL){
 		if (list->compare(toBeDeleted, tmp->data) == 0){
+			dropIndex(list);
+
 			//Unlink the node
 			Node* delNode = tmp;
 			
@@ -195,7 +468,9 @@ void* deleteDataFromList(List* list, void* toBeDeleted){
 			}
 			
 			void* data = delNode->data;
-			free(delNode);
+			if (list->allocator == NULL){
+				poolFreeNode(delNode);
+			}
 			
 			(list->length)--;
 
@@ -224,6 +499,8 @@ void insertSorted(List *list, void *toBeAdded){
 		return;
 	}
 
+	dropIndex(list);
+
 	if (list->head == NULL){
 		insertBack(list, toBeAdded);
 		return;
@@ -252,7 +529,10 @@ void insertSorted(List *list, void *toBeAdded){
 			free(currDescr);
 			free(newDescr);
 		
-			Node* newNode = initializeNode(toBeAdded);
+			Node* newNode = initializeListNode(list, toBeAdded);
+			if (newNode == NULL){
+				return;
+			}
 			newNode->next = currNode;
 			newNode->previous = currNode->previous;
 			currNode->previous->next = newNode;
@@ -277,23 +557,18 @@ returned string must be freed by the calling function.
  **/
 char* toString(List * list){
 	ListIterator iter = createIterator(list);
-	char* str;
-		
-	str = (char*)malloc(sizeof(char));
-	strcpy(str, "");
-	
+	StringBuilder str = createStringBuilder(0);
+
 	void* elem;
 	while((elem = nextElement(&iter)) != NULL){
 		char* currDescr = list->printData(elem);
-		int newLen = strlen(str)+50+strlen(currDescr);
-		str = (char*)realloc(str, newLen);
-		strcat(str, "\n");
-		strcat(str, currDescr);
-		
+		appendChar(&str, '\n');
+		appendString(&str, currDescr);
+
 		free(currDescr);
 	}
-	
-	return str;
+
+	return finishString(&str);
 }
 
 ListIterator createIterator(List* list){
@@ -319,6 +594,19 @@ int getLength(List* list){
 	return list->length;
 }
 
+void* getElementAt(List* list, int index){
+	if (list == NULL || index < 0 || index >= list->length){
+		return NULL;
+	}
+
+	Node* tmp = list->head;
+	for (int i = 0; i < index; i++){
+		tmp = tmp->next;
+	}
+
+	return tmp->data;
+}
+
 void* findElement(List * list, bool (*customCompare)(const void* first,const void* second), const void* searchRecord){
 	if (customCompare == NULL)
 		return NULL;
@@ -336,3 +624,5 @@ void* findElement(List * list, bool (*customCompare)(const void* first,const voi
 
 	return NULL;
 }
+
+#endif
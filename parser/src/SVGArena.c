@@ -0,0 +1,222 @@
+/**
+ * @file SVGArena.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief This file contains the arena allocator used by arena-backed SVG structs.
+ * All objects of a document are bump-allocated from a few large chunks, so building
+ * an SVG is a handful of mallocs and deleting it is one free per chunk
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include <libxml/xmlreader.h>
+
+#include "SVGParser.h"
+#include "SVGArena.h"
+#include "SVGStream.h"
+#include "LinkedListAPI.h"
+
+/*Every allocation is rounded up to this, so any struct can be placed at the returned address*/
+#define ARENA_ALIGN (_Alignof(max_align_t))
+
+/**
+ * @brief ListAllocator callback for arena-backed lists
+ * @param context
+ * @param size
+ * @return void*
+ */
+static void* arenaListAlloc(void* context, size_t size) {
+    return arenaAlloc((SVGArena*)context, size);
+}
+
+/**
+ * @brief Allocates a new chunk with room for at least size bytes and makes it the current one
+ * @param arena
+ * @param size
+ * @return ArenaChunk*
+ */
+static ArenaChunk* addChunk(SVGArena* arena, size_t size) {
+    size_t chunkSize = (size > arena->chunkSize) ? size : arena->chunkSize;
+    ArenaChunk* chunk = malloc(sizeof(ArenaChunk) + chunkSize);
+
+    if (chunk == NULL) {
+        return NULL;
+    }
+
+    chunk->size = chunkSize;
+    chunk->used = 0;
+
+    /*Oversized chunks are full as soon as they are used, so keep allocating from the current one*/
+    if (size > arena->chunkSize && arena->chunks != NULL) {
+        chunk->next = arena->chunks->next;
+        arena->chunks->next = chunk;
+    } else {
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+    }
+    arena->numChunks++;
+
+    return chunk;
+}
+
+/**
+ * @brief Creates an empty arena
+ * @param chunkSize
+ * @return SVGArena*
+ */
+SVGArena* createArena(size_t chunkSize) {
+    SVGArena* arena = malloc(sizeof(SVGArena));
+
+    if (arena == NULL) {
+        return NULL;
+    }
+
+    arena->chunks = NULL;
+    arena->chunkSize = (chunkSize == 0) ? ARENA_CHUNK_SIZE : chunkSize;
+    arena->numChunks = 0;
+    arena->cleanups = NULL;
+    arena->listAllocator.alloc = &arenaListAlloc;
+    arena->listAllocator.context = arena;
+
+    return arena;
+}
+
+/**
+ * @brief Allocates size bytes from the arena
+ * @param arena
+ * @param size
+ * @return void*
+ */
+void* arenaAlloc(SVGArena* arena, size_t size) {
+    if (arena == NULL) {
+        return NULL;
+    }
+
+    size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+    if (size == 0) {
+        size = ARENA_ALIGN;
+    }
+
+    ArenaChunk* chunk = arena->chunks;
+    if (chunk == NULL || chunk->size - chunk->used < size) {
+        chunk = addChunk(arena, size);
+        if (chunk == NULL) {
+            return NULL;
+        }
+    }
+
+    void* mem = (char*)chunk->align + chunk->used;
+    chunk->used += size;
+
+    return mem;
+}
+
+/**
+ * @brief Copies a string into the arena
+ * @param arena
+ * @param str
+ * @return char*
+ */
+char* arenaStrdup(SVGArena* arena, const char* str) {
+    if (str == NULL) {
+        return NULL;
+    }
+
+    char* copy = arenaAlloc(arena, strlen(str) + 1);
+    if (copy != NULL) {
+        strcpy(copy, str);
+    }
+
+    return copy;
+}
+
+/**
+ * @brief Hands a heap object to the arena, so it is deleted together with the arena
+ * @param arena
+ * @param data
+ * @param deleteData
+ */
+void arenaAdopt(SVGArena* arena, void* data, void (*deleteData)(void* toBeDeleted)) {
+    if (arena == NULL || data == NULL || deleteData == NULL) {
+        return ;
+    }
+
+    ArenaCleanup* cleanup = arenaAlloc(arena, sizeof(ArenaCleanup));
+    if (cleanup == NULL) {
+        return ;
+    }
+
+    cleanup->data = data;
+    cleanup->deleteData = deleteData;
+    cleanup->next = arena->cleanups;
+    arena->cleanups = cleanup;
+}
+
+/**
+ * @brief Deletes every adopted object, then frees every chunk of the arena
+ * @param arena
+ */
+void freeArena(SVGArena* arena) {
+    if (arena == NULL) {
+        return ;
+    }
+
+    /*Adopted objects are deleted first, the cleanup records themselves live in the chunks*/
+    ArenaCleanup* cleanup;
+    for (cleanup = arena->cleanups; cleanup != NULL; cleanup = cleanup->next) {
+        cleanup->deleteData(cleanup->data);
+    }
+
+    ArenaChunk* chunk = arena->chunks;
+    while (chunk != NULL) {
+        ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    free(arena);
+}
+
+/**
+ * @brief Builds an arena-backed SVG from a file
+ * @param fileName
+ * @return SVG*
+ */
+SVG* createArenaSVG(const char* fileName) {
+    return createValidArenaSVG(fileName, NULL);
+}
+
+/**
+ * @brief Validates and builds an arena-backed SVG from a file
+ * @param fileName
+ * @param schema
+ * @return SVG*
+ */
+SVG* createValidArenaSVG(const char* fileName, const SVGSchema* schema) {
+    if (fileName == NULL || strcmp(fileName, "") == 0) {
+        return NULL;
+    }
+
+    LIBXML_TEST_VERSION
+
+    xmlTextReaderPtr reader = xmlReaderForFile(fileName, NULL, 0);
+    if (reader == NULL) {
+        return NULL;
+    }
+
+    SVGArena* arena = createArena(0);
+    if (arena == NULL) {
+        xmlFreeTextReader(reader);
+        return NULL;
+    }
+
+    /*On failure the builder deletes the SVG, which frees the arena with it*/
+    SVG* SVGObject = buildSVGFromReader(reader, schema, arena);
+    xmlFreeTextReader(reader);
+
+    return SVGObject;
+}
@@ -0,0 +1,463 @@
+/**
+ * @file SVGBounds.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief This file contains the bounding box functions for shapes, groups and whole
+ * images.  Group and image bounds are cached in the views of the SVG struct
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SVGParser.h"
+#include "SVGHelpers.h"
+#include "SVGSchema.h"
+#include "SVGArena.h"
+#include "SVGViews.h"
+#include "SVGPath.h"
+#include "SVGBounds.h"
+#include "LinkedListAPI.h"
+
+/*Bounds built in double precision while a path is walked*/
+typedef struct {
+    double minX;
+    double minY;
+    double maxX;
+    double maxY;
+    bool empty;
+} BoundsBuilder;
+
+static void includePoint(BoundsBuilder* builder, double x, double y) {
+    if (builder->empty) {
+        builder->minX = builder->maxX = x;
+        builder->minY = builder->maxY = y;
+        builder->empty = false;
+        return ;
+    }
+
+    builder->minX = fmin(builder->minX, x);
+    builder->minY = fmin(builder->minY, y);
+    builder->maxX = fmax(builder->maxX, x);
+    builder->maxY = fmax(builder->maxY, y);
+}
+
+static SVGBounds finishBounds(const BoundsBuilder* builder) {
+    if (builder->empty) {
+        return emptyBounds();
+    }
+
+    SVGBounds bounds = {(float)builder->minX, (float)builder->minY, (float)builder->maxX, (float)builder->maxY, false};
+    return bounds;
+}
+
+/**
+ * @brief Returns bounds with nothing in them
+ * @return SVGBounds
+ */
+SVGBounds emptyBounds(void) {
+    SVGBounds bounds = {0, 0, 0, 0, true};
+    return bounds;
+}
+
+/**
+ * @brief Returns the smallest bounds that contain both a and b
+ * @param a
+ * @param b
+ * @return SVGBounds
+ */
+SVGBounds unionBounds(SVGBounds a, SVGBounds b) {
+    if (a.empty) {
+        return b;
+    }
+    if (b.empty) {
+        return a;
+    }
+
+    SVGBounds bounds = {fminf(a.minX, b.minX), fminf(a.minY, b.minY), fmaxf(a.maxX, b.maxX), fmaxf(a.maxY, b.maxY), false};
+    return bounds;
+}
+
+/**
+ * @brief Returns the bounds of a rectangle
+ * @param rect
+ * @return SVGBounds
+ */
+SVGBounds getRectBounds(const Rectangle* rect) {
+    if (rect == NULL) {
+        return emptyBounds();
+    }
+
+    SVGBounds bounds = {fminf(rect->x, rect->x + rect->width), fminf(rect->y, rect->y + rect->height),
+                        fmaxf(rect->x, rect->x + rect->width), fmaxf(rect->y, rect->y + rect->height), false};
+    return bounds;
+}
+
+/**
+ * @brief Returns the bounds of a circle
+ * @param circle
+ * @return SVGBounds
+ */
+SVGBounds getCircleBounds(const Circle* circle) {
+    if (circle == NULL) {
+        return emptyBounds();
+    }
+
+    float r = fabsf(circle->r);
+    SVGBounds bounds = {circle->cx - r, circle->cy - r, circle->cx + r, circle->cy + r, false};
+    return bounds;
+}
+
+/**
+ * @brief Includes the points where one coordinate of a cubic Bezier curve turns around
+ * @param builder
+ * @param p - x0 y0 x1 y1 x2 y2 x3 y3
+ */
+static void includeCubicExtrema(BoundsBuilder* builder, const double* p) {
+    for (int axis = 0; axis < 2; axis++) {
+        double p0 = p[axis];
+        double p1 = p[axis + 2];
+        double p2 = p[axis + 4];
+        double p3 = p[axis + 6];
+
+        /*Derivative divided by 3: a*t^2 + b*t + c*/
+        double a = -p0 + 3 * p1 - 3 * p2 + p3;
+        double b = 2 * (p0 - 2 * p1 + p2);
+        double c = p1 - p0;
+        double roots[2];
+        int numRoots = 0;
+
+        if (fabs(a) < 1e-12) {
+            if (fabs(b) > 1e-12) {
+                roots[numRoots++] = -c / b;
+            }
+        } else {
+            double disc = b * b - 4 * a * c;
+            if (disc >= 0) {
+                roots[numRoots++] = (-b + sqrt(disc)) / (2 * a);
+                roots[numRoots++] = (-b - sqrt(disc)) / (2 * a);
+            }
+        }
+
+        for (int i = 0; i < numRoots; i++) {
+            double t = roots[i];
+            if (t > 0 && t < 1) {
+                double mt = 1 - t;
+                double x = mt * mt * mt * p[0] + 3 * mt * mt * t * p[2] + 3 * mt * t * t * p[4] + t * t * t * p[6];
+                double y = mt * mt * mt * p[1] + 3 * mt * mt * t * p[3] + 3 * mt * t * t * p[5] + t * t * t * p[7];
+                includePoint(builder, x, y);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Includes the points where one coordinate of a quadratic Bezier curve turns around
+ * @param builder
+ * @param p - x0 y0 x1 y1 x2 y2
+ */
+static void includeQuadExtrema(BoundsBuilder* builder, const double* p) {
+    for (int axis = 0; axis < 2; axis++) {
+        double den = p[axis] - 2 * p[axis + 2] + p[axis + 4];
+
+        if (fabs(den) > 1e-12) {
+            double t = (p[axis] - p[axis + 2]) / den;
+            if (t > 0 && t < 1) {
+                double mt = 1 - t;
+                includePoint(builder, mt * mt * p[0] + 2 * mt * t * p[2] + t * t * p[4], mt * mt * p[1] + 2 * mt * t * p[3] + t * t * p[5]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Returns whether angle lies on an arc that starts at start and sweeps by sweep
+ * @return true
+ * @return false
+ */
+static bool angleOnArc(double angle, double start, double sweep) {
+    double offset = (sweep >= 0) ? angle - start : start - angle;
+
+    offset = fmod(offset, 2 * PI);
+    if (offset < 0) {
+        offset += 2 * PI;
+    }
+    return offset <= fabs(sweep);
+}
+
+/**
+ * @brief Includes the points where a centre form arc is furthest left, right, up or down
+ * @param builder
+ * @param a - rx ry rotation cx cy startAngle sweepAngle x y
+ */
+static void includeArcExtrema(BoundsBuilder* builder, const float* a) {
+    double rx = a[0];
+    double ry = a[1];
+    double cosPhi = cos(a[2]);
+    double sinPhi = sin(a[2]);
+
+    /*x(t) = cx + rx*cos(t)*cos(phi) - ry*sin(t)*sin(phi), and y(t) likewise - each has
+    two stationary angles, half a turn apart*/
+    double angles[4];
+    angles[0] = atan2(-ry * sinPhi, rx * cosPhi);
+    angles[1] = angles[0] + PI;
+    angles[2] = atan2(ry * cosPhi, rx * sinPhi);
+    angles[3] = angles[2] + PI;
+
+    for (int i = 0; i < 4; i++) {
+        if (angleOnArc(angles[i], a[5], a[6])) {
+            double cosT = cos(angles[i]);
+            double sinT = sin(angles[i]);
+            includePoint(builder, a[3] + rx * cosT * cosPhi - ry * sinT * sinPhi, a[4] + rx * cosT * sinPhi + ry * sinT * cosPhi);
+        }
+    }
+}
+
+/**
+ * @brief Returns the exact bounds of a path, including the extrema of its curves and arcs
+ * @param path
+ * @return SVGBounds
+ */
+SVGBounds getPathBounds(Path* path) {
+    BoundsBuilder builder = {0, 0, 0, 0, true};
+    SVGPathIterator iter = createPathIterator(getPathCommands(path));
+    const SVGPathCommand* command;
+    double x = 0;
+    double y = 0;
+
+    while ((command = nextPathCommand(&iter)) != NULL) {
+        const float* c = command->coords;
+        int numCoords = SVG_PATH_OP_COORDS[command->op];
+
+        if (command->op == PATH_CUBIC) {
+            double p[8] = {x, y, c[0], c[1], c[2], c[3], c[4], c[5]};
+            includeCubicExtrema(&builder, p);
+        } else if (command->op == PATH_QUAD) {
+            double p[6] = {x, y, c[0], c[1], c[2], c[3]};
+            includeQuadExtrema(&builder, p);
+        } else if (command->op == PATH_ARC) {
+            includeArcExtrema(&builder, c);
+        }
+
+        /*Every command ends at its last coordinate pair, and curves stay between their end
+        points and the extrema found above*/
+        x = c[numCoords - 2];
+        y = c[numCoords - 1];
+        includePoint(&builder, x, y);
+    }
+
+    return finishBounds(&builder);
+}
+
+/**
+ * @brief Returns the union of the bounds of the shapes in three lists
+ * @param rects
+ * @param circles
+ * @param paths
+ * @return SVGBounds
+ */
+static SVGBounds shapeListBounds(List* rects, List* circles, List* paths) {
+    SVGBounds bounds = emptyBounds();
+    ListIterator iter;
+    void* elem;
+
+    iter = createIterator(rects);
+    while ((elem = nextElement(&iter)) != NULL) {
+        bounds = unionBounds(bounds, getRectBounds((Rectangle*)elem));
+    }
+    iter = createIterator(circles);
+    while ((elem = nextElement(&iter)) != NULL) {
+        bounds = unionBounds(bounds, getCircleBounds((Circle*)elem));
+    }
+    iter = createIterator(paths);
+    while ((elem = nextElement(&iter)) != NULL) {
+        bounds = unionBounds(bounds, getPathBounds((Path*)elem));
+    }
+
+    return bounds;
+}
+
+static int groupSlot(const SVGBoundsCache* cache, const Group* group) {
+    unsigned long long hash = (unsigned long long)(size_t)group * 0x9E3779B97F4A7C15ULL;
+    return (int)(hash >> 32) & (cache->numSlots - 1);
+}
+
+/**
+ * @brief Computes the bounds of a group and of every group nested in it, in the same
+ * (pre)order the group view lists them
+ * @param cache
+ * @param groups - the groups to compute, in list order
+ * @param position - position in the group view of the first group of the list
+ * @return SVGBounds - union of the bounds of the groups in the list
+ */
+static SVGBounds computeGroupBounds(SVGBoundsCache* cache, List* groups, int* position) {
+    SVGBounds total = emptyBounds();
+    ListIterator iter = createIterator(groups);
+    void* elem;
+
+    while ((elem = nextElement(&iter)) != NULL) {
+        Group* group = (Group*)elem;
+        int index = (*position)++;
+
+        /*A group is bounded by its own shapes and its child groups, which come right after it*/
+        SVGBounds bounds = shapeListBounds(group->rectangles, group->circles, group->paths);
+        bounds = unionBounds(bounds, computeGroupBounds(cache, group->groups, position));
+        cache->groups[index] = bounds;
+
+        int slot = groupSlot(cache, group);
+        while (cache->slots[slot] != 0) {
+            slot = (slot + 1) & (cache->numSlots - 1);
+        }
+        cache->slots[slot] = index + 1;
+
+        total = unionBounds(total, bounds);
+    }
+
+    return total;
+}
+
+/**
+ * @brief Returns the views of the struct with up to date bounds, computing them if needed
+ * @param img
+ * @return SVGViews* or NULL
+ */
+static SVGViews* getViewsWithBounds(const SVG* img) {
+    SVGViews* views = getSVGViews(img);
+    if (views == NULL) {
+        return NULL;
+    }
+
+    const SVGView* groupView = &views->groups;
+    if (views->hasBounds && views->boundsGeneration == views->generation) {
+        return views;
+    }
+
+    SVGBoundsCache* cache = &views->bounds;
+    int numGroups = groupView->length;
+
+    if (numGroups > cache->capacity) {
+        SVGBounds* groups = realloc(cache->groups, sizeof(SVGBounds) * numGroups);
+        if (groups == NULL) {
+            return NULL;
+        }
+        cache->groups = groups;
+        cache->capacity = numGroups;
+    }
+
+    /*Keep the group table at most half full*/
+    int numSlots = 16;
+    while (numSlots < numGroups * 2) {
+        numSlots *= 2;
+    }
+    if (numSlots != cache->numSlots) {
+        int* slots = realloc(cache->slots, sizeof(int) * numSlots);
+        if (slots == NULL) {
+            return NULL;
+        }
+        cache->slots = slots;
+        cache->numSlots = numSlots;
+    }
+    memset(cache->slots, 0, sizeof(int) * cache->numSlots);
+
+    int position = 0;
+    SVGBounds groupBounds = computeGroupBounds(cache, img->groups, &position);
+    cache->image = unionBounds(shapeListBounds(img->rectangles, img->circles, img->paths), groupBounds);
+
+    views->hasBounds = true;
+    views->boundsGeneration = views->generation;
+
+    return views;
+}
+
+/**
+ * @brief Returns the bounds of everything in a group, including nested groups
+ * @param img
+ * @param group
+ * @return SVGBounds
+ */
+SVGBounds getGroupBounds(const SVG* img, const Group* group) {
+    if (group == NULL) {
+        return emptyBounds();
+    }
+
+    SVGViews* views = getViewsWithBounds(img);
+    if (views == NULL) {
+        return emptyBounds();
+    }
+
+    const SVGBoundsCache* cache = &views->bounds;
+    int slot = groupSlot(cache, group);
+
+    while (cache->slots[slot] != 0) {
+        int index = cache->slots[slot] - 1;
+
+        if (views->groups.elements[index] == group) {
+            return cache->groups[index];
+        }
+        slot = (slot + 1) & (cache->numSlots - 1);
+    }
+
+    return emptyBounds();
+}
+
+/**
+ * @brief Returns the bounds of every shape in the struct
+ * @param img
+ * @return SVGBounds
+ */
+SVGBounds getSVGBounds(const SVG* img) {
+    SVGViews* views = getViewsWithBounds(img);
+
+    return (views != NULL) ? views->bounds.image : emptyBounds();
+}
+
+/**
+ * @brief Returns bounds as a JSON string
+ * @param bounds
+ * @return char*
+ */
+char* boundsToJSON(SVGBounds bounds) {
+    char* jsonBounds;
+
+    if (bounds.empty) {
+        jsonBounds = malloc(sizeof(char) * (strlen("{}") + 1));
+        strcpy(jsonBounds, "{}");
+        return jsonBounds;
+    }
+
+    int length = snprintf(NULL, 0, "{\"x\":%.2f,\"y\":%.2f,\"w\":%.2f,\"h\":%.2f}", bounds.minX, bounds.minY, bounds.maxX - bounds.minX, bounds.maxY - bounds.minY);
+    jsonBounds = malloc(sizeof(char) * (length + 1));
+    sprintf(jsonBounds, "{\"x\":%.2f,\"y\":%.2f,\"w\":%.2f,\"h\":%.2f}", bounds.minX, bounds.minY, bounds.maxX - bounds.minX, bounds.maxY - bounds.minY);
+
+    return jsonBounds;
+}
+
+/**
+ * @brief Returns the bounds of a valid SVG file as JSON
+ * @param fileName
+ * @param schemaFile
+ * @return char*
+ */
+char* validImageBoundsToJSON(const char* fileName, const char* schemaFile) {
+    if (fileName == NULL || schemaFile == NULL) {
+        return NULL;
+    }
+
+    const SVGSchema* schema = getCachedSVGSchema(schemaFile);
+    if (schema == NULL) {
+        return NULL;
+    }
+
+    /*The struct is thrown away right after, so it is built in an arena*/
+    SVG* img = createValidArenaSVG(fileName, schema);
+    if (img == NULL) {
+        return NULL;
+    }
+
+    char* jsonBounds = boundsToJSON(getSVGBounds(img));
+    deleteSVG(img);
+
+    return jsonBounds;
+}
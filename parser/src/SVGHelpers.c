@@ -10,15 +10,504 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
 
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 
 #include "SVGParser.h"
+#include "SVGHelpers.h"
+#include "SVGSchema.h"
+#include "SVGArena.h"
+#include "SVGStream.h"
+#include "SVGViews.h"
+#include "SVGIntern.h"
+#include "SVGPath.h"
 #include "LinkedListAPI.h"
 
 /********************************* A1 Functions *************************************/
 
+/*Powers of ten that are exact as doubles*/
+static const double exactPowersOf10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static bool isLengthSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+static bool isLengthDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static bool isUnitLetter(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+/**
+ * @brief Reads a number such as "2.5", "-.5" or "1e-3" from the start of str
+ * @param str 
+ * @param value 
+ * @return const char* just past the number, or NULL if str does not start with one
+ */
+const char *parseNumber(const char *str, double *value) {
+    const char *cur = str;
+    unsigned long long mantissa = 0;
+    int numDigits = 0;
+    int exponent = 0;
+    bool negative = false;
+    bool found = false;
+    bool truncated = false;
+
+    if (*cur == '+' || *cur == '-') {
+        negative = (*cur == '-');
+        cur++;
+    }
+
+    /*Up to 19 significant digits fit in the mantissa, the rest only move the exponent*/
+    for (; isLengthDigit(*cur); cur++) {
+        found = true;
+        if (numDigits < 19) {
+            mantissa = mantissa * 10 + (unsigned long long)(*cur - '0');
+            numDigits += (mantissa != 0);
+        } else {
+            exponent++;
+            truncated |= (*cur != '0');
+        }
+    }
+    if (*cur == '.') {
+        for (cur++; isLengthDigit(*cur); cur++) {
+            found = true;
+            if (numDigits < 19) {
+                mantissa = mantissa * 10 + (unsigned long long)(*cur - '0');
+                numDigits += (mantissa != 0);
+                exponent--;
+            } else {
+                truncated |= (*cur != '0');
+            }
+        }
+    }
+    if (!found) {
+        return NULL;
+    }
+
+    /*An 'e' is only an exponent if digits follow it - "1em" is 1 with units "em"*/
+    if (*cur == 'e' || *cur == 'E') {
+        const char *exp = cur + 1;
+        bool negativeExp = false;
+
+        if (*exp == '+' || *exp == '-') {
+            negativeExp = (*exp == '-');
+            exp++;
+        }
+        if (isLengthDigit(*exp)) {
+            int expValue = 0;
+
+            for (; isLengthDigit(*exp); exp++) {
+                if (expValue < 100000) {
+                    expValue = expValue * 10 + (*exp - '0');
+                }
+            }
+            exponent += negativeExp ? -expValue : expValue;
+            cur = exp;
+        }
+    }
+
+    double result;
+    if (mantissa == 0) {
+        result = 0;
+    } else if (!truncated && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+        /*Both operands are exact, so a single multiply or divide is correctly rounded*/
+        result = (exponent < 0) ? (double)mantissa / exactPowersOf10[-exponent] : (double)mantissa * exactPowersOf10[exponent];
+    } else {
+        result = (double)((long double)mantissa * powl(10.0L, exponent));
+    }
+
+    *value = negative ? -result : result;
+    return cur;
+}
+
+/**
+ * @brief Reads the number of a length and finds its units, without interning them
+ * @param str 
+ * @param value - may be NULL
+ * @param found - set to whether str started with a number
+ * @param unitsLength - set to the number of unit letters
+ * @return const char* - start of the units
+ */
+static const char *scanLength(const char *str, float *value, bool *found, size_t *unitsLength) {
+    const char *cur = str;
+    while (isLengthSpace(*cur)) {
+        cur++;
+    }
+
+    double number = 0;
+    const char *end = parseNumber(cur, &number);
+    *found = (end != NULL);
+
+    if (*found) {
+        cur = end;
+    } else {
+        /*A lone sign or '.' reads as 0, and is skipped like a number would be*/
+        cur += (*cur == '+' || *cur == '-');
+        cur += (*cur == '.');
+    }
+
+    if (value != NULL) {
+        *value = (float)number;
+    }
+
+    /*Units are the letters right after the number, e.g. the "cm" in "2.5cm" or "2.5 cm"*/
+    while (isLengthSpace(*cur)) {
+        cur++;
+    }
+
+    const char *start = cur;
+    while (isUnitLetter(*cur)) {
+        cur++;
+    }
+    *unitsLength = (size_t)(cur - start);
+
+    return start;
+}
+
+/**
+ * @brief Parses a length such as "2.5cm", "-.5" or "1e-3px" in a single pass
+ * @param str 
+ * @param value 
+ * @param units 
+ * @return true if str started with a number
+ */
+bool parseLength(const char *str, float *value, const char **units) {
+    if (str == NULL) {
+        return false;
+    }
+
+    bool found;
+    size_t unitsLength;
+    const char *start = scanLength(str, value, &found, &unitsLength);
+
+    if (units != NULL) {
+        *units = internUnits(start, unitsLength);
+    }
+
+    return found;
+}
+
+/**
+ * @brief Points the units of a shape at the first length characters of units
+ * @param arena 
+ * @param slot 
+ * @param units 
+ * @param length 
+ * @return true 
+ * @return false 
+ */
+bool setShapeUnits(SVGArena *arena, const char **slot, const char *units, size_t length) {
+    const char *kept = internUnits(units, length);
+
+    /*Units the table cannot take get a copy of their own, so parsing never depends on
+    what the process has parsed before*/
+    if (kept == NULL) {
+        if (arena != NULL) {
+            char *copy = arenaAlloc(arena, length + 1);
+            if (copy != NULL) {
+                memcpy(copy, units, length);
+                copy[length] = '\0';
+            }
+            kept = copy;
+        } else {
+            kept = copyOwnedSpan(units, length);
+        }
+
+        if (kept == NULL) {
+            return false;
+        }
+    }
+
+    if (*slot != kept) {
+        releaseOwnedString(*slot);
+        *slot = kept;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the text content of an xmlAttr, or "" if it has none
+ * @param attr 
+ * @return char* 
+ */
+static char *attrContent(xmlAttr *attr) {
+    xmlNode *value = attr->children;
+
+    if (value == NULL || value->content == NULL) {
+        return "";
+    }
+    return (char *)(value->content);
+}
+
+/**
+ * @brief Allocates memory from the arena, or from the heap if there is no arena
+ * @param arena 
+ * @param size 
+ * @return void* 
+ */
+static void *svgAlloc(SVGArena *arena, size_t size) {
+    return (arena != NULL) ? arenaAlloc(arena, size) : malloc(size);
+}
+
+/**
+ * @brief Allocates an Attribute with enough room for its value.  The attribute shares
+ * the interned name, or gets its own copy of name if interning failed
+ * @param arena 
+ * @param interned - internString(name), may be NULL
+ * @param name 
+ * @param value 
+ * @return Attribute* 
+ */
+static Attribute *newAttribute(SVGArena *arena, const char *interned, const char *name, const char *value) {
+    /*Value is a flexible array member, so it is allocated along with the struct*/
+    Attribute *attr = svgAlloc(arena, sizeof(Attribute) + sizeof(char) * (strlen(value) + 1));
+    if (attr == NULL) {
+        return NULL;
+    }
+
+    /*Names are shared through the intern table, and only copied if it is full*/
+    if (interned != NULL) {
+        attr->name = (char *)interned;
+    } else {
+        attr->name = svgAlloc(arena, sizeof(char) * (strlen(name) + 1));
+        strcpy(attr->name, name);
+    }
+    strcpy(attr->value, value);
+
+    return attr;
+}
+
+/**
+ * @brief Creates an otherAttributes list, taking its memory from the arena if there is one
+ * @param arena 
+ * @return List* 
+ */
+static List *createAttributeList(SVGArena *arena) {
+    return initializeListWithAllocator(&attributeToString, &deleteAttribute, &compareAttributes, (arena != NULL) ? &arena->listAllocator : NULL);
+}
+
+/**
+ * @brief Allocates an empty Rectangle
+ * @param arena 
+ * @return Rectangle* 
+ */
+Rectangle *createRectangle(SVGArena *arena) {
+    Rectangle *rect = svgAlloc(arena, sizeof(Rectangle));
+    /*If NULL, return NULL*/
+    if (rect == NULL) {
+        return NULL;
+    }
+
+    rect->x = 0;
+    rect->y = 0;
+    rect->width = 0;
+    rect->height = 0;
+    rect->units = SVG_UNITS_NONE;
+    rect->otherAttributes = createAttributeList(arena);
+
+    return rect;
+}
+
+/**
+ * @brief Allocates an empty Circle
+ * @param arena 
+ * @return Circle* 
+ */
+Circle *createCircle(SVGArena *arena) {
+    Circle *circle = svgAlloc(arena, sizeof(Circle));
+    /*If NULL, return NULL*/
+    if (circle == NULL) {
+        return NULL;
+    }
+
+    circle->cx = 0;
+    circle->cy = 0;
+    circle->r = 0;
+    circle->units = SVG_UNITS_NONE;
+    circle->otherAttributes = createAttributeList(arena);
+
+    return circle;
+}
+
+/*Frees the compiled commands of an arena path when its arena is freed*/
+static void releasePathCommands(void *path) {
+    invalidatePathCommands((Path *)path);
+}
+
+/**
+ * @brief Allocates a Path with enough room for its data
+ * @param arena 
+ * @param data 
+ * @return Path* 
+ */
+Path *createPath(SVGArena *arena, const char *data) {
+    if (data == NULL) {
+        return NULL;
+    }
+
+    Path *path = svgAlloc(arena, sizeof(Path) + sizeof(char) * (strlen(data) + 1));
+    if (path == NULL) {
+        return NULL;
+    }
+
+    strcpy(path->data, data);
+    path->otherAttributes = createAttributeList(arena);
+    path->commands = NULL;
+
+    /*Compiled commands are on the heap even for arena paths (see getPathCommands)*/
+    arenaAdopt(arena, path, &releasePathCommands);
+
+    return path;
+}
+
+/**
+ * @brief Allocates an empty Group
+ * @param arena 
+ * @return Group* 
+ */
+Group *createGroup(SVGArena *arena) {
+    Group *group = svgAlloc(arena, sizeof(Group));
+    if (group == NULL) {
+        return NULL;
+    }
+
+    ListAllocator *allocator = (arena != NULL) ? &arena->listAllocator : NULL;
+    group->rectangles = initializeListWithAllocator(&rectangleToString, &deleteRectangle, &compareRectangles, allocator);
+    group->circles = initializeListWithAllocator(&circleToString, &deleteCircle, &compareCircles, allocator);
+    group->paths = initializeListWithAllocator(&pathToString, &deletePath, &comparePaths, allocator);
+    group->groups = initializeListWithAllocator(&groupToString, &deleteGroup, &compareGroups, allocator);
+    group->otherAttributes = createAttributeList(arena);
+
+    return group;
+}
+
+/**
+ * @brief Parses a coordinate or size of a shape, along with its units
+ * @param arena 
+ * @param cont 
+ * @param value 
+ * @param units 
+ * @return true
+ * @return false if memory ran out
+ */
+static bool parseShapeLength(SVGArena *arena, const char *cont, float *value, const char **units) {
+    bool found;
+    size_t unitsLength;
+    const char *start = scanLength(cont, value, &found, &unitsLength);
+
+    return setShapeUnits(arena, units, start, unitsLength);
+}
+
+/**
+ * @brief Adds an attribute the parser does not handle itself to an otherAttributes list
+ * @param arena 
+ * @param list 
+ * @param interned 
+ * @param name 
+ * @param value 
+ * @return true
+ * @return false if memory ran out
+ */
+static bool addOtherAttribute(SVGArena *arena, List *list, const char *interned, const char *name, const char *value) {
+    Attribute *attr = newAttribute(arena, interned, name, value);
+    if (attr == NULL) {
+        return false;
+    }
+
+    insertBack(list, (void*)attr);
+    return true;
+}
+
+/**
+ * @brief Applies one XML attribute of a rect element to a Rectangle
+ * @param arena 
+ * @param rect 
+ * @param attrName 
+ * @param cont 
+ * @return true
+ * @return false
+ */
+bool addRectAttribute(SVGArena *arena, Rectangle *rect, const char *attrName, const char *cont) {
+    if (rect == NULL || attrName == NULL || cont == NULL) {
+        return false;
+    }
+
+    /*Known names are interned, so they can be told apart by pointer*/
+    const char *name = internString(attrName);
+
+    /*When x, y, width or height is found, put the value inside the object*/
+    if (name == SVG_NAME_X) {
+        return parseShapeLength(arena, cont, &rect->x, &rect->units);
+    } else if (name == SVG_NAME_Y) {
+        return parseShapeLength(arena, cont, &rect->y, &rect->units);
+    } else if (name == SVG_NAME_WIDTH) {
+        return parseShapeLength(arena, cont, &rect->width, &rect->units);
+    } else if (name == SVG_NAME_HEIGHT) {
+        return parseShapeLength(arena, cont, &rect->height, &rect->units);
+    }
+
+    /*If anything else, puts into other attributes*/
+    return addOtherAttribute(arena, rect->otherAttributes, name, attrName, cont);
+}
+
+/**
+ * @brief Applies one XML attribute of a circle element to a Circle
+ * @param arena 
+ * @param circle 
+ * @param attrName 
+ * @param cont 
+ * @return true
+ * @return false
+ */
+bool addCircleAttribute(SVGArena *arena, Circle *circle, const char *attrName, const char *cont) {
+    if (circle == NULL || attrName == NULL || cont == NULL) {
+        return false;
+    }
+
+    /*Known names are interned, so they can be told apart by pointer*/
+    const char *name = internString(attrName);
+
+    /*When cx, cy or r is found, put the value inside the object*/
+    if (name == SVG_NAME_CX) {
+        return parseShapeLength(arena, cont, &circle->cx, &circle->units);
+    } else if (name == SVG_NAME_CY) {
+        return parseShapeLength(arena, cont, &circle->cy, &circle->units);
+    } else if (name == SVG_NAME_R) {
+        return parseShapeLength(arena, cont, &circle->r, &circle->units);
+    }
+
+    /*If anything else, puts into other attributes*/
+    return addOtherAttribute(arena, circle->otherAttributes, name, attrName, cont);
+}
+
+/**
+ * @brief Applies one XML attribute of a path element to a Path.  The 'd' attribute
+ * is consumed by createPath(), so it is skipped here
+ * @param arena 
+ * @param path 
+ * @param attrName 
+ * @param cont 
+ * @return true
+ * @return false
+ */
+bool addPathAttribute(SVGArena *arena, Path *path, const char *attrName, const char *cont) {
+    if (path == NULL || attrName == NULL || cont == NULL) {
+        return false;
+    }
+
+    const char *name = internString(attrName);
+
+    return name == SVG_NAME_D || addOtherAttribute(arena, path->otherAttributes, name, attrName, cont);
+}
+
 /**
  * @brief Parses all data that is required for Path object 
  * @param tmp_Node 
@@ -28,63 +517,27 @@ Path *parsePathData(xmlNode *tmp_Node) {
     if (tmp_Node == NULL) {
         return NULL;
     }
-    
-    Path *path;
+
     xmlAttr *attr;
-    int length;
-    
+    char *data = NULL;
+
+    /*Path data is stored inline, so 'd' has to be found first*/
     for (attr = tmp_Node->properties; attr != NULL; attr = attr->next) {
-        char *attrName = (char *)attr->name;
-        xmlNode *value = attr->children;
-        char *cont = (char *)(value->content);
-
-        /*Does if-statements based on attributes*/
-        if (strcmp(attrName, "d") == 0) {
-            if(cont != NULL) {
-                length = strlen((char*)cont);
-                char tmpStr2[length];
-                path = malloc(sizeof(Path) + sizeof(char) * (length + 1));
-                
-                sprintf(tmpStr2, cont);
-                strcpy(path->data, tmpStr2);
-            }
+        if (strcmp((char *)attr->name, "d") == 0) {
+            data = attrContent(attr);
         }
     }
-    
-    path->otherAttributes = initializeList(&attributeToString, &deleteAttribute, &compareAttributes);
+
+    Path *path = createPath(NULL, data);
+    if (path == NULL) {
+        return NULL;
+    }
 
     /*If anything else, puts into other attributes*/
-    attr = NULL;
     for (attr = tmp_Node->properties; attr != NULL; attr = attr->next) {
-        char *attrName = (char *)attr->name;
-        xmlNode *value = attr->children;
-        char *cont = (char *)(value->content);
-
-        if (strcmp(attrName, "d") != 0) {
-            if (path == NULL) {
-                return NULL;
-            }
-            
-            /*Goes to this section if 'path' has any other attributes*/
-            char tmpStr[256];
-            int memLength;
-            Attribute *pathOtherAttr = malloc(sizeof(Attribute));
-
-            /*For attribute name*/
-            sprintf(tmpStr, attrName);
-            memLength = strlen(tmpStr) + 2;
-            pathOtherAttr->name = (char*)malloc(sizeof(char) * memLength);
-            
-            strcpy(pathOtherAttr->name, (char*)tmpStr);
-            /*For attribute value*/
-            sprintf(tmpStr, cont);
-            strcpy(pathOtherAttr->value, tmpStr);
-            //memLength = strlen(tmpStr) + 2;
-            //pathOtherAttr->value = (char *)malloc(sizeof(char) * memLength);
-            /*Prints out other attributes*/
-            //printf("Name: %s Value: %s\n", pathOtherAttr->name, pathOtherAttr->value);
-            
-            insertBack(path->otherAttributes, (void*)pathOtherAttr);
+        if (!addPathAttribute(NULL, path, (char *)attr->name, attrContent(attr))) {
+            deletePath(path);
+            return NULL;
         }
     }
 
@@ -102,12 +555,7 @@ Circle *parseCircleData(xmlNode *tmp_Node) {
         return NULL;
     }
 
-    Circle *circle = malloc(sizeof(Circle));
-
-    circle->cx = 0;
-    circle->cy = 0;
-    circle->r = 0;
-    circle->otherAttributes = initializeList(&attributeToString, &deleteAttribute, &compareAttributes);
+    Circle *circle = createCircle(NULL);
     /*If NULL, return NULL*/
     if(circle == NULL) {
         return NULL;
@@ -115,85 +563,9 @@ Circle *parseCircleData(xmlNode *tmp_Node) {
 
     xmlAttr *attr;
     for (attr = tmp_Node->properties; attr != NULL; attr = attr->next) {
-        char *attrName = (char *)attr->name;
-        xmlNode *value = attr->children;
-        char *cont = (char *)(value->content);
-        /*When 'cx' is found, put the value inside the object*/
-        if (strcmp(attrName, "cx") == 0) {
-            circle->cx = atof(cont);
-            
-            char s2[256];
-            int i = 0;
-            int j = 0;
-
-            for(i = 0, j = 0; cont[i] != '\0'; i++) {
-                if((cont[i] >= 'A' && cont[i] <= 'Z') || (cont[i] >= 'a' && cont[i] <= 'z')) {
-                    s2[j] = cont[i];
-                    j++;
-                }
-            }
-            s2[j]='\0';
-
-            // char *unit = parseUnits(cont);
-            // int length = strlen(unit);
-            //strncpy(circle->units, unit, (length + 1));
-            int length = strlen(s2);
-            strncpy(circle->units, s2, (length + 1));
-        /*When 'cy' is found, put the value inside the object*/
-        } else if (strcmp(attrName, "cy") == 0) {
-            circle->cy = atof(cont);
-
-            char s2[256];
-            int i = 0;
-            int j = 0;
-
-            for(i = 0, j = 0; cont[i] != '\0'; i++) {
-                if((cont[i] >= 'A' && cont[i] <= 'Z') || (cont[i] >= 'a' && cont[i] <= 'z')) {
-                    s2[j] = cont[i];
-                    j++;
-                }
-            }
-            s2[j]='\0';
-
-            int length = strlen(s2);
-            strncpy(circle->units, s2, (length + 1));
-        /*When 'r' is found, put the value inside the object*/
-        } else if (strcmp(attrName, "r") == 0) {
-            circle->r = atof(cont);
-
-            char s2[256];
-            int i = 0;
-            int j = 0;
-
-            for(i = 0, j = 0; cont[i] != '\0'; i++) {
-                if((cont[i] >= 'A' && cont[i] <= 'Z') || (cont[i] >= 'a' && cont[i] <= 'z')) {
-                    s2[j] = cont[i];
-                    j++;
-                }
-            }
-            s2[j]='\0';
-
-            int length = strlen(s2);
-            strncpy(circle->units, s2, (length + 1));
-        /*If anything else, puts into other attributes*/
-        } else {
-            char tmpStr[256];
-            int memLength;
-            Attribute *circleOtherAttr = malloc(sizeof(Attribute));
-
-            /*For attribute name*/
-            sprintf(tmpStr, attrName);
-            memLength = strlen(tmpStr) + 2;
-            circleOtherAttr->name = (char*)malloc(sizeof(char) * memLength);
-            strcpy(circleOtherAttr->name, (char*)tmpStr);
-            /*For attribute value*/
-            sprintf(tmpStr, cont);
-            strcpy(circleOtherAttr->value, tmpStr);
-            //memLength = strlen(tmpStr) + 2;
-            //circleOtherAttr->value = (char *)malloc(sizeof(char) * memLength);
-            /*Prints out other attributes*/
-            //printf("Name: %s Value: %s\n", circleOtherAttr->name, circleOtherAttr->value);
-            insertBack(circle->otherAttributes, (void*)circleOtherAttr);
+        if (!addCircleAttribute(NULL, circle, (char *)attr->name, attrContent(attr))) {
+            deleteCircle(circle);
+            return NULL;
         }
     }
 
@@ -211,13 +583,7 @@ Rectangle *parseRectData(xmlNode *tmp_Node) {
         return NULL;
     }
     
-    Rectangle *rect = malloc(sizeof(Rectangle));
-
-    rect->x = 0;
-    rect->y = 0;
-    rect->width = 0;
-    rect->height = 0;
-    rect->otherAttributes = initializeList(&attributeToString, &deleteAttribute, &compareAttributes);
+    Rectangle *rect = createRectangle(NULL);
     /*If NULL, return NULL*/
     if (rect == NULL) {
         return NULL;
@@ -225,98 +591,9 @@ Rectangle *parseRectData(xmlNode *tmp_Node) {
 
     xmlAttr *attr;
     for (attr = tmp_Node->properties; attr != NULL; attr = attr->next) {
-        char *attrName = (char *)attr->name;
-        xmlNode *value = attr->children;
-        char *cont = (char *)(value->content);
-
-        /*When 'x'' is found, put the value inside the object*/
-        if (strcmp(attrName, "x") == 0) {
-            rect->x = atof(cont);
-            char s2[256];
-            int i = 0;
-            int j = 0;
-
-            for(i = 0, j = 0; cont[i] != '\0'; i++) {
-                if((cont[i] >= 'A' && cont[i] <= 'Z') || (cont[i] >= 'a' && cont[i] <= 'z')) {
-                    s2[j] = cont[i];
-                    j++;
-                }
-            }
-            s2[j]='\0';
-
-            int length = strlen(s2);
-            strncpy(rect->units, s2, (length + 1));
-            /*When 'y'' is found, put the value inside the object*/
-        } else if (strcmp(attrName, "y") == 0) {
-            rect->y = atof(cont);
-
-            char s2[256];
-            int i = 0;
-            int j = 0;
-
-            for(i = 0, j = 0; cont[i] != '\0'; i++) {
-                if((cont[i] >= 'A' && cont[i] <= 'Z') || (cont[i] >= 'a' && cont[i] <= 'z')) {
-                    s2[j] = cont[i];
-                    j++;
-                }
-            }
-            s2[j]='\0';
-
-            int length = strlen(s2);
-            strncpy(rect->units, s2, (length + 1));
-            /*When width is found, put the value inside the object*/
-        } else if (strcmp(attrName, "width") == 0) {
-            rect->width = atof(cont);
-
-            char s2[256];
-            int i = 0;
-            int j = 0;
-
-            for(i = 0, j = 0; cont[i] != '\0'; i++) {
-                if((cont[i] >= 'A' && cont[i] <= 'Z') || (cont[i] >= 'a' && cont[i] <= 'z')) {
-                    s2[j] = cont[i];
-                    j++;
-                }
-            }
-            s2[j]='\0';
-
-            int length = strlen(s2);
-            strncpy(rect->units, s2, (length + 1));
-            /*When height is found, put the value inside the object*/
-        } else if (strcmp(attrName, "height") == 0) {
-            rect->height = atof(cont);
-
-            char s2[256];
-            int i = 0;
-            int j = 0;
-
-            for(i = 0, j = 0; cont[i] != '\0'; i++) {
-                if((cont[i] >= 'A' && cont[i] <= 'Z') || (cont[i] >= 'a' && cont[i] <= 'z')) {
-                    s2[j] = cont[i];
-                    j++;
-                }
-            }
-            s2[j]='\0';
-
-            int length = strlen(s2);
-            strncpy(rect->units, s2, (length + 1));
-            /*If anything else, puts into other attributes*/
-        } else {
-            char tmpStr[256];
-            int memLength;
-            Attribute *rectOtherAttr = malloc(sizeof(Attribute));
-
-            /*For attribute name*/
-            sprintf(tmpStr, attrName);
-            memLength = strlen(tmpStr) + 2;
-            rectOtherAttr->name = (char*)malloc(sizeof(char) * memLength);
-            strcpy(rectOtherAttr->name, (char*)tmpStr);
-            /*For attribute value*/
-            sprintf(tmpStr, cont);
-            strcpy(rectOtherAttr->value, tmpStr);
-            /*Prints out other attributes*/
-            //printf("Name: %s Value: %s\n", rectOtherAttr->name, rectOtherAttr->value);
-            insertBack(rect->otherAttributes, (void*)rectOtherAttr);
+        if (!addRectAttribute(NULL, rect, (char *)attr->name, attrContent(attr))) {
+            deleteRectangle(rect);
+            return NULL;
         }
     }
 
@@ -334,39 +611,15 @@ Group *parseGroupData(xmlNode *tmp_Node) {
     }
 
     /*Initialize Group List to be returned*/
-    Group *group = malloc(sizeof(Group));
-    group->rectangles = initializeList(&rectangleToString, &deleteRectangle, &compareRectangles);
-    group->circles = initializeList(&circleToString, &deleteCircle, &compareCircles);
-    group->paths = initializeList(&pathToString, &deletePath, &comparePaths);
-    group->groups = initializeList(&groupToString, &deleteGroup, &compareGroups);
-    group->otherAttributes = initializeList(&attributeToString, &deleteAttribute, &compareAttributes);
-
-    /*If NULL, return NULL*/
-    if (tmp_Node == NULL) {
-        return group;
+    Group *group = createGroup(NULL);
+    if (group == NULL) {
+        return NULL;
     }
 
     /*Parses all data for attributes of the Group object*/
     xmlAttr *attr;
     for (attr = tmp_Node->properties; attr != NULL; attr = attr->next) {
-        char *attrName = (char *)attr->name;
-        xmlNode *value = attr->children;
-        char *cont = (char *)(value->content); 
-    
-        char tmpStr[256];
-        int memLength;
-        Attribute *groupOtherAttr = malloc(sizeof(Attribute));
-
-        /*For attribute name*/
-        sprintf(tmpStr, attrName);
-        memLength = strlen(tmpStr) + 2;
-        groupOtherAttr->name = (char*)malloc(sizeof(char) * memLength);
-        strcpy(groupOtherAttr->name, (char*)tmpStr);
-        /*For attribute value*/
-        sprintf(tmpStr, cont);
-        strcpy(groupOtherAttr->value, tmpStr);
-        //printf("Name: %s Value: %s\n", groupOtherAttr->name, groupOtherAttr->value);
-        insertBack(group->otherAttributes, (void*)groupOtherAttr);
+        insertBack(group->otherAttributes, (void*)createAttribute(NULL, (char *)attr->name, attrContent(attr)));
     }
 
     /*Loops through the Group node find: Rect, Circles, Paths & Groups*/
@@ -379,7 +632,6 @@ Group *parseGroupData(xmlNode *tmp_Node) {
                 Rectangle *rect = parseRectData(cur_node);
                 /*Rectangle object must not be NULL. It may be empty*/
                 if (rect == NULL) {
-                    //deleteRectangle(rect);
                     deleteGroup(group);
                     return NULL;
                 }
@@ -389,7 +641,6 @@ Group *parseGroupData(xmlNode *tmp_Node) {
                 Circle *circle = parseCircleData(cur_node);
                 /*Circle object must not be NULL. It may be empty*/
                 if (circle == NULL) {
-                    //deleteCircle(circle);
                     deleteGroup(group);
                     return NULL;
                 }
@@ -399,20 +650,19 @@ Group *parseGroupData(xmlNode *tmp_Node) {
                 Path *path = parsePathData(cur_node);
                 /*Path object must not be NULL. It may be empty*/
                 if (path == NULL) {
-                    //deletePath(path);
                     deleteGroup(group);
                     return NULL;
                 }
                 insertBack(group->paths, (void*)path);
             } else if (strcmp(nodeName, "g") == 0) {
-                Group *group = parseGroupData(cur_node);
+                Group *childGroup = parseGroupData(cur_node);
                 /*Group object must not be NULL. It may be empty*/
-                if (group == NULL) {
+                if (childGroup == NULL) {
                     deleteGroup(group);
                     return NULL;
                 }
                 
-                insertBack(group->groups, (void*)group);
+                insertBack(group->groups, (void*)childGroup);
             }
         }
     }
@@ -439,6 +689,295 @@ void parseGroupWithinGroup(List* list, Group* group) {
     }
 }
 
+/**
+ * @brief Allocates an Attribute with enough room for its value
+ * @param arena
+ * @param name
+ * @param value
+ * @return Attribute*
+ */
+Attribute *createAttribute(SVGArena *arena, const char *name, const char *value) {
+    if (name == NULL) {
+        return NULL;
+    }
+    if (value == NULL) {
+        value = "";
+    }
+
+    return newAttribute(arena, internString(name), name, value);
+}
+
+/**
+ * @brief Allocates an SVG object with default values and empty lists.  If arena is not
+ * NULL, the SVG takes ownership of it and every object of the SVG is allocated from it
+ * @param arena
+ * @return SVG*
+ */
+SVG *createSVGObject(SVGArena *arena) {
+    SVG *SVGObject = svgAlloc(arena, sizeof(SVG));
+    if (SVGObject == NULL) {
+        return NULL;
+    }
+    SVGObject->arena = arena;
+    SVGObject->views = NULL;
+    SVGObject->generation = 0;
+    /*Builders fill the lists directly, so the totals are computed once they are done*/
+    SVGObject->stats.valid = false;
+    SVGObject->idGeneration = 0;
+    SVGObject->self = SVGObject;
+
+    /*Assign namespace, title, and desc with default values - In case they are empty*/
+    strcpy(SVGObject->namespace, "empty-namespace");
+    strcpy(SVGObject->title, "");
+    strcpy(SVGObject->description, "");
+
+    /*Initializing Lists for the main SVG Object file*/
+    ListAllocator *allocator = (arena != NULL) ? &arena->listAllocator : NULL;
+    SVGObject->rectangles = initializeListWithAllocator(&rectangleToString, &deleteRectangle, &compareRectangles, allocator);
+    SVGObject->circles = initializeListWithAllocator(&circleToString, &deleteCircle, &compareCircles, allocator);
+    SVGObject->paths = initializeListWithAllocator(&pathToString, &deletePath, &comparePaths, allocator);
+    SVGObject->groups = initializeListWithAllocator(&groupToString, &deleteGroup, &compareGroups, allocator);
+    SVGObject->otherAttributes = createAttributeList(arena);
+
+    return SVGObject;
+}
+
+/**
+ * @brief Tells whether img was created by the library
+ * @param img 
+ * @return true 
+ * @return false 
+ */
+bool isLibrarySVG(const SVG *img) {
+    return img != NULL && img->self == img;
+}
+
+/**
+ * @brief Builds an SVG object from the root <svg> node of a parsed document
+ * @param root_element
+ * @return SVG*
+ */
+SVG *parseSVGRoot(xmlNode *root_element) {
+    if (root_element == NULL) {
+        return NULL;
+    }
+
+    /*Main SVG Struct Object that will be returned*/
+    SVG *SVGObject = createSVGObject(NULL);
+    if (SVGObject == NULL) {
+        return NULL;
+    }
+
+    /*Receiving the other attributes for the SVG object*/
+    xmlAttr *attr;
+    for (attr = root_element->properties; attr != NULL; attr = attr->next) {
+        /*Insert into main SVG Object list*/
+        insertBack(SVGObject->otherAttributes, (void*)createAttribute(NULL, (char *)attr->name, attrContent(attr)));
+    }
+
+    /*Applying namespace onto the SVG Object*/
+    xmlNs *nameSpace = root_element->ns;
+    if (nameSpace == NULL || nameSpace->href == NULL) {
+        deleteSVG(SVGObject);
+        return NULL;
+    }
+    strncpy(SVGObject->namespace, (char*)(nameSpace->href), 255);
+    SVGObject->namespace[255] = '\0';
+
+    /*Loops through the SVG file to find: Rect, Circles, Paths & Groups*/
+    xmlNode *cur_node = NULL;
+    for (cur_node = root_element->children; cur_node != NULL; cur_node = cur_node->next) {
+        if (cur_node->type == XML_ELEMENT_NODE) {
+            char *nodeName = (char *)cur_node->name;
+
+            if (strcmp(nodeName, "title") == 0) {
+                if (cur_node->children != NULL && cur_node->children->content != NULL) {
+                    strncpy(SVGObject->title, (char*)cur_node->children->content, 255);
+                    SVGObject->title[255] = '\0';
+                }
+            } else if (strcmp(nodeName, "desc") == 0) {
+                if (cur_node->children != NULL && cur_node->children->content != NULL) {
+                    strncpy(SVGObject->description, (char*)cur_node->children->content, 255);
+                    SVGObject->description[255] = '\0';
+                }
+            } else if (strcmp(nodeName, "rect") == 0) {
+                Rectangle *rect = parseRectData(cur_node);
+                /*Rectangle object must not be NULL. It may be empty*/
+                if (rect == NULL) {
+                    deleteSVG(SVGObject);
+                    return NULL;
+                }
+                /*Insert into main list*/
+                insertBack(SVGObject->rectangles, (void*)rect);
+            } else if (strcmp(nodeName, "circle") == 0) {
+                Circle *circle = parseCircleData(cur_node);
+                /*Circle object must not be NULL. It may be empty*/
+                if (circle == NULL) {
+                    deleteSVG(SVGObject);
+                    return NULL;
+                }
+                /*Insert into main list*/
+                insertBack(SVGObject->circles, (void*)circle);
+            } else if (strcmp(nodeName, "path") == 0) {
+                Path *path = parsePathData(cur_node);
+                /*Path object must not be NULL. It may be empty*/
+                if (path == NULL) {
+                    deleteSVG(SVGObject);
+                    return NULL;
+                }
+                /*Insert into main list*/
+                insertBack(SVGObject->paths, (void*)path);
+            } else if (strcmp(nodeName, "g") == 0) {
+                Group *group = parseGroupData(cur_node);
+                /*Group object must not be NULL. It may be empty*/
+                if (group == NULL) {
+                    deleteSVG(SVGObject);
+                    return NULL;
+                }
+                /*Insert into main list*/
+                insertBack(SVGObject->groups, (void*)group);
+            }
+        }
+    }
+
+    computeSVGStats(SVGObject);
+    return SVGObject;
+}
+
+/**
+ * @brief Adds the totals of a group and everything inside it to stats
+ * @param stats 
+ * @param group 
+ * @param depth - nesting level of the group, starting at 1
+ */
+static void addGroupStats(SVGStats *stats, Group *group, int depth) {
+    ListIterator iter;
+    void *elem;
+
+    stats->numGroups++;
+    stats->numAttributes += getLength(group->otherAttributes);
+    if (depth > stats->maxGroupDepth) {
+        stats->maxGroupDepth = depth;
+    }
+
+    stats->numRect += getLength(group->rectangles);
+    iter = createIterator(group->rectangles);
+    while ((elem = nextElement(&iter)) != NULL) {
+        stats->numAttributes += getLength(((Rectangle*)elem)->otherAttributes);
+    }
+
+    stats->numCirc += getLength(group->circles);
+    iter = createIterator(group->circles);
+    while ((elem = nextElement(&iter)) != NULL) {
+        stats->numAttributes += getLength(((Circle*)elem)->otherAttributes);
+    }
+
+    stats->numPaths += getLength(group->paths);
+    iter = createIterator(group->paths);
+    while ((elem = nextElement(&iter)) != NULL) {
+        stats->numAttributes += getLength(((Path*)elem)->otherAttributes);
+    }
+
+    iter = createIterator(group->groups);
+    while ((elem = nextElement(&iter)) != NULL) {
+        addGroupStats(stats, (Group*)elem, depth + 1);
+    }
+}
+
+/**
+ * @brief Counts the totals of an SVG struct with one walk over its group tree
+ * @param img 
+ * @param totals 
+ */
+static void countSVGStats(const SVG *img, SVGStats *totals) {
+    SVGStats stats = {0};
+    ListIterator iter;
+    void *elem;
+
+    stats.numAttributes = getLength(img->otherAttributes);
+
+    /*The SVG itself is walked like a group, except that it is not counted as one*/
+    stats.numRect = getLength(img->rectangles);
+    iter = createIterator(img->rectangles);
+    while ((elem = nextElement(&iter)) != NULL) {
+        stats.numAttributes += getLength(((Rectangle*)elem)->otherAttributes);
+    }
+
+    stats.numCirc = getLength(img->circles);
+    iter = createIterator(img->circles);
+    while ((elem = nextElement(&iter)) != NULL) {
+        stats.numAttributes += getLength(((Circle*)elem)->otherAttributes);
+    }
+
+    stats.numPaths = getLength(img->paths);
+    iter = createIterator(img->paths);
+    while ((elem = nextElement(&iter)) != NULL) {
+        stats.numAttributes += getLength(((Path*)elem)->otherAttributes);
+    }
+
+    iter = createIterator(img->groups);
+    while ((elem = nextElement(&iter)) != NULL) {
+        addGroupStats(&stats, (Group*)elem, 1);
+    }
+
+    stats.valid = true;
+    *totals = stats;
+}
+
+/**
+ * @brief Recomputes the totals of an SVG struct with one walk over its group tree
+ * @param img 
+ */
+void computeSVGStats(SVG *img) {
+    if (isLibrarySVG(img)) {
+        countSVGStats(img, &img->stats);
+    }
+}
+
+/**
+ * @brief Returns the totals of an SVG struct, recomputing them if they are stale
+ * @param img 
+ * @return const SVGStats* 
+ */
+const SVGStats *getSVGStats(const SVG *img) {
+    if (img == NULL) {
+        return NULL;
+    }
+
+    /*Structs built by hand keep no totals, so they are counted again by every call*/
+    if (!isLibrarySVG(img)) {
+        static _Thread_local SVGStats scratchStats;
+
+        countSVGStats(img, &scratchStats);
+        return &scratchStats;
+    }
+
+    /*Like the cached views, the totals are not part of the logical contents of the struct*/
+    if (!img->stats.valid) {
+        computeSVGStats((SVG*)img);
+    }
+
+    return &img->stats;
+}
+
+/**
+ * @brief Drops the cached views and totals of an SVG struct that was changed directly
+ * @param img 
+ */
+void markSVGChanged(SVG *img) {
+    if (img == NULL) {
+        return ;
+    }
+
+    if (!isLibrarySVG(img)) {
+        return ;
+    }
+
+    invalidateSVGViews(img);
+    img->stats.valid = false;
+    img->idGeneration++;
+}
+
 /********************************* A2 Functions *************************************/
 
 /**
@@ -825,42 +1364,222 @@ xmlDoc* svgToXML(const SVG *tmpImage) {
         return doc;
     } else {
         xmlFreeDoc(doc);
-        xmlCleanupParser();
+        cleanupSVGParser();
         xmlMemoryDump();
         /*Return false*/
         return NULL;
     }
 }
 
+/*Attribute lists longer than this get a name index (see findAttribute)*/
+#define ATTRIBUTE_INDEX_THRESHOLD 8
+
+/*One slot of an attribute name index*/
+typedef struct {
+    unsigned int hash;
+    Attribute *attr;
+} AttributeSlot;
+
+/*Open-addressing hash table from attribute name to Attribute, stored in List->index*/
+typedef struct {
+    //Power of two, at least twice the number of indexed attributes
+    int capacity;
+    //Number of list elements in the index.  Lists only grow at the back while an index exists
+    int indexedLength;
+    AttributeSlot slots[];
+} AttributeIndex;
+
+static unsigned int hashAttributeName(const char *name) {
+    unsigned int hash = 2166136261u;
+
+    while (*name != '\0') {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static void freeAttributeIndex(void *index) {
+    free(index);
+}
+
+/**
+ * @brief Finds the slot of a name - either the one holding it, or the empty slot where it would go
+ * @param index 
+ * @param name 
+ * @param hash 
+ * @return AttributeSlot* 
+ */
+static AttributeSlot *findAttributeSlot(AttributeIndex *index, const char *name, unsigned int hash) {
+    int mask = index->capacity - 1;
+    int slot = (int)(hash & (unsigned int)mask);
+
+    while (index->slots[slot].attr != NULL) {
+        const char *slotName = index->slots[slot].attr->name;
+
+        if (slotName == name || (index->slots[slot].hash == hash && strcmp(slotName, name) == 0)) {
+            return &index->slots[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return &index->slots[slot];
+}
+
+/**
+ * @brief Adds an attribute to the index, unless an attribute with that name is already in it
+ * @param index 
+ * @param attr 
+ */
+static void indexAttribute(AttributeIndex *index, Attribute *attr) {
+    unsigned int hash = hashAttributeName(attr->name);
+    AttributeSlot *slot = findAttributeSlot(index, attr->name, hash);
+
+    if (slot->attr == NULL) {
+        slot->hash = hash;
+        slot->attr = attr;
+    }
+    index->indexedLength++;
+}
+
+/**
+ * @brief Returns the name index of an attribute list, (re)building it if it does not cover
+ * the whole list.  Arena lists are never indexed, since their memory is never freed
+ * @param list 
+ * @return AttributeIndex* or NULL if the list is short (or memory ran out)
+ */
+static AttributeIndex *getAttributeIndex(List *list) {
+    if (list->allocator != NULL || getLength(list) < ATTRIBUTE_INDEX_THRESHOLD) {
+        return NULL;
+    }
+
+    AttributeIndex *index = (AttributeIndex*)list->index;
+    if (index != NULL && index->indexedLength == getLength(list)) {
+        return index;
+    }
+
+    /*Stale or missing - rebuild it, with room for the list to double before the next rebuild*/
+    int capacity = 16;
+    while (capacity < getLength(list) * 4) {
+        capacity *= 2;
+    }
+
+    if (index == NULL || index->capacity != capacity) {
+        if (list->index != NULL) {
+            list->freeIndex(list->index);
+        }
+        index = malloc(sizeof(AttributeIndex) + sizeof(AttributeSlot) * capacity);
+        list->index = index;
+        list->freeIndex = &freeAttributeIndex;
+        if (index == NULL) {
+            return NULL;
+        }
+        index->capacity = capacity;
+    }
+
+    for (int i = 0; i < capacity; i++) {
+        index->slots[i].attr = NULL;
+    }
+    index->indexedLength = 0;
+
+    ListIterator iter = createIterator(list);
+    void *elem;
+    while ((elem = nextElement(&iter)) != NULL) {
+        indexAttribute(index, (Attribute*)elem);
+    }
+
+    return index;
+}
+
+/**
+ * @brief Finds the first attribute with the given name in a list of attributes
+ * @param list 
+ * @param name 
+ * @return Attribute* or NULL
+ */
+Attribute *findAttribute(List *list, const char *name) {
+    if (list == NULL || name == NULL) {
+        return NULL;
+    }
+
+    /*Names in the list are almost always interned, so most matches are found by pointer*/
+    const char *interned = findInternedString(name);
+    if (interned != NULL) {
+        name = interned;
+    }
+
+    /*Long lists are looked up through their name index, short ones are just scanned*/
+    AttributeIndex *index = getAttributeIndex(list);
+    if (index != NULL) {
+        return findAttributeSlot(index, name, hashAttributeName(name))->attr;
+    }
+
+    ListIterator iter = createIterator(list);
+    void *elem;
+
+    while ((elem = nextElement(&iter)) != NULL) {
+        const char *elemName = ((Attribute*)elem)->name;
+
+        if (elemName == name || strcmp(elemName, name) == 0) {
+            return (Attribute*)elem;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Returns the value of the attribute with the given name in a list of attributes
+ * @param list 
+ * @param name 
+ * @return const char* or NULL if there is no such attribute
+ */
+const char *getAttributeValue(List *list, const char *name) {
+    Attribute *attr = findAttribute(list, name);
+
+    return (attr != NULL) ? attr->value : NULL;
+}
+
 /**
  * @brief Set the Other Attribute object for either Rect, Circ, Path, Group or SVG_Image
  * @param list 
  * @param newAttribute 
+ * @return true if newAttribute was appended to the list
+ * @return false if an existing attribute was updated instead
  */
-void setOtherAttribute(List *list, Attribute *newAttribute) {
+bool setOtherAttribute(List *list, Attribute *newAttribute) {
     /*If NULL, return NULL*/
     if (list == NULL || newAttribute == NULL) {
-        return ;
+        return false;
     }
 
     /*If the attribute with the specified name exists in list, update the value*/
-    ListIterator iter = createIterator(list);
-    void* elem;
-  
-    while ((elem = nextElement(&iter)) != NULL) {
-        Attribute* otherAttr = (Attribute*)elem;
-
-        if (strcmp(newAttribute->name, otherAttr->name) == 0) {
-            char tmpStr[1000];
-            sprintf(tmpStr, newAttribute->value);
-            //free(otherAttr->value);
-            strcpy(otherAttr->value, tmpStr);
+    Attribute *otherAttr = findAttribute(list, newAttribute->name);
+    if (otherAttr != NULL) {
+        char tmpStr[1000];
+        sprintf(tmpStr, newAttribute->value);
+        //free(otherAttr->value);
+        strcpy(otherAttr->value, tmpStr);
+
+        return false;
+    }
 
-            return ;
-        }
+    /*If the attribute with the specified name does not exist in list, append to the list.
+    The list owns it from now on, so its name is swapped for the interned copy*/
+    const char *interned = internString(newAttribute->name);
+    if (interned != NULL && interned != newAttribute->name) {
+        free(newAttribute->name);
+        newAttribute->name = (char *)interned;
     }
-    /*If the attribute with the specified name does not exist in list, append to the list*/
     insertBack(list, (void*)newAttribute);
+
+    /*Appending keeps the name index valid, so the new attribute is simply added to it*/
+    AttributeIndex *index = (AttributeIndex*)list->index;
+    if (index != NULL && index->indexedLength == getLength(list) - 1 && (index->indexedLength + 1) * 2 <= index->capacity) {
+        indexAttribute(index, newAttribute);
+    }
+    return true;
 }
 
 /**
@@ -874,10 +1593,42 @@ char* validImageToJSON(const char* fileName, const char* schemaFile) {
         return NULL;
     }
 
-    SVG* imageObj = createValidSVG(fileName, schemaFile);
+    /*Schema is compiled on the first call and reused for every file after that*/
+    const SVGSchema* schema = getCachedSVGSchema(schemaFile);
+    if (schema == NULL) {
+        return NULL;
+    }
+
+    /*Only the four counts are needed, so they are taken straight from the reader
+    without building the SVG struct*/
+    SVGCounts counts;
+    if (!countValidSVGStreaming(fileName, schema, &counts)) {
+        return NULL;
+    }
+
+    return SVGCountsToJSON(&counts);
+}
+
+/**
+ * @brief Helper function to return a JSON string of SVG contents that are already in memory
+ * @param buffer 
+ * @param length 
+ * @param schemaFile 
+ * @return char* 
+ */
+char* validImageBufferToJSON(const char* buffer, int length, const char* schemaFile) {
+    if (buffer == NULL || schemaFile == NULL) {
+        return NULL;
+    }
+
+    const SVGSchema* schema = getCachedSVGSchema(schemaFile);
+    if (schema == NULL) {
+        return NULL;
+    }
+
+    SVG* imageObj = createValidSVGFromBufferWithSchema(buffer, length, schema);
 
     if (imageObj == NULL) {
-        deleteSVG(imageObj);
         return NULL;
     } else {
         char* jsonChar = SVGtoJSON(imageObj);
@@ -886,4 +1637,3 @@ char* validImageToJSON(const char* fileName, const char* schemaFile) {
         return jsonChar;
     }
 }
-
@@ -0,0 +1,434 @@
+/**
+ * @file SVGIntern.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief This file contains the process-wide string table that attribute names and
+ * units are interned in, so every shape shares one copy of "fill", "px", etc.
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+/*pthread_rwlock_t is POSIX, not C11*/
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "SVGIntern.h"
+
+/*Size of the blocks interned strings are copied into*/
+#define INTERN_BLOCK_SIZE 16384
+
+const char SVG_NAME_X[] = "x";
+const char SVG_NAME_Y[] = "y";
+const char SVG_NAME_WIDTH[] = "width";
+const char SVG_NAME_HEIGHT[] = "height";
+const char SVG_NAME_CX[] = "cx";
+const char SVG_NAME_CY[] = "cy";
+const char SVG_NAME_R[] = "r";
+const char SVG_NAME_D[] = "d";
+const char SVG_NAME_ID[] = "id";
+const char SVG_UNITS_NONE[] = "";
+
+/*One slot of the open-addressing table*/
+typedef struct {
+    unsigned int hash;
+    const char* str;
+} InternSlot;
+
+/*Block of string data.  Blocks are chained so they stay reachable, and are never freed*/
+typedef struct internBlock {
+    struct internBlock* next;
+    size_t used;
+    char data[];
+} InternBlock;
+
+static InternSlot* slots = NULL;
+static int capacity = 0;
+static int numStrings = 0;
+static InternBlock* blocks = NULL;
+static size_t totalBytes = 0;
+
+/*Lookups only need the read lock, so parser threads do not serialize on known names*/
+static pthread_rwlock_t internLock = PTHREAD_RWLOCK_INITIALIZER;
+static pthread_once_t internOnce = PTHREAD_ONCE_INIT;
+
+static unsigned int hashName(const char* str, size_t length) {
+    unsigned int hash = 2166136261u;
+
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Finds the slot of the first length characters of str - either the one holding
+ * them, or the empty slot where they would be inserted.  The caller must hold the lock
+ * @param str
+ * @param length
+ * @param hash
+ * @return InternSlot*
+ */
+static InternSlot* findSlot(const char* str, size_t length, unsigned int hash) {
+    int mask = capacity - 1;
+    int slot = (int)(hash & (unsigned int)mask);
+
+    while (slots[slot].str != NULL) {
+        const char* other = slots[slot].str;
+
+        if (slots[slot].hash == hash && strncmp(other, str, length) == 0 && other[length] == '\0') {
+            return &slots[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return &slots[slot];
+}
+
+/**
+ * @brief Doubles the table.  The caller must hold the write lock
+ * @return true
+ * @return false if memory ran out
+ */
+static bool growTable(void) {
+    int newCapacity = (capacity == 0) ? 256 : capacity * 2;
+    InternSlot* newSlots = calloc(newCapacity, sizeof(InternSlot));
+    if (newSlots == NULL) {
+        return false;
+    }
+
+    InternSlot* oldSlots = slots;
+    int oldCapacity = capacity;
+    slots = newSlots;
+    capacity = newCapacity;
+
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldSlots[i].str != NULL) {
+            *findSlot(oldSlots[i].str, strlen(oldSlots[i].str), oldSlots[i].hash) = oldSlots[i];
+        }
+    }
+    free(oldSlots);
+
+    return true;
+}
+
+/**
+ * @brief Adds a string to an empty slot, without copying it.  The caller must hold the write lock
+ * @param slot
+ * @param str
+ * @param hash
+ */
+static void fillSlot(InternSlot* slot, const char* str, unsigned int hash) {
+    slot->hash = hash;
+    slot->str = str;
+    numStrings++;
+}
+
+/**
+ * @brief Seeds the table with the names the parser compares against, so they are
+ * always interned as the SVG_NAME_* arrays themselves
+ */
+static void seedTable(void) {
+    /*Units and common attribute names are seeded too, so documents that use them never
+    depend on how full the table is*/
+    const char* seeds[] = {
+        SVG_NAME_X, SVG_NAME_Y, SVG_NAME_WIDTH, SVG_NAME_HEIGHT,
+        SVG_NAME_CX, SVG_NAME_CY, SVG_NAME_R, SVG_NAME_D, SVG_NAME_ID, SVG_UNITS_NONE,
+        "px", "pt", "pc", "mm", "cm", "in", "em", "ex", "rem", "vw", "vh",
+        "fill", "fill-opacity", "fill-rule", "stroke", "stroke-width", "stroke-opacity",
+        "stroke-linecap", "stroke-linejoin", "stroke-dasharray", "stroke-miterlimit",
+        "opacity", "transform", "style", "class", "visibility", "display", "color",
+        "font-family", "font-size", "font-weight", "text-anchor", "clip-path", "mask",
+        "filter", "viewBox", "version", "preserveAspectRatio", "href", "xlink:href",
+        "rx", "ry", "x1", "y1", "x2", "y2", "points", "pathLength"
+    };
+
+    pthread_rwlock_wrlock(&internLock);
+    growTable();
+    for (int i = 0; i < (int)(sizeof(seeds) / sizeof(seeds[0])); i++) {
+        size_t length = strlen(seeds[i]);
+        unsigned int hash = hashName(seeds[i], length);
+        fillSlot(findSlot(seeds[i], length, hash), seeds[i], hash);
+    }
+    pthread_rwlock_unlock(&internLock);
+}
+
+/**
+ * @brief Copies a string into the current block, starting a new one when it is full.
+ * The caller must hold the write lock
+ * @param str
+ * @param length
+ * @return const char* or NULL
+ */
+static const char* copyString(const char* str, size_t length) {
+    if (totalBytes + length + 1 > INTERN_MAX_BYTES) {
+        return NULL;
+    }
+
+    if (blocks == NULL || blocks->used + length + 1 > INTERN_BLOCK_SIZE) {
+        size_t size = (length + 1 > INTERN_BLOCK_SIZE) ? length + 1 : INTERN_BLOCK_SIZE;
+        InternBlock* block = malloc(sizeof(InternBlock) + size);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->next = blocks;
+        block->used = 0;
+        blocks = block;
+    }
+
+    char* copy = blocks->data + blocks->used;
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    blocks->used += length + 1;
+    totalBytes += length + 1;
+
+    return copy;
+}
+
+/**
+ * @brief Returns the process-wide copy of the first length characters of str, adding
+ * them to the table if needed
+ * @param str
+ * @param length
+ * @return const char*
+ */
+const char* internSpan(const char* str, size_t length) {
+    if (str == NULL) {
+        return NULL;
+    }
+
+    pthread_once(&internOnce, &seedTable);
+    unsigned int hash = hashName(str, length);
+
+    pthread_rwlock_rdlock(&internLock);
+    const char* found = findSlot(str, length, hash)->str;
+    pthread_rwlock_unlock(&internLock);
+
+    if (found != NULL) {
+        return found;
+    }
+
+    /*Not there yet - look again under the write lock, since another thread may have added it*/
+    pthread_rwlock_wrlock(&internLock);
+    InternSlot* slot = findSlot(str, length, hash);
+
+    if (slot->str == NULL) {
+        const char* copy = copyString(str, length);
+
+        /*Keep the table at most half full*/
+        if (copy != NULL && (numStrings + 1) * 2 > capacity) {
+            if (growTable()) {
+                slot = findSlot(str, length, hash);
+            } else {
+                copy = NULL;
+            }
+        }
+        if (copy != NULL) {
+            fillSlot(slot, copy, hash);
+        }
+    }
+    found = slot->str;
+    pthread_rwlock_unlock(&internLock);
+
+    return found;
+}
+
+/**
+ * @brief Returns the process-wide copy of str, adding it to the table if needed
+ * @param str
+ * @return const char*
+ */
+const char* internString(const char* str) {
+    if (str == NULL) {
+        return NULL;
+    }
+
+    return internSpan(str, strlen(str));
+}
+
+/**
+ * @brief Same as internString(), but never adds to the table
+ * @param str
+ * @return const char*
+ */
+const char* findInternedString(const char* str) {
+    if (str == NULL) {
+        return NULL;
+    }
+
+    pthread_once(&internOnce, &seedTable);
+    size_t length = strlen(str);
+    unsigned int hash = hashName(str, length);
+
+    pthread_rwlock_rdlock(&internLock);
+    const char* found = findSlot(str, length, hash)->str;
+    pthread_rwlock_unlock(&internLock);
+
+    return found;
+}
+
+/**
+ * @brief Returns whether str is itself an interned string
+ * @param str
+ * @return true
+ * @return false
+ */
+bool isInternedString(const char* str) {
+    return str != NULL && findInternedString(str) == str;
+}
+
+/**
+ * @brief Returns the interned units string, or NULL if the table is full
+ * @param units
+ * @param length
+ * @return const char*
+ */
+const char* internUnits(const char* units, size_t length) {
+    /*A document almost always uses one kind of units, so the last one is kept per thread*/
+    static _Thread_local const char* lastUnits = NULL;
+
+    if (length == 0) {
+        return SVG_UNITS_NONE;
+    }
+    if (lastUnits != NULL && strncmp(lastUnits, units, length) == 0 && lastUnits[length] == '\0') {
+        return lastUnits;
+    }
+
+    const char* interned = internSpan(units, length);
+    if (interned != NULL) {
+        lastUnits = interned;
+    }
+
+    return interned;
+}
+
+/*Set of the copies made by copyOwnedSpan(), as an open-addressing table of pointers*/
+static const char** ownedSlots = NULL;
+static size_t ownedCapacity = 0;
+static size_t numOwned = 0;
+static pthread_mutex_t ownedLock = PTHREAD_MUTEX_INITIALIZER;
+
+static size_t ownedSlot(const char* str) {
+    size_t hash = (size_t)(((unsigned long long)(size_t)str * 0x9E3779B97F4A7C15ULL) >> 32);
+    return hash & (ownedCapacity - 1);
+}
+
+/**
+ * @brief Finds the slot holding str, or the empty slot where it would go.  The caller
+ * must hold ownedLock, and the set must not be empty
+ * @param str
+ * @return size_t
+ */
+static size_t findOwnedSlot(const char* str) {
+    size_t slot = ownedSlot(str);
+
+    while (ownedSlots[slot] != NULL && ownedSlots[slot] != str) {
+        slot = (slot + 1) & (ownedCapacity - 1);
+    }
+    return slot;
+}
+
+/**
+ * @brief Doubles the set of owned copies.  The caller must hold ownedLock
+ * @return true
+ * @return false if memory ran out
+ */
+static bool growOwned(void) {
+    size_t newCapacity = (ownedCapacity == 0) ? 64 : ownedCapacity * 2;
+    const char** newSlots = calloc(newCapacity, sizeof(const char*));
+    if (newSlots == NULL) {
+        return false;
+    }
+
+    const char** oldSlots = ownedSlots;
+    size_t oldCapacity = ownedCapacity;
+    ownedSlots = newSlots;
+    ownedCapacity = newCapacity;
+
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (oldSlots[i] != NULL) {
+            ownedSlots[findOwnedSlot(oldSlots[i])] = oldSlots[i];
+        }
+    }
+    free(oldSlots);
+
+    return true;
+}
+
+/**
+ * @brief Returns a recorded heap copy of the first length characters of str
+ * @param str
+ * @param length
+ * @return char*
+ */
+char* copyOwnedSpan(const char* str, size_t length) {
+    if (str == NULL) {
+        return NULL;
+    }
+
+    char* copy = malloc(length + 1);
+    if (copy == NULL) {
+        return NULL;
+    }
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+
+    pthread_mutex_lock(&ownedLock);
+    /*Keep the set at most half full*/
+    bool recorded = ((numOwned + 1) * 2 <= ownedCapacity || growOwned());
+    if (recorded) {
+        ownedSlots[findOwnedSlot(copy)] = copy;
+        numOwned++;
+    }
+    pthread_mutex_unlock(&ownedLock);
+
+    if (!recorded) {
+        free(copy);
+        return NULL;
+    }
+    return copy;
+}
+
+/**
+ * @brief Frees a copy made by copyOwnedSpan()
+ * @param str
+ * @return true
+ * @return false
+ */
+bool releaseOwnedString(const char* str) {
+    if (str == NULL) {
+        return false;
+    }
+
+    pthread_mutex_lock(&ownedLock);
+    bool owned = (numOwned > 0 && ownedSlots[findOwnedSlot(str)] == str);
+
+    if (owned) {
+        /*Entries after the removed one are moved back, so no probe sequence is broken*/
+        size_t hole = findOwnedSlot(str);
+        size_t slot = hole;
+
+        ownedSlots[hole] = NULL;
+        while (ownedSlots[slot = (slot + 1) & (ownedCapacity - 1)] != NULL) {
+            size_t home = ownedSlot(ownedSlots[slot]);
+
+            /*An entry may fill the hole unless its home lies cyclically in (hole, slot]*/
+            if (((slot - home) & (ownedCapacity - 1)) >= ((slot - hole) & (ownedCapacity - 1))) {
+                ownedSlots[hole] = ownedSlots[slot];
+                ownedSlots[slot] = NULL;
+                hole = slot;
+            }
+        }
+        numOwned--;
+    }
+    pthread_mutex_unlock(&ownedLock);
+
+    if (owned) {
+        free((char*)str);
+    }
+    return owned;
+}
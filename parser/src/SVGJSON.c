@@ -0,0 +1,1046 @@
+/**
+ * @file SVGJSON.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief This file contains the document JSON export, which streams a whole SVG struct
+ * (nested groups included) to a file, file descriptor or callback in fixed-size chunks,
+ * and the JSON import (JSONtoSVG() etc.), which reads it back in a single pass over the text
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SVGParser.h"
+#include "SVGJSON.h"
+#include "SVGHelpers.h"
+#include "SVGIntern.h"
+#include "StringBuilder.h"
+#include "LinkedListAPI.h"
+
+/*Text is collected into chunks of this size before it is handed to the sink*/
+#define JSON_CHUNK_SIZE 16384
+
+/*State of one export*/
+typedef struct {
+    SVGJSONSink sink;
+    void* context;
+    int precision;
+    //Set once the sink returns false.  Nothing is written after that
+    bool failed;
+    size_t length;
+    char buffer[JSON_CHUNK_SIZE];
+} JSONStream;
+
+static void flushStream(JSONStream* stream) {
+    if (!stream->failed && stream->length > 0 && !stream->sink(stream->buffer, stream->length, stream->context)) {
+        stream->failed = true;
+    }
+    stream->length = 0;
+}
+
+static void emit(JSONStream* stream, const char* text, size_t length) {
+    if (stream->failed || length == 0) {
+        return ;
+    }
+
+    if (stream->length + length > JSON_CHUNK_SIZE) {
+        flushStream(stream);
+
+        /*Text longer than a whole chunk (e.g. long path data) goes straight to the sink*/
+        if (length > JSON_CHUNK_SIZE) {
+            if (!stream->failed && !stream->sink(text, length, stream->context)) {
+                stream->failed = true;
+            }
+            return ;
+        }
+    }
+
+    memcpy(stream->buffer + stream->length, text, length);
+    stream->length += length;
+}
+
+static void emitString(JSONStream* stream, const char* text) {
+    emit(stream, text, strlen(text));
+}
+
+static void emitNumber(JSONStream* stream, float value) {
+    /*Big enough for -FLT_MAX with SVG_JSON_MAX_PRECISION digits after the point*/
+    char number[64];
+
+    if (!isfinite(value)) {
+        emitString(stream, "null");
+        return ;
+    }
+
+    int length = snprintf(number, sizeof(number), "%.*f", stream->precision, value);
+    emit(stream, number, (size_t)length);
+}
+
+/*Writes str as a JSON string, escaping quotes, backslashes and control characters*/
+static void emitQuoted(JSONStream* stream, const char* str) {
+    emit(stream, "\"", 1);
+
+    if (str != NULL) {
+        const char* run = str;
+
+        for (const char* c = str; *c != '\0'; c++) {
+            unsigned char ch = (unsigned char)*c;
+            char escape[8];
+
+            if (ch != '"' && ch != '\\' && ch >= 0x20) {
+                continue;
+            }
+
+            /*Everything before the character is written as is*/
+            emit(stream, run, (size_t)(c - run));
+            if (ch == '"' || ch == '\\') {
+                escape[0] = '\\';
+                escape[1] = (char)ch;
+                escape[2] = '\0';
+            } else if (ch == '\n') {
+                strcpy(escape, "\\n");
+            } else if (ch == '\r') {
+                strcpy(escape, "\\r");
+            } else if (ch == '\t') {
+                strcpy(escape, "\\t");
+            } else {
+                snprintf(escape, sizeof(escape), "\\u%04x", ch);
+            }
+            emitString(stream, escape);
+            run = c + 1;
+        }
+        emitString(stream, run);
+    }
+
+    emit(stream, "\"", 1);
+}
+
+/*Writes "key":[...] with every element of a list, which may be NULL*/
+static void emitList(JSONStream* stream, const char* key, List* list, void (*emitElement)(JSONStream*, void*)) {
+    emit(stream, "\"", 1);
+    emitString(stream, key);
+    emitString(stream, "\":[");
+
+    if (list != NULL) {
+        void* elem;
+        ListIterator iter = createIterator(list);
+        bool first = true;
+
+        while ((elem = nextElement(&iter)) != NULL && !stream->failed) {
+            if (!first) {
+                emit(stream, ",", 1);
+            }
+            emitElement(stream, elem);
+            first = false;
+        }
+    }
+
+    emit(stream, "]", 1);
+}
+
+static void emitAttribute(JSONStream* stream, void* data) {
+    Attribute* attr = (Attribute*)data;
+
+    emitString(stream, "{\"name\":");
+    emitQuoted(stream, attr->name);
+    emitString(stream, ",\"value\":");
+    emitQuoted(stream, attr->value);
+    emit(stream, "}", 1);
+}
+
+static void emitRectangle(JSONStream* stream, void* data) {
+    Rectangle* rect = (Rectangle*)data;
+
+    emitString(stream, "{\"x\":");
+    emitNumber(stream, rect->x);
+    emitString(stream, ",\"y\":");
+    emitNumber(stream, rect->y);
+    emitString(stream, ",\"w\":");
+    emitNumber(stream, rect->width);
+    emitString(stream, ",\"h\":");
+    emitNumber(stream, rect->height);
+    emitString(stream, ",\"units\":");
+    emitQuoted(stream, rect->units);
+    emit(stream, ",", 1);
+    emitList(stream, "attributes", rect->otherAttributes, &emitAttribute);
+    emit(stream, "}", 1);
+}
+
+static void emitCircle(JSONStream* stream, void* data) {
+    Circle* circle = (Circle*)data;
+
+    emitString(stream, "{\"cx\":");
+    emitNumber(stream, circle->cx);
+    emitString(stream, ",\"cy\":");
+    emitNumber(stream, circle->cy);
+    emitString(stream, ",\"r\":");
+    emitNumber(stream, circle->r);
+    emitString(stream, ",\"units\":");
+    emitQuoted(stream, circle->units);
+    emit(stream, ",", 1);
+    emitList(stream, "attributes", circle->otherAttributes, &emitAttribute);
+    emit(stream, "}", 1);
+}
+
+static void emitPath(JSONStream* stream, void* data) {
+    Path* path = (Path*)data;
+
+    emitString(stream, "{\"d\":");
+    emitQuoted(stream, path->data);
+    emit(stream, ",", 1);
+    emitList(stream, "attributes", path->otherAttributes, &emitAttribute);
+    emit(stream, "}", 1);
+}
+
+/*Writes the lists shared by groups and the svg element, from "rectangles" to "groups"*/
+static void emitComponents(JSONStream* stream, List* rectangles, List* circles, List* paths, List* groups);
+
+static void emitGroup(JSONStream* stream, void* data) {
+    Group* group = (Group*)data;
+
+    emit(stream, "{", 1);
+    emitList(stream, "attributes", group->otherAttributes, &emitAttribute);
+    emit(stream, ",", 1);
+    emitComponents(stream, group->rectangles, group->circles, group->paths, group->groups);
+    emit(stream, "}", 1);
+}
+
+static void emitComponents(JSONStream* stream, List* rectangles, List* circles, List* paths, List* groups) {
+    emitList(stream, "rectangles", rectangles, &emitRectangle);
+    emit(stream, ",", 1);
+    emitList(stream, "circles", circles, &emitCircle);
+    emit(stream, ",", 1);
+    emitList(stream, "paths", paths, &emitPath);
+    emit(stream, ",", 1);
+    emitList(stream, "groups", groups, &emitGroup);
+}
+
+/**
+ * @brief Streams the document JSON of an SVG struct to a sink
+ * @param img
+ * @param precision
+ * @param sink
+ * @param context
+ * @return true
+ * @return false
+ */
+bool writeSVGJSON(const SVG* img, int precision, SVGJSONSink sink, void* context) {
+    if (img == NULL || sink == NULL) {
+        return false;
+    }
+
+    /*The chunk buffer is part of the stream, so an export allocates nothing itself*/
+    JSONStream stream;
+    stream.sink = sink;
+    stream.context = context;
+    stream.precision = (precision < 0) ? SVG_JSON_DEFAULT_PRECISION : (precision > SVG_JSON_MAX_PRECISION) ? SVG_JSON_MAX_PRECISION : precision;
+    stream.failed = false;
+    stream.length = 0;
+
+    emitString(&stream, "{\"namespace\":");
+    emitQuoted(&stream, img->namespace);
+    emitString(&stream, ",\"title\":");
+    emitQuoted(&stream, img->title);
+    emitString(&stream, ",\"descr\":");
+    emitQuoted(&stream, img->description);
+    emit(&stream, ",", 1);
+    emitList(&stream, "attributes", img->otherAttributes, &emitAttribute);
+    emit(&stream, ",", 1);
+    emitComponents(&stream, img->rectangles, img->circles, img->paths, img->groups);
+    emit(&stream, "}", 1);
+    flushStream(&stream);
+
+    return !stream.failed;
+}
+
+/**
+ * @brief Streams the document JSON of an SVG struct to an open file
+ * @param img
+ * @param precision
+ * @param file
+ * @return true
+ * @return false
+ */
+bool writeSVGJSONToFile(const SVG* img, int precision, FILE* file) {
+    if (file == NULL) {
+        return false;
+    }
+
+    return writeSVGJSON(img, precision, &fileSink, file);
+}
+
+/**
+ * @brief Streams the document JSON of an SVG struct to a file descriptor
+ * @param img
+ * @param precision
+ * @param fd
+ * @return true
+ * @return false
+ */
+bool writeSVGJSONToFd(const SVG* img, int precision, int fd) {
+    if (fd < 0) {
+        return false;
+    }
+
+    return writeSVGJSON(img, precision, &fdSink, &fd);
+}
+
+/**
+ * @brief Returns the document JSON of an SVG struct as one string
+ * @param img
+ * @param precision
+ * @return char*
+ */
+char* SVGtoDocumentJSON(const SVG* img, int precision) {
+    if (img == NULL) {
+        return NULL;
+    }
+
+    StringBuilder json = createStringBuilder(JSON_CHUNK_SIZE);
+    if (!writeSVGJSON(img, precision, &builderSink, &json)) {
+        discardString(&json);
+        return NULL;
+    }
+
+    return finishString(&json);
+}
+
+/* ******************************* Tokenizer ******************************* */
+
+/*What the tokenizer expects next*/
+enum {
+    EXPECT_VALUE,
+    //Right after '[' - a value or ']'
+    EXPECT_VALUE_OR_END,
+    //Right after ',' in an object
+    EXPECT_KEY,
+    //Right after '{' - a key or '}'
+    EXPECT_KEY_OR_END,
+    //Right after a key
+    EXPECT_COLON,
+    //Right after a value - ',' or the end of its container
+    AFTER_VALUE,
+    FAILED
+};
+
+/**
+ * @brief Starts tokenizing a JSON text
+ * @param tokenizer
+ * @param text
+ * @param length
+ */
+void initJSONTokenizer(JSONTokenizer* tokenizer, const char* text, size_t length) {
+    tokenizer->pos = text;
+    tokenizer->end = (text != NULL) ? text + length : NULL;
+    tokenizer->state = (text != NULL) ? EXPECT_VALUE : FAILED;
+    tokenizer->depth = 0;
+}
+
+static JSONToken makeToken(JSONTokenType type, const char* start, size_t length, bool escaped) {
+    JSONToken token = {type, start, length, escaped};
+    return token;
+}
+
+static JSONToken failToken(JSONTokenizer* tokenizer) {
+    tokenizer->state = FAILED;
+    return makeToken(JSON_ERROR, tokenizer->pos, 0, false);
+}
+
+static bool isHexDigit(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/*Scans the string starting at the opening quote, checking its escapes*/
+static JSONToken scanString(JSONTokenizer* tokenizer, JSONTokenType type) {
+    const char* start = tokenizer->pos + 1;
+    const char* c = start;
+    bool escaped = false;
+
+    while (c < tokenizer->end && *c != '"') {
+        if ((unsigned char)*c < 0x20) {
+            return failToken(tokenizer);
+        }
+
+        if (*c == '\\') {
+            escaped = true;
+            c++;
+            if (c >= tokenizer->end) {
+                return failToken(tokenizer);
+            }
+            if (*c == 'u') {
+                for (int i = 1; i <= 4; i++) {
+                    if (c + i >= tokenizer->end || !isHexDigit(c[i])) {
+                        return failToken(tokenizer);
+                    }
+                }
+                c += 4;
+            } else if (strchr("\"\\/bfnrt", *c) == NULL || *c == '\0') {
+                return failToken(tokenizer);
+            }
+        }
+        c++;
+    }
+
+    if (c >= tokenizer->end) {
+        return failToken(tokenizer);
+    }
+
+    tokenizer->pos = c + 1;
+    return makeToken(type, start, (size_t)(c - start), escaped);
+}
+
+/*Scans a number: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?*/
+static JSONToken scanNumber(JSONTokenizer* tokenizer) {
+    const char* start = tokenizer->pos;
+    const char* c = start;
+    const char* end = tokenizer->end;
+
+    if (c < end && *c == '-') {
+        c++;
+    }
+    if (c < end && *c == '0') {
+        c++;
+    } else if (c < end && isDigit(*c)) {
+        while (c < end && isDigit(*c)) {
+            c++;
+        }
+    } else {
+        return failToken(tokenizer);
+    }
+
+    if (c < end && *c == '.') {
+        c++;
+        if (c >= end || !isDigit(*c)) {
+            return failToken(tokenizer);
+        }
+        while (c < end && isDigit(*c)) {
+            c++;
+        }
+    }
+
+    if (c < end && (*c == 'e' || *c == 'E')) {
+        c++;
+        if (c < end && (*c == '+' || *c == '-')) {
+            c++;
+        }
+        if (c >= end || !isDigit(*c)) {
+            return failToken(tokenizer);
+        }
+        while (c < end && isDigit(*c)) {
+            c++;
+        }
+    }
+
+    tokenizer->pos = c;
+    return makeToken(JSON_NUMBER, start, (size_t)(c - start), false);
+}
+
+static JSONToken scanLiteral(JSONTokenizer* tokenizer, const char* literal, JSONTokenType type) {
+    size_t length = strlen(literal);
+
+    if ((size_t)(tokenizer->end - tokenizer->pos) < length || memcmp(tokenizer->pos, literal, length) != 0) {
+        return failToken(tokenizer);
+    }
+
+    JSONToken token = makeToken(type, tokenizer->pos, length, false);
+    tokenizer->pos += length;
+    return token;
+}
+
+static JSONToken openContainer(JSONTokenizer* tokenizer, bool object) {
+    if (tokenizer->depth == JSON_MAX_DEPTH) {
+        return failToken(tokenizer);
+    }
+
+    tokenizer->objects[tokenizer->depth++] = object;
+    tokenizer->state = object ? EXPECT_KEY_OR_END : EXPECT_VALUE_OR_END;
+    return makeToken(object ? JSON_OBJECT_START : JSON_ARRAY_START, tokenizer->pos++, 1, false);
+}
+
+static JSONToken closeContainer(JSONTokenizer* tokenizer, bool object) {
+    tokenizer->depth--;
+    tokenizer->state = AFTER_VALUE;
+    return makeToken(object ? JSON_OBJECT_END : JSON_ARRAY_END, tokenizer->pos++, 1, false);
+}
+
+/**
+ * @brief Returns the next token of the text
+ * @param tokenizer
+ * @return JSONToken
+ */
+JSONToken nextJSONToken(JSONTokenizer* tokenizer) {
+    while (tokenizer->state != FAILED) {
+        /*Whitespace is allowed between any two tokens*/
+        while (tokenizer->pos < tokenizer->end && (*tokenizer->pos == ' ' || *tokenizer->pos == '\t' || *tokenizer->pos == '\n' || *tokenizer->pos == '\r')) {
+            tokenizer->pos++;
+        }
+
+        bool atEnd = (tokenizer->pos >= tokenizer->end);
+        char c = atEnd ? '\0' : *tokenizer->pos;
+        bool inObject = (tokenizer->depth > 0) && tokenizer->objects[tokenizer->depth - 1];
+
+        if (tokenizer->state == AFTER_VALUE) {
+            /*The top-level value must be the only thing in the text*/
+            if (tokenizer->depth == 0) {
+                return atEnd ? makeToken(JSON_END, tokenizer->pos, 0, false) : failToken(tokenizer);
+            }
+            if (c == ',') {
+                tokenizer->pos++;
+                tokenizer->state = inObject ? EXPECT_KEY : EXPECT_VALUE;
+                continue;
+            }
+            if ((c == '}' && inObject) || (c == ']' && !inObject)) {
+                return closeContainer(tokenizer, inObject);
+            }
+            return failToken(tokenizer);
+        }
+
+        if (atEnd) {
+            return failToken(tokenizer);
+        }
+
+        if (tokenizer->state == EXPECT_COLON) {
+            if (c != ':') {
+                return failToken(tokenizer);
+            }
+            tokenizer->pos++;
+            tokenizer->state = EXPECT_VALUE;
+            continue;
+        }
+
+        if (tokenizer->state == EXPECT_KEY || tokenizer->state == EXPECT_KEY_OR_END) {
+            if (c == '}' && tokenizer->state == EXPECT_KEY_OR_END) {
+                return closeContainer(tokenizer, true);
+            }
+            if (c != '"') {
+                return failToken(tokenizer);
+            }
+            tokenizer->state = EXPECT_COLON;
+            return scanString(tokenizer, JSON_KEY);
+        }
+
+        /*A value (or the end of an empty array)*/
+        if (c == ']' && tokenizer->state == EXPECT_VALUE_OR_END) {
+            return closeContainer(tokenizer, false);
+        }
+
+        tokenizer->state = AFTER_VALUE;
+        if (c == '{' || c == '[') {
+            return openContainer(tokenizer, c == '{');
+        } else if (c == '"') {
+            return scanString(tokenizer, JSON_STRING);
+        } else if (c == '-' || isDigit(c)) {
+            return scanNumber(tokenizer);
+        } else if (c == 't') {
+            return scanLiteral(tokenizer, "true", JSON_TRUE);
+        } else if (c == 'f') {
+            return scanLiteral(tokenizer, "false", JSON_FALSE);
+        } else if (c == 'n') {
+            return scanLiteral(tokenizer, "null", JSON_NULL);
+        }
+        return failToken(tokenizer);
+    }
+
+    return makeToken(JSON_ERROR, tokenizer->pos, 0, false);
+}
+
+static unsigned int hexValue(const char* hex) {
+    unsigned int value = 0;
+
+    for (int i = 0; i < 4; i++) {
+        char c = hex[i];
+        value = value * 16 + (unsigned int)((c <= '9') ? c - '0' : (c | 0x20) - 'a' + 10);
+    }
+    return value;
+}
+
+/*Writes a code point as UTF-8, returning the number of bytes*/
+static size_t writeUTF8(unsigned int code, char* dest) {
+    if (code < 0x80) {
+        dest[0] = (char)code;
+        return 1;
+    } else if (code < 0x800) {
+        dest[0] = (char)(0xC0 | (code >> 6));
+        dest[1] = (char)(0x80 | (code & 0x3F));
+        return 2;
+    } else if (code < 0x10000) {
+        dest[0] = (char)(0xE0 | (code >> 12));
+        dest[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+        dest[2] = (char)(0x80 | (code & 0x3F));
+        return 3;
+    }
+    dest[0] = (char)(0xF0 | (code >> 18));
+    dest[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+    dest[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+    dest[3] = (char)(0x80 | (code & 0x3F));
+    return 4;
+}
+
+/**
+ * @brief Writes the unescaped characters of a key or string token
+ * @param token
+ * @param dest
+ * @return size_t
+ */
+size_t decodeJSONString(const JSONToken* token, char* dest) {
+    if (!token->escaped) {
+        memcpy(dest, token->start, token->length);
+        dest[token->length] = '\0';
+        return token->length;
+    }
+
+    /*The tokenizer has already checked every escape*/
+    const char* c = token->start;
+    const char* end = token->start + token->length;
+    size_t length = 0;
+
+    while (c < end) {
+        if (*c != '\\') {
+            dest[length++] = *c++;
+            continue;
+        }
+
+        c++;
+        switch (*c) {
+            case 'b': dest[length++] = '\b'; break;
+            case 'f': dest[length++] = '\f'; break;
+            case 'n': dest[length++] = '\n'; break;
+            case 'r': dest[length++] = '\r'; break;
+            case 't': dest[length++] = '\t'; break;
+            case 'u': {
+                unsigned int code = hexValue(c + 1);
+                c += 4;
+
+                /*A surrogate pair is one code point, written as 4 bytes of UTF-8 from 12 characters*/
+                if (code >= 0xD800 && code <= 0xDBFF && end - c >= 7 && c[1] == '\\' && c[2] == 'u') {
+                    unsigned int low = hexValue(c + 3);
+
+                    if (low >= 0xDC00 && low <= 0xDFFF) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        c += 6;
+                    }
+                }
+                length += writeUTF8(code, dest + length);
+                break;
+            }
+            default: dest[length++] = *c; break;
+        }
+        c++;
+    }
+
+    dest[length] = '\0';
+    return length;
+}
+
+/* ******************************* Reader ******************************* */
+
+/*State of one JSONto* call.  Readers of a value start at its first token and stop at its last*/
+typedef struct {
+    JSONTokenizer tokenizer;
+    JSONToken token;
+    //Decoded strings.  Attributes need their name and value at the same time
+    StringBuilder scratch[2];
+} JSONReader;
+
+static bool nextToken(JSONReader* reader) {
+    reader->token = nextJSONToken(&reader->tokenizer);
+    return reader->token.type != JSON_ERROR;
+}
+
+/*Decodes the current string token into one of the scratch buffers*/
+static const char* decodeString(JSONReader* reader, int buffer) {
+    StringBuilder* scratch = &reader->scratch[buffer];
+
+    if (reader->token.type != JSON_STRING) {
+        return NULL;
+    }
+
+    /*Decoding never makes a string longer, so the raw text sizes the buffer*/
+    scratch->length = 0;
+    appendChars(scratch, reader->token.start, reader->token.length);
+    if (scratch->failed) {
+        return NULL;
+    }
+
+    scratch->length = decodeJSONString(&reader->token, scratch->data);
+    return scratch->data;
+}
+
+/*Skips the value that starts at the current token*/
+static bool skipValue(JSONReader* reader) {
+    if (reader->token.type != JSON_OBJECT_START && reader->token.type != JSON_ARRAY_START) {
+        return reader->token.type != JSON_ERROR;
+    }
+
+    int depth = reader->tokenizer.depth - 1;
+    while (nextToken(reader)) {
+        if (reader->tokenizer.depth == depth) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool readNumber(JSONReader* reader, float* value) {
+    double number;
+
+    /*null stands for a number that was not finite*/
+    if (reader->token.type == JSON_NULL) {
+        *value = NAN;
+        return true;
+    }
+    if (reader->token.type != JSON_NUMBER || parseNumber(reader->token.start, &number) != reader->token.start + reader->token.length) {
+        return false;
+    }
+
+    *value = (float)number;
+    return true;
+}
+
+static bool readUnits(JSONReader* reader, const char** units) {
+    const char* decoded = decodeString(reader, 0);
+
+    if (decoded == NULL) {
+        return false;
+    }
+    return setShapeUnits(NULL, units, decoded, reader->scratch[0].length);
+}
+
+/*Reads an object, calling readMember with the decoded key for every member*/
+static bool readObject(JSONReader* reader, bool (*readMember)(JSONReader*, const char*, void*), void* target) {
+    if (reader->token.type != JSON_OBJECT_START) {
+        return false;
+    }
+
+    while (nextToken(reader) && reader->token.type != JSON_OBJECT_END) {
+        /*Every key the reader knows is short, so longer ones are skipped without decoding*/
+        char key[16] = "";
+        if (reader->token.length < sizeof(key)) {
+            decodeJSONString(&reader->token, key);
+        }
+
+        if (!nextToken(reader) || !readMember(reader, key, target)) {
+            return false;
+        }
+    }
+
+    return reader->token.type == JSON_OBJECT_END;
+}
+
+/*Reads an array, calling readElement for every element*/
+static bool readArray(JSONReader* reader, bool (*readElement)(JSONReader*, void*), void* target) {
+    if (reader->token.type != JSON_ARRAY_START) {
+        return false;
+    }
+
+    while (nextToken(reader) && reader->token.type != JSON_ARRAY_END) {
+        if (!readElement(reader, target)) {
+            return false;
+        }
+    }
+
+    return reader->token.type == JSON_ARRAY_END;
+}
+
+/*An attribute being read: its name and value are decoded into the two scratch buffers*/
+typedef struct {
+    bool hasName;
+    bool hasValue;
+} AttributeFields;
+
+static bool readAttributeMember(JSONReader* reader, const char* key, void* target) {
+    AttributeFields* fields = (AttributeFields*)target;
+
+    if (strcmp(key, "name") == 0) {
+        fields->hasName = (decodeString(reader, 0) != NULL);
+        return fields->hasName;
+    } else if (strcmp(key, "value") == 0) {
+        fields->hasValue = (decodeString(reader, 1) != NULL);
+        return fields->hasValue;
+    }
+    return skipValue(reader);
+}
+
+static bool readAttribute(JSONReader* reader, void* target) {
+    AttributeFields fields = {false, false};
+
+    if (!readObject(reader, &readAttributeMember, &fields) || !fields.hasName) {
+        return false;
+    }
+
+    Attribute* attr = createAttribute(NULL, reader->scratch[0].data, fields.hasValue ? reader->scratch[1].data : "");
+    if (attr == NULL) {
+        return false;
+    }
+    insertBack((List*)target, attr);
+    return true;
+}
+
+static bool readRectMember(JSONReader* reader, const char* key, void* target) {
+    Rectangle* rect = (Rectangle*)target;
+
+    if (strcmp(key, "x") == 0) {
+        return readNumber(reader, &rect->x);
+    } else if (strcmp(key, "y") == 0) {
+        return readNumber(reader, &rect->y);
+    } else if (strcmp(key, "w") == 0) {
+        return readNumber(reader, &rect->width);
+    } else if (strcmp(key, "h") == 0) {
+        return readNumber(reader, &rect->height);
+    } else if (strcmp(key, "units") == 0) {
+        return readUnits(reader, &rect->units);
+    } else if (strcmp(key, "attributes") == 0) {
+        return readArray(reader, &readAttribute, rect->otherAttributes);
+    }
+    return skipValue(reader);
+}
+
+static Rectangle* readRect(JSONReader* reader) {
+    Rectangle* rect = createRectangle(NULL);
+
+    if (rect != NULL && !readObject(reader, &readRectMember, rect)) {
+        deleteRectangle(rect);
+        return NULL;
+    }
+    return rect;
+}
+
+static bool readCircleMember(JSONReader* reader, const char* key, void* target) {
+    Circle* circle = (Circle*)target;
+
+    if (strcmp(key, "cx") == 0) {
+        return readNumber(reader, &circle->cx);
+    } else if (strcmp(key, "cy") == 0) {
+        return readNumber(reader, &circle->cy);
+    } else if (strcmp(key, "r") == 0) {
+        return readNumber(reader, &circle->r);
+    } else if (strcmp(key, "units") == 0) {
+        return readUnits(reader, &circle->units);
+    } else if (strcmp(key, "attributes") == 0) {
+        return readArray(reader, &readAttribute, circle->otherAttributes);
+    }
+    return skipValue(reader);
+}
+
+static Circle* readCircle(JSONReader* reader) {
+    Circle* circle = createCircle(NULL);
+
+    if (circle != NULL && !readObject(reader, &readCircleMember, circle)) {
+        deleteCircle(circle);
+        return NULL;
+    }
+    return circle;
+}
+
+static bool readPathMember(JSONReader* reader, const char* key, void* target) {
+    Path** path = (Path**)target;
+
+    if (strcmp(key, "d") == 0) {
+        const char* data = decodeString(reader, 0);
+        if (data == NULL) {
+            return false;
+        }
+
+        /*The data is stored in the path itself, so the path grows to fit it*/
+        Path* resized = realloc(*path, sizeof(Path) + reader->scratch[0].length + 1);
+        if (resized == NULL) {
+            return false;
+        }
+        strcpy(resized->data, data);
+        *path = resized;
+        return true;
+    } else if (strcmp(key, "attributes") == 0) {
+        return readArray(reader, &readAttribute, (*path)->otherAttributes);
+    }
+    return skipValue(reader);
+}
+
+static bool addRect(JSONReader* reader, void* target) {
+    Rectangle* rect = readRect(reader);
+
+    if (rect == NULL) {
+        return false;
+    }
+    insertBack((List*)target, rect);
+    return true;
+}
+
+static bool addCircle(JSONReader* reader, void* target) {
+    Circle* circle = readCircle(reader);
+
+    if (circle == NULL) {
+        return false;
+    }
+    insertBack((List*)target, circle);
+    return true;
+}
+
+static bool addPath(JSONReader* reader, void* target) {
+    Path* path = createPath(NULL, "");
+
+    if (path == NULL) {
+        return false;
+    }
+    if (!readObject(reader, &readPathMember, &path)) {
+        deletePath(path);
+        return false;
+    }
+    insertBack((List*)target, path);
+    return true;
+}
+
+/*Reads the members shared by groups and the svg element, from "attributes" to "groups"*/
+static bool readComponentMember(JSONReader* reader, const char* key, List* attributes, List* rectangles, List* circles, List* paths, List* groups);
+
+static bool readGroupMember(JSONReader* reader, const char* key, void* target) {
+    Group* group = (Group*)target;
+
+    return readComponentMember(reader, key, group->otherAttributes, group->rectangles, group->circles, group->paths, group->groups);
+}
+
+static bool addGroup(JSONReader* reader, void* target) {
+    Group* group = createGroup(NULL);
+
+    if (group == NULL) {
+        return false;
+    }
+    if (!readObject(reader, &readGroupMember, group)) {
+        deleteGroup(group);
+        return false;
+    }
+    insertBack((List*)target, group);
+    return true;
+}
+
+static bool readComponentMember(JSONReader* reader, const char* key, List* attributes, List* rectangles, List* circles, List* paths, List* groups) {
+    if (strcmp(key, "attributes") == 0) {
+        return readArray(reader, &readAttribute, attributes);
+    } else if (strcmp(key, "rectangles") == 0) {
+        return readArray(reader, &addRect, rectangles);
+    } else if (strcmp(key, "circles") == 0) {
+        return readArray(reader, &addCircle, circles);
+    } else if (strcmp(key, "paths") == 0) {
+        return readArray(reader, &addPath, paths);
+    } else if (strcmp(key, "groups") == 0) {
+        return readArray(reader, &addGroup, groups);
+    }
+    return skipValue(reader);
+}
+
+/*Copies the current string token into a fixed-size field of the SVG struct, truncating it*/
+static bool readField(JSONReader* reader, char* field, size_t size) {
+    const char* value = decodeString(reader, 0);
+
+    if (value == NULL) {
+        return false;
+    }
+    strncpy(field, value, size - 1);
+    field[size - 1] = '\0';
+    return true;
+}
+
+static bool readSVGMember(JSONReader* reader, const char* key, void* target) {
+    SVG* img = (SVG*)target;
+
+    if (strcmp(key, "namespace") == 0) {
+        return readField(reader, img->namespace, sizeof(img->namespace));
+    } else if (strcmp(key, "title") == 0) {
+        return readField(reader, img->title, sizeof(img->title));
+    } else if (strcmp(key, "descr") == 0) {
+        return readField(reader, img->description, sizeof(img->description));
+    }
+    return readComponentMember(reader, key, img->otherAttributes, img->rectangles, img->circles, img->paths, img->groups);
+}
+
+static void startReader(JSONReader* reader, const char* str) {
+    initJSONTokenizer(&reader->tokenizer, str, strlen(str));
+    reader->scratch[0] = createStringBuilder(0);
+    reader->scratch[1] = createStringBuilder(0);
+    nextToken(reader);
+}
+
+/*Frees the scratch buffers.  The value read must have been the whole text*/
+static bool finishReader(JSONReader* reader, bool read) {
+    discardString(&reader->scratch[0]);
+    discardString(&reader->scratch[1]);
+
+    return read && nextToken(reader) && reader->token.type == JSON_END;
+}
+
+/**
+ * @brief Converts a JSON string into an SVG struct.  Accepts the {"title":"","descr":""}
+ * objects of the A2 format as well as the document JSON of writeSVGJSON().
+ * Members that are missing keep their default values, and unknown members are ignored
+ * @param svgString
+ * @return SVG* or NULL if the string is not valid JSON or does not match the format
+ */
+SVG* JSONtoSVG(const char* svgString) {
+    if (svgString == NULL) {
+        return NULL;
+    }
+
+    SVG* img = createSVGObject(NULL);
+    if (img == NULL) {
+        return NULL;
+    }
+    /*Images made from JSON are always SVG*/
+    strcpy(img->namespace, "http://www.w3.org/2000/svg");
+
+    JSONReader reader;
+    startReader(&reader, svgString);
+    if (!finishReader(&reader, readObject(&reader, &readSVGMember, img))) {
+        deleteSVG(img);
+        return NULL;
+    }
+
+    return img;
+}
+
+/**
+ * @brief Converts the JSON of rectToJSON() (or a rectangle of the document JSON) into a Rectangle
+ * @param svgString
+ * @return Rectangle* or NULL if the string is not valid JSON or does not match the format
+ */
+Rectangle* JSONtoRect(const char* svgString) {
+    if (svgString == NULL) {
+        return NULL;
+    }
+
+    JSONReader reader;
+    startReader(&reader, svgString);
+    Rectangle* rect = readRect(&reader);
+
+    if (!finishReader(&reader, rect != NULL)) {
+        deleteRectangle(rect);
+        return NULL;
+    }
+    return rect;
+}
+
+/**
+ * @brief Converts the JSON of circleToJSON() (or a circle of the document JSON) into a Circle
+ * @param svgString
+ * @return Circle* or NULL if the string is not valid JSON or does not match the format
+ */
+Circle* JSONtoCircle(const char* svgString) {
+    if (svgString == NULL) {
+        return NULL;
+    }
+
+    JSONReader reader;
+    startReader(&reader, svgString);
+    Circle* circle = readCircle(&reader);
+
+    if (!finishReader(&reader, circle != NULL)) {
+        deleteCircle(circle);
+        return NULL;
+    }
+    return circle;
+}
@@ -0,0 +1,272 @@
+/**
+ * @file SVGKernels.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief This file contains the vectorized area kernels used by the area queries.
+ * The AVX2 versions are compiled with a target attribute and picked at run time, so the
+ * library itself still builds for (and runs on) any x86-64 CPU
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "SVGHelpers.h"
+#include "SVGKernels.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SVG_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+/*Scalar versions - these define the results every other version has to match*/
+
+static inline float rectArea(float width, float height) {
+    return height * width;
+}
+
+static inline float circleArea(float r) {
+    return (float)((r * r) * PI);
+}
+
+static void rectAreasScalar(const float* width, const float* height, int from, int n, float* out) {
+    for (int i = from; i < n; i++) {
+        out[i] = rectArea(width[i], height[i]);
+    }
+}
+
+static void circleAreasScalar(const float* r, int from, int n, float* out) {
+    for (int i = from; i < n; i++) {
+        out[i] = circleArea(r[i]);
+    }
+}
+
+static int countRectsScalar(const float* width, const float* height, int from, int n, float lo, float hi) {
+    int count = 0;
+
+    for (int i = from; i < n; i++) {
+        float area = rectArea(width[i], height[i]);
+        count += (area > lo && area <= hi);
+    }
+
+    return count;
+}
+
+static int countCirclesScalar(const float* r, int from, int n, float lo, float hi) {
+    int count = 0;
+
+    for (int i = from; i < n; i++) {
+        float area = circleArea(r[i]);
+        count += (area > lo && area <= hi);
+    }
+
+    return count;
+}
+
+#ifdef SVG_KERNELS_X86
+
+/*SSE2 is part of x86-64, so these need no run time check*/
+
+static int countRectsSSE2(const float* width, const float* height, int n, float lo, float hi) {
+    __m128 vLo = _mm_set1_ps(lo);
+    __m128 vHi = _mm_set1_ps(hi);
+    int count = 0;
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m128 area = _mm_mul_ps(_mm_loadu_ps(&height[i]), _mm_loadu_ps(&width[i]));
+        __m128 inRange = _mm_and_ps(_mm_cmpgt_ps(area, vLo), _mm_cmple_ps(area, vHi));
+        count += __builtin_popcount(_mm_movemask_ps(inRange));
+    }
+
+    return count + countRectsScalar(width, height, i, n, lo, hi);
+}
+
+/**
+ * @brief Circle areas of 4 radii, rounded through double exactly like circleArea()
+ * @param r
+ * @return __m128
+ */
+static inline __m128 circleAreas4(__m128 r) {
+    __m128 square = _mm_mul_ps(r, r);
+    __m128d vPI = _mm_set1_pd(PI);
+    __m128d low = _mm_mul_pd(_mm_cvtps_pd(square), vPI);
+    __m128d high = _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(square, square)), vPI);
+
+    return _mm_movelh_ps(_mm_cvtpd_ps(low), _mm_cvtpd_ps(high));
+}
+
+static int countCirclesSSE2(const float* r, int n, float lo, float hi) {
+    __m128 vLo = _mm_set1_ps(lo);
+    __m128 vHi = _mm_set1_ps(hi);
+    int count = 0;
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m128 area = circleAreas4(_mm_loadu_ps(&r[i]));
+        __m128 inRange = _mm_and_ps(_mm_cmpgt_ps(area, vLo), _mm_cmple_ps(area, vHi));
+        count += __builtin_popcount(_mm_movemask_ps(inRange));
+    }
+
+    return count + countCirclesScalar(r, i, n, lo, hi);
+}
+
+static void rectAreasSSE2(const float* width, const float* height, int n, float* out) {
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(&out[i], _mm_mul_ps(_mm_loadu_ps(&height[i]), _mm_loadu_ps(&width[i])));
+    }
+    rectAreasScalar(width, height, i, n, out);
+}
+
+static void circleAreasSSE2(const float* r, int n, float* out) {
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(&out[i], circleAreas4(_mm_loadu_ps(&r[i])));
+    }
+    circleAreasScalar(r, i, n, out);
+}
+
+/*AVX2 versions, only called when the CPU supports AVX2*/
+
+__attribute__((target("avx2")))
+static int countRectsAVX2(const float* width, const float* height, int n, float lo, float hi) {
+    __m256 vLo = _mm256_set1_ps(lo);
+    __m256 vHi = _mm256_set1_ps(hi);
+    int count = 0;
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256 area = _mm256_mul_ps(_mm256_loadu_ps(&height[i]), _mm256_loadu_ps(&width[i]));
+        __m256 inRange = _mm256_and_ps(_mm256_cmp_ps(area, vLo, _CMP_GT_OQ), _mm256_cmp_ps(area, vHi, _CMP_LE_OQ));
+        count += __builtin_popcount(_mm256_movemask_ps(inRange));
+    }
+
+    return count + countRectsScalar(width, height, i, n, lo, hi);
+}
+
+__attribute__((target("avx2")))
+static inline __m256 circleAreas8(__m256 r) {
+    __m256 square = _mm256_mul_ps(r, r);
+    __m256d vPI = _mm256_set1_pd(PI);
+    __m128 low = _mm256_cvtpd_ps(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(square)), vPI));
+    __m128 high = _mm256_cvtpd_ps(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(square, 1)), vPI));
+
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+}
+
+__attribute__((target("avx2")))
+static int countCirclesAVX2(const float* r, int n, float lo, float hi) {
+    __m256 vLo = _mm256_set1_ps(lo);
+    __m256 vHi = _mm256_set1_ps(hi);
+    int count = 0;
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256 area = circleAreas8(_mm256_loadu_ps(&r[i]));
+        __m256 inRange = _mm256_and_ps(_mm256_cmp_ps(area, vLo, _CMP_GT_OQ), _mm256_cmp_ps(area, vHi, _CMP_LE_OQ));
+        count += __builtin_popcount(_mm256_movemask_ps(inRange));
+    }
+
+    return count + countCirclesScalar(r, i, n, lo, hi);
+}
+
+__attribute__((target("avx2")))
+static void rectAreasAVX2(const float* width, const float* height, int n, float* out) {
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(&out[i], _mm256_mul_ps(_mm256_loadu_ps(&height[i]), _mm256_loadu_ps(&width[i])));
+    }
+    rectAreasScalar(width, height, i, n, out);
+}
+
+__attribute__((target("avx2")))
+static void circleAreasAVX2(const float* r, int n, float* out) {
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(&out[i], circleAreas8(_mm256_loadu_ps(&r[i])));
+    }
+    circleAreasScalar(r, i, n, out);
+}
+
+/**
+ * @brief Checks whether the AVX2 kernels can be used on this CPU
+ * @return true
+ * @return false
+ */
+static bool haveAVX2(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif
+
+const char* svgKernelName(void) {
+#ifdef SVG_KERNELS_X86
+    return haveAVX2() ? "avx2" : "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+void computeRectAreas(const float* width, const float* height, int n, float* out) {
+    if (width == NULL || height == NULL || out == NULL || n <= 0) {
+        return ;
+    }
+
+#ifdef SVG_KERNELS_X86
+    if (haveAVX2()) {
+        rectAreasAVX2(width, height, n, out);
+    } else {
+        rectAreasSSE2(width, height, n, out);
+    }
+#else
+    rectAreasScalar(width, height, 0, n, out);
+#endif
+}
+
+void computeCircleAreas(const float* r, int n, float* out) {
+    if (r == NULL || out == NULL || n <= 0) {
+        return ;
+    }
+
+#ifdef SVG_KERNELS_X86
+    if (haveAVX2()) {
+        circleAreasAVX2(r, n, out);
+    } else {
+        circleAreasSSE2(r, n, out);
+    }
+#else
+    circleAreasScalar(r, 0, n, out);
+#endif
+}
+
+int countRectAreasInRange(const float* width, const float* height, int n, float lo, float hi) {
+    if (width == NULL || height == NULL || n <= 0) {
+        return 0;
+    }
+
+#ifdef SVG_KERNELS_X86
+    return haveAVX2() ? countRectsAVX2(width, height, n, lo, hi) : countRectsSSE2(width, height, n, lo, hi);
+#else
+    return countRectsScalar(width, height, 0, n, lo, hi);
+#endif
+}
+
+int countCircleAreasInRange(const float* r, int n, float lo, float hi) {
+    if (r == NULL || n <= 0) {
+        return 0;
+    }
+
+#ifdef SVG_KERNELS_X86
+    return haveAVX2() ? countCirclesAVX2(r, n, lo, hi) : countCirclesSSE2(r, n, lo, hi);
+#else
+    return countCirclesScalar(r, 0, n, lo, hi);
+#endif
+}
@@ -6,7 +6,7 @@
  * accompany the parser and the structs.
  * @date 2022-01-20
  * @copyright Copyright (c) 2022
- * Compilation: gcc -Wall -I/usr/include/libxml2/ -lm -I../include/ main.c SVGParser.c SVGHelpers.c LinkedListAPI.c -lxml2 -ggdb3
+ * Compilation: gcc -Wall -I/usr/include/libxml2/ -lm -I../include/ main.c SVGParser.c SVGHelpers.c SVGSchema.c SVGStream.c SVGArena.c SVGViews.c SVGKernels.c SVGIntern.c SVGPath.c SVGBounds.c SVGSpatial.c SVGJSON.c SVGSnapshot.c SVGWriter.c LinkedListAPI.c VectorListAPI.c StringBuilder.c -lxml2 -ggdb3
  * Run: ./a.out [.xml/.svg file]
  * When running Test Harness: export LD_LIBRARY_PATH=$LD_LIBRARY_PATH:.
  */
@@ -24,30 +24,54 @@
 
 #include "SVGParser.h"
 #include "SVGHelpers.h"
+#include "SVGSchema.h"
+#include "SVGArena.h"
+#include "SVGViews.h"
+#include "SVGKernels.h"
+#include "SVGIntern.h"
+#include "SVGPath.h"
+#include "SVGSpatial.h"
+#include "SVGWriter.h"
 #include "LinkedListAPI.h"
+#include "StringBuilder.h"
 
 #define LIBXML_SCHEMAS_ENABLED
 
 /******************************  LinkedList Functions *******************************/
 
 /*SVG Attributes List functions*/
-char *attributeToString(void* data) {
-    char *tmpStr;
-    Attribute *tmpAttr;
-    int length;
+/*Appends "\n" and the string of every element of a list, the way toString() joins them*/
+static void appendListStrings(StringBuilder* str, List* list, void (*appendData)(StringBuilder*, void*)) {
+    if (list == NULL) {
+        return ;
+    }
+
+    void* elem;
+    ListIterator iter = createIterator(list);
+    while ((elem = nextElement(&iter)) != NULL) {
+        appendChar(str, '\n');
+        appendData(str, elem);
+    }
+}
 
+static void appendAttributeString(StringBuilder* str, void* data) {
+    Attribute *tmpAttr = (Attribute*)data;
+
+    appendString(str, "\tName: ");
+    appendString(str, tmpAttr->name);
+    appendString(str, " Value: ");
+    appendString(str, tmpAttr->value);
+}
+
+char *attributeToString(void* data) {
     if (data == NULL) {
         return NULL;
     }
 
-    tmpAttr = (Attribute*)data;
-
-    length = strlen(tmpAttr->name) + strlen(tmpAttr->value) + strlen("\tName: %s Value: %s");
-    tmpStr = (char *)malloc(sizeof(char) * length);
-    
-    sprintf(tmpStr, "\tName: %s Value: %s", tmpAttr->name, tmpAttr->value);
+    StringBuilder str = createStringBuilder(0);
+    appendAttributeString(&str, data);
 
-    return tmpStr;
+    return finishString(&str);
 }
 
 void deleteAttribute(void* data) {
@@ -59,7 +83,8 @@ void deleteAttribute(void* data) {
 
     tmpAttr = (Attribute*)data;
 
-    if(tmpAttr->name != NULL) {
+    /*Interned names are shared, so only private copies are freed*/
+    if(tmpAttr->name != NULL && !isInternedString(tmpAttr->name)) {
         free(tmpAttr->name);
     }
     free(tmpAttr);
@@ -80,29 +105,22 @@ int compareAttributes(const void* first, const void* second) {
 }
 
 /*Rectangle List functions*/
-char *rectangleToString(void* data) {
-    char *tmpStr;
-    Rectangle *tmpRect;
-    int length;
+static void appendRectangleString(StringBuilder* str, void* data) {
+    Rectangle *tmpRect = (Rectangle*)data;
+
+    appendFormat(str, "x: %0.2f y: %.2f weight: %0.2f height: %.2f", tmpRect->x, tmpRect->y, tmpRect->width, tmpRect->height);
+    appendListStrings(str, tmpRect->otherAttributes, &appendAttributeString);
+}
 
+char *rectangleToString(void* data) {
     if (data == NULL) {
         return NULL;
     }
 
-    tmpRect = (Rectangle*)data;
-
-    char *attrString;
-    attrString = toString(tmpRect->otherAttributes);
- 
-    length = strlen(tmpRect->units) + 40 + 40 + 40 + 40 + 26 + strlen(attrString);
-    tmpStr = (char *)malloc(sizeof(char) * length);
-    
-    sprintf(tmpStr, "x: %0.2f y: %.2f weight: %0.2f height: %.2f", tmpRect->x, tmpRect->y, tmpRect->width, tmpRect->height);
-    strcat(tmpStr, attrString);
-
-    free(attrString);
+    StringBuilder str = createStringBuilder(0);
+    appendRectangleString(&str, data);
 
-    return tmpStr;
+    return finishString(&str);
 }
 
 void deleteRectangle(void* data) {
@@ -112,6 +130,8 @@ void deleteRectangle(void* data) {
 
     Rectangle *tmpRect = (Rectangle *)data;
 
+    /*Units the intern table could not hold are a copy of the rectangle's own*/
+    releaseOwnedString(tmpRect->units);
     freeList(tmpRect->otherAttributes);
     free(tmpRect);
 }
@@ -128,31 +148,22 @@ int compareRectangles(const void* first, const void* second) {
 }
 
 /*Circle List functions*/
-char *circleToString(void* data) {
-    char *tmpStr;
-    int length;
+static void appendCircleString(StringBuilder* str, void* data) {
+    Circle *tmpCirc = (Circle*)data;
+
+    appendFormat(str, "cx: %0.2f cy: %0.2f r: %0.2f", tmpCirc->cx, tmpCirc->cy, tmpCirc->r);
+    appendListStrings(str, tmpCirc->otherAttributes, &appendAttributeString);
+}
 
+char *circleToString(void* data) {
     if (data == NULL) {
         return NULL;
     }
 
-    Circle *tmpCirc = (Circle*)data;
-
-    char *attrString;
-    //char *cxString;
+    StringBuilder str = createStringBuilder(0);
+    appendCircleString(&str, data);
 
-    attrString = toString(tmpCirc->otherAttributes);
-    //sprintf(cxString, "%0.2f", tmpCirc->cx);
- 
-    length = strlen(tmpCirc->units) + 40 + 40 + 40 + 14 + strlen(attrString);
-    tmpStr = (char *)malloc(sizeof(char) * length);
-
-    sprintf(tmpStr, "cx: %0.2f cy: %0.2f r: %0.2f", tmpCirc->cx, tmpCirc->cy, tmpCirc->r);
-    strcat(tmpStr, attrString);
-
-    free(attrString);
-
-    return tmpStr;
+    return finishString(&str);
 }
 
 void deleteCircle(void* data) {
@@ -162,6 +173,7 @@ void deleteCircle(void* data) {
 
     Circle *tmpCirc = (Circle *)data;
 
+    releaseOwnedString(tmpCirc->units);
     freeList(tmpCirc->otherAttributes);
     free(tmpCirc);
 }
@@ -185,33 +197,28 @@ void deletePath(void* data) {
 
     Path *tmpPath = (Path *)data;
 
+    invalidatePathCommands(tmpPath);
     freeList(tmpPath->otherAttributes);
     free(tmpPath);
 }
 
-char* pathToString(void* data) {
-    char *tmpStr;
-    int length;
+static void appendPathString(StringBuilder* str, void* data) {
+    Path *tmpPath = (Path*)data;
+
+    appendString(str, "Data: ");
+    appendString(str, tmpPath->data);
+    appendListStrings(str, tmpPath->otherAttributes, &appendAttributeString);
+}
 
+char* pathToString(void* data) {
     if (data == NULL) {
         return NULL;
     }
 
-    Path *tmpPath = (Path*)data;
-
-    char *attrString;
-    attrString = toString(tmpPath->otherAttributes);
- 
-    length = strlen(tmpPath->data) + 7 + strlen(attrString);
-    //tmpStr = (char *)malloc(sizeof(char) * length);
-    tmpStr = malloc(sizeof(char) * length);
-    
-    sprintf(tmpStr, "Data: %s", tmpPath->data);
-    strcat(tmpStr, attrString);
-
-    free(attrString);
+    StringBuilder str = createStringBuilder(0);
+    appendPathString(&str, data);
 
-    return tmpStr;
+    return finishString(&str);
 }
 
 int comparePaths(const void *first, const void *second) {
@@ -241,41 +248,27 @@ void deleteGroup(void* data) {
     free(tmpGroup);
 }
 
+/*Nested groups are appended into the same string instead of being built and copied level by level*/
+static void appendGroupString(StringBuilder* str, void* data) {
+    Group *group = (Group*)data;
+
+    appendString(str, "\nGroup Attributes:");
+    appendListStrings(str, group->otherAttributes, &appendAttributeString);
+    appendListStrings(str, group->rectangles, &appendRectangleString);
+    appendListStrings(str, group->circles, &appendCircleString);
+    appendListStrings(str, group->paths, &appendPathString);
+    appendListStrings(str, group->groups, &appendGroupString);
+}
+
 char* groupToString(void* data) {
-    char *mainString, *rectString, *circString, *pathString, *groupString, *otherAttrString;
-    Group *group;
-    
     if (data == NULL) {
         return NULL;
     }
 
-    group = (Group*)data;
-
-    rectString = toString(group->rectangles);
-    circString = toString(group->circles);
-    pathString = toString(group->paths);
-    otherAttrString = toString(group->otherAttributes);
-    groupString = toString(group->groups);
-
-    mainString = malloc(sizeof(char) * (strlen(rectString) + strlen(circString) + 
-    strlen(pathString) + strlen(otherAttrString) + strlen(groupString) + 
-    strlen("Group Attributes:") + 3));
-
-    strcpy(mainString, "\nGroup Attributes:");
-    strcat(mainString, otherAttrString);
-    strcat(mainString, rectString);
-    strcat(mainString, circString);
-    strcat(mainString, pathString);
-    strcat(mainString, groupString);
+    StringBuilder str = createStringBuilder(0);
+    appendGroupString(&str, data);
 
-    /*Free the strings*/
-    free(rectString);
-    free(circString);
-    free(pathString);
-    free(otherAttrString);
-    free(groupString);
-    
-    return mainString;
+    return finishString(&str);
 }
 
 int compareGroups(const void *first, const void *second) {
@@ -288,142 +281,55 @@ int compareGroups(const void *first, const void *second) {
 
 /**************************** SVG Accessor Functions ********************************/
 
+/**
+ * @brief Copies a cached component view into a new List
+ * @param view
+ * @param list
+ * @return List*
+ */
+static List* viewToList(const SVGView* view, List* list) {
+    for (int i = 0; view != NULL && i < view->length; i++) {
+        insertBack(list, view->elements[i]);
+    }
+
+    return list;
+}
+
 /*Function that returns a list of all rectangles in the struct*/
 List* getRects(const SVG* img) {
-    List* rectList = NULL;
-    List* groupList;
-
     if (img == NULL) {
-        return rectList;
-    }
-
-    ListIterator rectIterator;
-    ListIterator groupIterator;
-    Group *tmpGroup;
-    void *elem;
-
-    rectList = initializeList(&rectangleToString, &deleteRectangle, &compareRectangles);
-    rectIterator = createIterator(img->rectangles);
-    groupList = getGroups(img);
-    groupIterator = createIterator(groupList);
-    /*Finds all rectangle objects in the SVG object*/
-    while ((elem = nextElement(&rectIterator)) != NULL) {
-        if (elem) {
-            insertBack(rectList, (void*)elem);
-        }
-    }
-    /*Looks through the Group objects for any rectangle objects*/
-    while ((tmpGroup = (Group*)nextElement(&groupIterator)) != NULL) {
-        rectIterator = createIterator(tmpGroup->rectangles);
-        
-        while ((elem = nextElement(&rectIterator)) != NULL) {
-            if (elem) {
-                insertBack(rectList, (void*)elem);
-            }
-        }
+        return NULL;
     }
-    
-    return rectList;
+
+    /*The flattened view is cached, so only the returned List is allocated here*/
+    return viewToList(getRectView(img), initializeList(&rectangleToString, &deleteRectangle, &compareRectangles));
 }
 
 /*Function that returns a list of all circles in the struct*/
 List* getCircles(const SVG* img) {
-    List* circleList = NULL;
-    List* groupList;
-
     if (img == NULL) {
-        return circleList;
-    }
-
-    ListIterator circleIter;
-    ListIterator groupIterator;
-    Group *tmpGroup;
-    void *elem;
-
-    circleList = initializeList(&circleToString, &deleteCircle, &compareCircles);
-    circleIter = createIterator(img->circles);
-    groupList = getGroups(img);
-    groupIterator = createIterator(groupList);
-
-    while ((elem = nextElement(&circleIter)) != NULL) {
-        if (elem) {
-            insertBack(circleList, (void*)elem);
-        }
+        return NULL;
     }
 
-    while ((tmpGroup = (Group*)nextElement(&groupIterator)) != NULL) {
-        circleIter = createIterator(tmpGroup->circles);
-        
-        while ((elem = nextElement(&circleIter)) != NULL) {
-            if (elem) {
-                insertBack(circleList, (void*)elem);
-            }
-        }
-    }
-    
-    return circleList;
+    return viewToList(getCircleView(img), initializeList(&circleToString, &deleteCircle, &compareCircles));
 }
 
 /*Function that returns a list of all paths in the struct*/
 List* getPaths(const SVG* img) {
-    List* pathList = NULL;
-    List* groupList;
-
     if (img == NULL) {
-        return pathList;
-    }
-
-    ListIterator circleIter;
-    ListIterator groupIterator;
-    Group *tmpGroup;
-    void *elem;
-
-    pathList = initializeList(&pathToString, &deletePath, &comparePaths);
-    circleIter = createIterator(img->paths);
-    groupList = getGroups(img);
-    groupIterator = createIterator(groupList);
-
-    while ((elem = nextElement(&circleIter)) != NULL) {
-        if (elem) {
-            insertBack(pathList, (void*)elem);
-        }
+        return NULL;
     }
 
-    while ((tmpGroup = (Group*)nextElement(&groupIterator)) != NULL) {
-        circleIter = createIterator(tmpGroup->paths);
-        
-        while ((elem = nextElement(&circleIter)) != NULL) {
-            if (elem) {
-                insertBack(pathList, (void*)elem);
-            }
-        }
-    }
-    
-    return pathList;
+    return viewToList(getPathView(img), initializeList(&pathToString, &deletePath, &comparePaths));
 }
 
 /*Function that returns a list of all groups in the struct*/
 List* getGroups(const SVG* img) {
-    List* list = NULL;
-    Group *tmpGroup;
-
     if (img == NULL) {
-        return list;
-    }
-
-    void* elem;
-    list = initializeList(&groupToString, &deleteGroup, &compareGroups);
-    ListIterator groupIter = createIterator(img->groups);
-    
-    while ((elem = nextElement(&groupIter)) != NULL) {
-        if (elem != NULL) {
-            tmpGroup = (Group*)elem;
-            insertBack(list, (void*)tmpGroup);
-        } 
-        parseGroupWithinGroup(list, (Group*)elem);
+        return NULL;
     }
 
-    return list;
+    return viewToList(getGroupView(img), initializeList(&groupToString, &deleteGroup, &compareGroups));
 }
 
 /***************************** SVG Summary Functions ********************************/
@@ -434,23 +340,29 @@ int numRectsWithArea(const SVG* img, float area) {
         return 0;
     }
     /*Declare variables*/
-    List* rects;
-    ListIterator rectIter;
-    void* elem;
+    int indexed = indexedRectsWithArea(img, area);
+    if (indexed >= 0) {
+        return indexed;
+    }
+
+    const SVGRectColumns* rects = getRectColumns(img);
+    double target = ceil(area);
     int count = 0;
 
-    rects = getRects(img);
-    rectIter = createIterator(rects);
-    /*Iterate through the list and counter++ when area is equal to the rectangle area*/
-    while ((elem = nextElement(&rectIter)) != NULL) {
-        float rectArea = ((Rectangle*)elem)->height * ((Rectangle*)elem)->width;
-        if (ceil(rectArea) == ceil(area)) {
+    /*ceil(rectArea) == target exactly when target - 1 < rectArea <= target, which the
+    vectorized kernel can check as long as both bounds are exact floats*/
+    if (isfinite(target) && (float)target == target && (float)(target - 1) == target - 1) {
+        return countRectAreasInRange(rects->width, rects->height, rects->length, (float)(target - 1), (float)target);
+    }
+
+    /*Iterate through the columns and counter++ when area is equal to the rectangle area*/
+    for (int i = 0; i < rects->length; i++) {
+        float rectArea = rects->height[i] * rects->width[i];
+        if (ceil(rectArea) == target) {
             count++;
         }
     }
 
-    /*Free and return the length*/
-    free(rects);
     return count;
 }
 
@@ -460,44 +372,54 @@ int numCirclesWithArea(const SVG* img, float area) {
         return 0;
     }
     /*Declare variables*/
+    int indexed = indexedCirclesWithArea(img, area);
+    if (indexed >= 0) {
+        return indexed;
+    }
+
+    const SVGCircleColumns* circles = getCircleColumns(img);
+    double target = ceil(area);
     int count = 0;
-    void *elem;
-    List *circleList = getCircles(img);
-    ListIterator iterator = createIterator(circleList);
 
-    /*Iterate through the list and counter++ when area is equal to the circle area*/
-    while ((elem = nextElement(&iterator))) {
-        float circleArea = ((Circle*)elem)->r * ((Circle*)elem)->r * PI;
+    /*Same bounds as in numRectsWithArea()*/
+    if (isfinite(target) && (float)target == target && (float)(target - 1) == target - 1) {
+        return countCircleAreasInRange(circles->r, circles->length, (float)(target - 1), (float)target);
+    }
+
+    /*Iterate through the columns and counter++ when area is equal to the circle area*/
+    for (int i = 0; i < circles->length; i++) {
+        float circleArea = circles->r[i] * circles->r[i] * PI;
         
-        if (ceil(area) == ceil(circleArea)) {
+        if (ceil(circleArea) == target) {
             count++;
         }
     }
 
-    /*Free and return the length*/
-    free(circleList);
     return count;
 }
 
 int numPathsWithdata(const SVG* img, const char* data) {
     /*If NULL, return NULL*/
-    if (img == NULL || strlen(data) < 0) {
+    if (img == NULL || data == NULL) {
         return 0;
     }
+    /*Counted through the path data hash index, which is built once per change*/
+    int indexed = indexedPathsWithData(img, data);
+    if (indexed >= 0) {
+        return indexed;
+    }
+
     /*Declare variables*/
     int count = 0;
-    void *pathElement;
-    List *pathList = getPaths(img);
-    ListIterator iterator = createIterator(pathList);
-    /*Iterate through the list and counter++ when data is equal to the path data*/
-    while ((pathElement = nextElement(&iterator))) {
-        if (strcmp(((Path*)pathElement)->data, data) == 0) {
+    const SVGView* paths = getPathView(img);
+
+    /*Iterate through the view and counter++ when data is equal to the path data*/
+    for (int i = 0; i < paths->length; i++) {
+        if (strcmp(((Path*)paths->elements[i])->data, data) == 0) {
             count++;
         }
     }
 
-    /*Free and return the length*/
-    free(pathList);
     return count;
 }
 
@@ -509,13 +431,11 @@ int numGroupsWithLen(const SVG* img, int len) {
     /*Declare variables*/
     int counter = 0;
     int numOfGroups;
-    void *elem;
-    List *groupList = getGroups(img);
-    ListIterator iterator = createIterator(groupList);
+    const SVGView* groups = getGroupView(img);
     Group *groupObj;
 
-    while ((elem = nextElement(&iterator))) {
-        groupObj = (Group*)elem;
+    for (int i = 0; i < groups->length; i++) {
+        groupObj = (Group*)groups->elements[i];
         numOfGroups = 0;
         /*Get current length of the objects present in group object*/
         numOfGroups += groupObj->circles->length;
@@ -528,61 +448,136 @@ int numGroupsWithLen(const SVG* img, int len) {
         }
     }
 
-    /*Free and return the length*/
-    free(groupList);
     return counter;
 }
 
 int numAttr(const SVG* img) {
-    int counter = 0;
-
     if (img == NULL) {
-        return counter;
+        return 0;
     }
 
-    ListIterator listIter;
-    void *elem;
+    /*The total is kept up to date by the builders, addComponent and setAttribute*/
+    return getSVGStats(img)->numAttributes;
+}
 
-    List* rectList = getRects(img);
-    List* circleList = getCircles(img);
-    List* pathList = getPaths(img);
-    List* groupList = getGroups(img);
-    /*Starts off with the other attributes of the SVG file-*/
-    counter = getLength(img->otherAttributes);
+/********************************* A2 Functions *************************************/
 
-    /*Calculates and adds all individual objects other attributes*/
-    /*For object Rectangle*/
-    listIter = createIterator(rectList);
-    while ((elem = nextElement(&listIter)) != NULL) {
-        counter += getLength(((Rectangle*)elem)->otherAttributes);
-    }
-    /*For object Circle*/
-    listIter = createIterator(circleList);
-    while ((elem = nextElement(&listIter)) != NULL) {
-        counter += getLength(((Circle*)elem)->otherAttributes);
+/**
+ * @brief Hands an attribute that was just appended to list over to the arena of img.
+ * Only arena lists need this - a heap list (e.g. of a component added with addComponent)
+ * already deletes its attributes itself, so adopting them too would free them twice
+ * @param img 
+ * @param list 
+ * @param newAttribute 
+ */
+static void adoptAttribute(SVG* img, List* list, Attribute* newAttribute) {
+    if (list->allocator != NULL && isLibrarySVG(img)) {
+        arenaAdopt(img->arena, newAttribute, &deleteAttribute);
     }
-    /*For object Path*/
-    listIter = createIterator(pathList);
-    while ((elem = nextElement(&listIter)) != NULL) {
-        counter += getLength(((Path*)elem)->otherAttributes);
+}
+
+/**
+ * @brief Adds to the totals of img.  Structs built by hand keep no totals (getSVGStats()
+ * counts them on every call), so their stats field is left alone
+ * @param img 
+ * @param numRect 
+ * @param numCirc 
+ * @param numPaths 
+ * @param numAttributes 
+ */
+static void addToStats(SVG* img, int numRect, int numCirc, int numPaths, int numAttributes) {
+    if (isLibrarySVG(img)) {
+        img->stats.numRect += numRect;
+        img->stats.numCirc += numCirc;
+        img->stats.numPaths += numPaths;
+        img->stats.numAttributes += numAttributes;
     }
-    /*For object Group*/
-    listIter = createIterator(groupList);
-    while ((elem = nextElement(&listIter)) != NULL) {
-        counter += getLength(((Group*)elem)->otherAttributes);
+}
+
+/**
+ * @brief Sets or updates one attribute of an element that is already known to belong to img
+ * @param img 
+ * @param elemType 
+ * @param element - the SVG itself for SVG_IMG, otherwise the Rectangle, Circle, Path or Group
+ * @param newAttribute 
+ */
+static void applyAttribute(SVG* img, elementType elemType, void* element, Attribute* newAttribute) {
+    /*Names the parser handles itself are interned, so they are told apart by pointer*/
+    const char* name = findInternedString(newAttribute->name);
+
+    /*Ids are indexed separately, so only id changes make the id index stale*/
+    if (name == SVG_NAME_ID && isLibrarySVG(img)) {
+        img->idGeneration++;
     }
 
-    /*Free the lists*/
-    free(pathList);
-    free(circleList);
-    free(rectList);
-    free(groupList);
+    if (elemType == SVG_IMG) {
+        if (setOtherAttribute(img->otherAttributes, newAttribute)) {
+            /*Appended to the otherAttributes of the SVG*/
+            adoptAttribute(img, img->otherAttributes, newAttribute);
+            addToStats(img, 0, 0, 0, 1);
+        }
+    } else if (elemType == CIRC) {
+        Circle* circ = (Circle*)element;
+
+        if (name == SVG_NAME_CX) {
+            /*Change cx value based on attribute*/
+            parseLength(newAttribute->value, &circ->cx, NULL);
+        } else if (name == SVG_NAME_CY) {
+            /*Change cy value based on attribute*/
+            parseLength(newAttribute->value, &circ->cy, NULL);
+        } else if (name == SVG_NAME_R) {
+            /*Change r value based on attribute*/
+            parseLength(newAttribute->value, &circ->r, NULL);
+        } else if (setOtherAttribute(circ->otherAttributes, newAttribute)) {
+            /*Appended to the otherAttributes of Circle*/
+            adoptAttribute(img, circ->otherAttributes, newAttribute);
+            addToStats(img, 0, 0, 0, 1);
+        }
+    } else if (elemType == RECT) {
+        Rectangle* rect = (Rectangle*)element;
+
+        if (name == SVG_NAME_X) {
+            /*Change x value based on attribute*/
+            parseLength(newAttribute->value, &rect->x, NULL);
+        } else if (name == SVG_NAME_Y) {
+            /*Change y value based on attribute*/
+            parseLength(newAttribute->value, &rect->y, NULL);
+        } else if (name == SVG_NAME_WIDTH) {
+            /*Change width value based on attribute*/
+            parseLength(newAttribute->value, &rect->width, NULL);
+        } else if (name == SVG_NAME_HEIGHT) {
+            /*Change height value based on attribute*/
+            parseLength(newAttribute->value, &rect->height, NULL);
+        } else if (setOtherAttribute(rect->otherAttributes, newAttribute)) {
+            /*Appended to the otherAttributes of Rectangle*/
+            adoptAttribute(img, rect->otherAttributes, newAttribute);
+            addToStats(img, 0, 0, 0, 1);
+        }
+    } else if (elemType == PATH) {
+        Path* path = (Path*)element;
+
+        if (name == SVG_NAME_D) {
+            /*Change data value based on attribute*/
+            char tmpStr[1000];
+            sprintf(tmpStr, newAttribute->value);
+            strcpy(path->data, tmpStr);
+            invalidatePathCommands(path);
+        } else if (setOtherAttribute(path->otherAttributes, newAttribute)) {
+            /*Appended to the otherAttributes of path*/
+            adoptAttribute(img, path->otherAttributes, newAttribute);
+            addToStats(img, 0, 0, 0, 1);
+        }
+    } else if (elemType == GROUP) {
+        Group* group = (Group*)element;
 
-    return counter;
+        if (group->otherAttributes != NULL && setOtherAttribute(group->otherAttributes, newAttribute)) {
+            /*Appended to the otherAttributes of group*/
+            adoptAttribute(img, group->otherAttributes, newAttribute);
+            addToStats(img, 0, 0, 0, 1);
+        }
+    }
 }
 
-/********************************* A2 Functions *************************************/
-
 /**
  * @brief Function to setting an attribute in an SVG or component
  * @param img 
@@ -605,190 +600,80 @@ bool setAttribute(SVG* img, elementType elemType, int elemIndex, Attribute* newA
     if (elemType != RECT && elemType != CIRC && elemType != PATH && elemType != GROUP && elemType != SVG_IMG) {
         return false;
     }
-    
-    /*Sets/Updates attributes based on RECT*/
-    if (elemType == SVG_IMG || elemType == 0) {
-        // if(strcmp(newAttribute->name,"title") == 0){
-        //     strncpy(img->title, newAttribute->value, 255);
-        //     (img->title)[255] = '\0';
-        // } else if (strcmp(newAttribute->name,"desc") == 0){
-        //     strncpy(img->title, newAttribute->value, 255);
-        //     (img->description)[255] = '\0';
-        // } else {
-            /*If the attribute with the specified name exists in list, update the value*/
-            ListIterator iter = createIterator(img->otherAttributes);
-            void* elem;
-        
-            while ((elem = nextElement(&iter)) != NULL) {
-                Attribute* otherAttr = (Attribute*)elem;
-
-                if (strcmp(newAttribute->name, otherAttr->name) == 0) {
-                    char tmpStr[1000];
-                    sprintf(tmpStr, newAttribute->value);
-                    //free(otherAttr->value);
-                    strcpy(otherAttr->value, tmpStr);
-
-                    if (newAttribute == NULL) {
-                        deleteAttribute(newAttribute);
-                    }
-                    
-                    return true;
-                }
-            }
-            /*If the attribute with the specified name does not exist in list, append to the list*/
-            insertBack(img->otherAttributes, (void*)newAttribute);
-        //}
 
-        if (newAttribute == NULL) {
-            deleteAttribute(newAttribute);
-        }
-        /*Successful, return true*/
+    /*Sets/Updates attributes of the SVG itself*/
+    if (elemType == SVG_IMG) {
+        /*Any data cached from the old attribute values is stale from now on*/
+        invalidateSVGViews(img);
+        applyAttribute(img, SVG_IMG, img, newAttribute);
+        updateSpatialIndex(img, (SVGElementHandle){SVG_IMG, img});
         return true;
-    } else if (elemType == CIRC) {
-        if (elemIndex > getLength(img->circles) - 1) {
-            return false;
-        }
-
-        ListIterator iter = createIterator(img->circles);
-        Circle* circ;
-        void *elem;
-
-        int i;
-        for (i = 0; (elem = nextElement(&iter)) != NULL; i++) {
-            if (i == elemIndex) {
-                circ = (Circle*)elem;
-                //printf("Before: \t%s\n", circleToString(circ));
-                if (strcmp(newAttribute->name, "cx") == 0) {
-                    /*Change cx value based on attribute*/
-                    circ->cx = atof(newAttribute->value);
-                } else if (strcmp(newAttribute->name, "cy") == 0) {
-                    /*Change cy value based on attribute*/
-                    circ->cy = atof(newAttribute->value);
-                } else if (strcmp(newAttribute->name, "r") == 0) {
-                    /*Change r value based on attribute*/
-                    circ->r = atof(newAttribute->value);
-                } else {
-                    /*Update or append otherAttributes of Circle*/
-                    setOtherAttribute(circ->otherAttributes, newAttribute);
-                }
-                //printf("After: \t\t%s\n\n", circleToString(circ));
-            }
-        }
+    }
 
-        if (newAttribute == NULL) {
-            deleteAttribute(newAttribute);
-        }
-        /*Successful, return true*/
-        return true;
-    /*Sets/Updates attributes based on PATH*/
+    /*Otherwise the element is found by its index in the top level list of its type*/
+    List* list = NULL;
+    if (elemType == CIRC) {
+        list = img->circles;
     } else if (elemType == RECT) {
-        if (elemIndex > getLength(img->rectangles) - 1) {
-            return false;
-        }
+        list = img->rectangles;
+    } else if (elemType == PATH) {
+        list = img->paths;
+    } else {
+        list = img->groups;
+    }
 
-        ListIterator iter = createIterator(img->rectangles);
-        Rectangle* rect;
-        void *elem;
-
-        int i;
-        for (i = 0; (elem = nextElement(&iter)) != NULL; i++) {
-            if (i == elemIndex) {
-                //printf("Index: %d - Num of rectangles: %d\n", elemIndex, getLength(img->rectangles));
-                //printf("%s\t%s\n", newAttribute->name, newAttribute->value);
-                
-                rect = (Rectangle*)elem;
-                //printf("Before: \t%s\n", rectangleToString(rect));
-                if (strcmp(newAttribute->name, "x") == 0) {
-                    /*Change x value based on attribute*/
-                    rect->x = atof(newAttribute->value);
-                } else if (strcmp(newAttribute->name, "y") == 0) {
-                    /*Change y value based on attribute*/
-                    rect->y = atof(newAttribute->value);
-                } else if (strcmp(newAttribute->name, "width") == 0) {
-                    /*Change width value based on attribute*/
-                    rect->width = atof(newAttribute->value);
-                } else if (strcmp(newAttribute->name, "height") == 0) {
-                    /*Change height value based on attribute*/
-                    rect->height = atof(newAttribute->value);
-                } else {
-                    /*Update or append otherAttributes of Rectangle*/
-                    setOtherAttribute(rect->otherAttributes, newAttribute);
-                }
-                //printf("After: \t\t%d = %s\n\n", i, rectangleToString(rect));
-            }
-        }
+    if (elemIndex > getLength(list) - 1) {
+        return false;
+    }
 
-        if (newAttribute == NULL) {
-            deleteAttribute(newAttribute);
-        }
-        /*Successful, return true*/
-        return true;
-    /*Sets/Updates attributes based on CIRC*/
-    } else if (elemType == PATH) {
-        if (elemIndex > getLength(img->paths) - 1) {
-            return false;
-        }
+    invalidateSVGViews(img);
+    /*An index of -1 matches no element, which is not an error*/
+    void* element = getElementAt(list, elemIndex);
+    if (element != NULL) {
+        applyAttribute(img, elemType, element, newAttribute);
+    }
+    updateSpatialIndex(img, (SVGElementHandle){elemType, element});
 
-        ListIterator iter = createIterator(img->paths);
-        Path* path;
-        void *elem;
-
-        int i;
-        for (i = 0; (elem = nextElement(&iter)) != NULL; i++) {
-            if (i == elemIndex) {
-                path = (Path*)elem;
-                //printf("Before: \t%s\n", pathToString(path));
-                if (strcmp(newAttribute->name, "d") == 0) {
-                    /*Change data value based on attribute*/
-                    char tmpStr[1000];
-                    sprintf(tmpStr, newAttribute->value);
-                    strcpy(path->data, tmpStr);
-                } else {
-                    /*Update or append otherAttributes of path*/
-                    setOtherAttribute(path->otherAttributes, newAttribute);
-                }
-                //printf("After: \t\t%s\n\n", pathToString(path));
-            }
-        }
+    /*Successful, return true*/
+    return true;
+}
 
-        if (newAttribute == NULL) {
-            deleteAttribute(newAttribute);
-        }
-        /*Successful, return true*/
-        return true;
-    /*Sets/Updates attributes based on GROUP*/
-    } else if (elemType == GROUP) {
-        if (elemIndex > getLength(img->groups) - 1) {
-            return false;
-        }
+/**
+ * @brief Sets an attribute of an element found through getElementById() or the views
+ * @param img 
+ * @param handle 
+ * @param newAttribute 
+ * @return true 
+ * @return false 
+ */
+bool setElementAttribute(SVG* img, SVGElementHandle handle, Attribute* newAttribute) {
+    if (img == NULL || handle.element == NULL || newAttribute == NULL || newAttribute->name == NULL) {
+        return false;
+    }
 
-        ListIterator iter = createIterator(img->groups);
-        Group* group;
-        void *elem;
-
-        int i;
-        for (i = 0; (elem = nextElement(&iter)) != NULL; i++) {
-            if (i == elemIndex) {
-                group = (Group*)elem;
-                //printf("Before: \t%s\n", groupToString(group));
-                if (group->otherAttributes != NULL) {
-                    /*Update or append otherAttributes of group*/
-                    setOtherAttribute(group->otherAttributes, newAttribute);
-                }
-                //printf("After: \t\t%s\n\n", groupToString(group));
-            }
-        }
+    invalidateSVGViews(img);
+    applyAttribute(img, handle.type, handle.element, newAttribute);
+    updateSpatialIndex(img, handle);
 
-        if (newAttribute == NULL) {
-            deleteAttribute(newAttribute);
-        }
-        /*Successful, return true*/
-        return true;
-    /*Sets/Updates attributes based on SVG_IMG*/
-    } else {
-        /*Otherwise, return false*/
+    return true;
+}
+
+/**
+ * @brief Sets an attribute of the element with the given id, anywhere in the struct
+ * @param img 
+ * @param id 
+ * @param newAttribute 
+ * @return true 
+ * @return false if there is no element with that id
+ */
+bool setAttributeById(SVG* img, const char* id, Attribute* newAttribute) {
+    SVGElementHandle handle = getElementById(img, id);
+
+    if (handle.element == NULL) {
         return false;
     }
+
+    return setElementAttribute(img, handle, newAttribute);
 }
 
 /**
@@ -802,489 +687,233 @@ void addComponent(SVG* img, elementType type, void* newElement) {
     if (img == NULL || newElement == NULL) {
         return ;
     } else {
+        /*Structs built by hand have no arena, whatever their arena field holds*/
+        SVGArena* arena = isLibrarySVG(img) ? img->arena : NULL;
+
+        /*Any cached views of the components are stale from now on*/
+        invalidateSVGViews(img);
+        if (isLibrarySVG(img)) {
+            img->idGeneration++;
+        }
+
     /*Otherwise will check what element type the Enum Value is*/
         if (type == RECT && img->rectangles != NULL) {
             insertBack(img->rectangles, newElement);
+            /*Arena lists never free their data, so the arena takes ownership of the new element*/
+            arenaAdopt(arena, newElement, &deleteRectangle);
+            addToStats(img, 1, 0, 0, getLength(((Rectangle*)newElement)->otherAttributes));
         } else if (type == CIRC && img->circles != NULL) {
             insertBack(img->circles, newElement);
+            arenaAdopt(arena, newElement, &deleteCircle);
+            addToStats(img, 0, 1, 0, getLength(((Circle*)newElement)->otherAttributes));
         } else if (type == PATH && img->paths != NULL) {
+            /*Paths built by the caller have never been compiled, and may leave the field unset*/
+            ((Path*)newElement)->commands = NULL;
             insertBack(img->paths, newElement);
+            arenaAdopt(arena, newElement, &deletePath);
+            addToStats(img, 0, 0, 1, getLength(((Path*)newElement)->otherAttributes));
         } else {
             return ;
         }
+
+        /*The spatial index (if enabled) takes the new element in place instead of being reloaded*/
+        updateSpatialIndex(img, (SVGElementHandle){type, newElement});
     }
 }
 
-char* attrToJSON(const Attribute *a) {
-    char* jsonAttr = NULL;
-    /*Check for object to see if its NULL*/
-    if (a == NULL) {
-        return NULL;
-        jsonAttr = malloc(sizeof(char) * (strlen("{}") + 1));
-        strcpy(jsonAttr, "{}");
-        /*Returns empty string {}*/
-        return jsonAttr;
-    }
+/*Number of attributes in an otherAttributes list, which may be NULL*/
+static int numAttributes(List* list) {
+    return (list == NULL) ? 0 : getLength(list);
+}
 
-    char attrName[1000];
-    char attrValue[1000];
-    Attribute* attr = (Attribute*)a;
+static void appendAttributeJSON(StringBuilder* json, const void* data) {
+    const Attribute* attr = (const Attribute*)data;
 
-    /*Puts number of attributes in Attributes into string*/
+    /*An attribute without a name has nothing to show*/
     if (attr->name == NULL) {
-        return jsonAttr;
+        appendString(json, "{}");
+        return ;
     }
 
-    /*Put values of attribute name and value into string*/
-    sprintf(attrName,"%s", attr->name);
-    sprintf(attrValue,"%s", attr->value);
+    appendString(json, "{\"name\":\"");
+    appendString(json, attr->name);
+    appendString(json, "\",\"value\":\"");
+    appendString(json, attr->value);
+    appendString(json, "\"}");
+}
 
-    /*Malloc proper amount of memory for string, then catonate whole string in JSON format*/
-    jsonAttr = malloc(sizeof(char) * (strlen("{\"name\":\"\",\"value\":\"\"}") + strlen(attrName) + strlen(attrValue) + 1));
-    sprintf(jsonAttr, "{\"name\":\"%s\",\"value\":\"%s\"}", attrName, attrValue);
+static void appendCircleJSON(StringBuilder* json, const void* data) {
+    const Circle* circle = (const Circle*)data;
 
-    return jsonAttr;
+    appendFormat(json, "{\"cx\":%.2f,\"cy\":%.2f,\"r\":%.2f,\"numAttr\":%d,\"units\":\"", circle->cx, circle->cy, circle->r, numAttributes(circle->otherAttributes));
+    appendString(json, circle->units);
+    appendString(json, "\"}");
+}
+
+static void appendRectJSON(StringBuilder* json, const void* data) {
+    const Rectangle* rect = (const Rectangle*)data;
+
+    appendFormat(json, "{\"x\":%.2f,\"y\":%.2f,\"w\":%.2f,\"h\":%.2f,\"numAttr\":%d,\"units\":\"", rect->x, rect->y, rect->width, rect->height, numAttributes(rect->otherAttributes));
+    appendString(json, rect->units);
+    appendString(json, "\"}");
+}
+
+static void appendPathJSON(StringBuilder* json, const void* data) {
+    const Path* path = (const Path*)data;
+
+    appendString(json, "{\"d\":\"");
+    appendString(json, path->data);
+    appendFormat(json, "\",\"numAttr\":%d}", numAttributes(path->otherAttributes));
+}
+
+static void appendGroupJSON(StringBuilder* json, const void* data) {
+    const Group* group = (const Group*)data;
+
+    /*Children are the direct rectangles, circles, paths and groups*/
+    int children = getLength(group->rectangles) + getLength(group->circles) + getLength(group->paths) + getLength(group->groups);
+    appendFormat(json, "{\"children\":%d,\"numAttr\":%d}", children, numAttributes(group->otherAttributes));
+}
+
+/*Appends every element of a list as a JSON array, [] if the list is NULL or empty*/
+static char* listToJSON(const List* list, void (*appendJSON)(StringBuilder*, const void*)) {
+    List* tempList = (List*)list;
+    /*Each element takes a few dozen characters, so most arrays never need to grow*/
+    StringBuilder json = createStringBuilder((list == NULL) ? 2 : (size_t)getLength(tempList) * 64 + 2);
+
+    appendChar(&json, '[');
+    if (list != NULL) {
+        void* elem;
+        ListIterator iter = createIterator(tempList);
+        bool first = true;
+
+        while ((elem = nextElement(&iter)) != NULL) {
+            if (!first) {
+                appendChar(&json, ',');
+            }
+            appendJSON(&json, elem);
+            first = false;
+        }
+    }
+    appendChar(&json, ']');
+
+    return finishString(&json);
+}
+
+char* attrToJSON(const Attribute *a) {
+    /*NULL or nameless attributes have no JSON*/
+    if (a == NULL || a->name == NULL) {
+        return NULL;
+    }
+
+    StringBuilder json = createStringBuilder(0);
+    appendAttributeJSON(&json, a);
+
+    return finishString(&json);
 }
 
 char* circleToJSON(const Circle *c) {
-    char* jsonCirc = NULL;
+    StringBuilder json = createStringBuilder(0);
 
-    /*Check for object to see if its NULL*/
+    /*Returns the empty object {} for NULL*/
     if (c == NULL) {
-        jsonCirc = malloc(sizeof(char) * (strlen("{}") + 1));
-        strcpy(jsonCirc, "{}");
-        /*Returns empty string {}*/
-        return jsonCirc;
-    }
-
-    /*Otherwise will return newly allocated string in proper format*/
-    char xVal[1000];
-    char yVal[1000];
-    char rVal[1000];
-    char attVal[1000];
-    char unitStr[1000];
-    Circle* circle = (Circle*)c;
-
-    /*Put values of x, y, and radius into string*/
-    sprintf(xVal,"%.2f", circle->cx);
-    sprintf(yVal,"%.2f", circle->cy);
-    sprintf(rVal,"%.2f", circle->r);
-    /*Puts units of circle into string*/
-    if (strcmp(circle->units, "") == 0) {
-        strcpy(unitStr, "");
+        appendString(&json, "{}");
     } else {
-        sprintf(unitStr, "%s", circle->units);
-    }
-    /*Puts number of attributes in circle into string*/
-    List* temp = (List*)circle->otherAttributes;
-    if (circle->otherAttributes == NULL || getLength(temp) == 0) {
-        strcpy(attVal, "0");
-    } else {
-        sprintf(attVal, "%d", getLength(circle->otherAttributes));
+        appendCircleJSON(&json, c);
     }
 
-    /*Malloc proper amount of memory for string, then catonate whole string in JSON format*/
-    jsonCirc = malloc(sizeof(char) * (strlen("{\"cx\":,\"cy\":,\"r\":,\"numAttr\":,\"units\":\"\"}") + strlen(unitStr) + strlen(xVal) + strlen(yVal) + strlen(rVal) + strlen(attVal) + 1));
-    sprintf(jsonCirc, "{\"cx\":%s,\"cy\":%s,\"r\":%s,\"numAttr\":%s,\"units\":\"%s\"}", xVal, yVal, rVal, attVal, unitStr);
-
-    return jsonCirc;
+    return finishString(&json);
 }
 
 char* rectToJSON(const Rectangle *r) {
-    char* jsonRect = NULL;
+    StringBuilder json = createStringBuilder(0);
 
-    /*Check for object to see if its NULL*/
+    /*Returns the empty object {} for NULL*/
     if (r == NULL) {
-        jsonRect = malloc(sizeof(char) * (strlen("{}") + 1));
-        strcpy(jsonRect, "{}");
-        /*Returns empty string {}*/
-        return jsonRect;
-    }
-
-    /*Otherwise will return newly allocated string in proper format*/
-    char xVal[1000];
-    char yVal[1000];
-    char wVal[1000];
-    char hVal[1000];
-    char attVal[1000];
-    char unitStr[1000];
-    Rectangle* rect = (Rectangle*)r;
-
-    /*Put values of x, y, height, and width into string*/
-    sprintf(xVal,"%.2f", rect->x);
-    sprintf(yVal,"%.2f", rect->y);
-    sprintf(wVal,"%.2f", rect->width);
-    sprintf(hVal,"%.2f", rect->height);
-    /*Puts units of Rectangle into string*/
-    if (strcmp(rect->units, "") == 0) {
-        strcpy(unitStr, "");
+        appendString(&json, "{}");
     } else {
-        sprintf(unitStr, "%s", rect->units);
+        appendRectJSON(&json, r);
     }
-    /*Puts number of attributes in Rectangle into string*/
-    List* temp = (List*)rect->otherAttributes;
-    if (rect->otherAttributes == NULL || getLength(temp) == 0) {
-        strcpy(attVal, "0");
-    } else {
-        sprintf(attVal, "%d", getLength(rect->otherAttributes));
-    }
-
-    /*Malloc proper amount of memory for string, then catonate whole string in JSON format*/
-    jsonRect = malloc(sizeof(char) * (strlen("{\"x\":,\"y\":,\"w\":,\"h\":,\"numAttr\":,\"units\":\"\"}") + strlen(unitStr) + strlen(xVal) + strlen(yVal) + strlen(wVal) + strlen(hVal) + strlen(attVal) + 1));
-    sprintf(jsonRect, "{\"x\":%s,\"y\":%s,\"w\":%s,\"h\":%s,\"numAttr\":%s,\"units\":\"%s\"}", xVal, yVal, wVal, hVal, attVal, unitStr);
 
-    return jsonRect;
+    return finishString(&json);
 }
 
 char* pathToJSON(const Path *p) {
-    char* jsonPath = NULL;
+    StringBuilder json = createStringBuilder(0);
 
-    /*Check for object to see if its NULL*/
+    /*Returns the empty object {} for NULL*/
     if (p == NULL) {
-        jsonPath = malloc(sizeof(char) * (strlen("{}") + 1));
-        strcpy(jsonPath, "{}");
-        /*Returns empty string {}*/
-        return jsonPath;
-    }
-
-    /*Otherwise will return newly allocated string in proper format*/
-    Path* path = (Path*)p;
-    int length = strlen(path->data);
-    char dVal[length];
-    char attVal[1000];
-
-    /*Put value of data into string*/
-    sprintf(dVal,"%s", path->data);
-    /*Puts number of attributes in Path into string*/
-    List* temp = (List*)path->otherAttributes;
-    if (path->otherAttributes == NULL || getLength(temp) == 0) {
-        strcpy(attVal, "0");
+        appendString(&json, "{}");
     } else {
-        sprintf(attVal, "%d", getLength(path->otherAttributes));
+        appendPathJSON(&json, p);
     }
 
-    /*Malloc proper amount of memory for string, then catonate whole string in JSON format*/
-    jsonPath = malloc(sizeof(char) * (strlen("{\"d\":\"\",\"numAttr\":}") + strlen(dVal) + strlen(attVal) + 1));
-    sprintf(jsonPath, "{\"d\":\"%s\",\"numAttr\":%s}", dVal, attVal);
-
-    return jsonPath;
+    return finishString(&json);
 }
 
 char* groupToJSON(const Group *g) {
-    char* jsonGroup = NULL;
+    StringBuilder json = createStringBuilder(0);
 
-    /*Check for object to see if its NULL*/
+    /*Returns the empty object {} for NULL*/
     if (g == NULL) {
-        jsonGroup = malloc(sizeof(char) * (strlen("{}") + 1));
-        strcpy(jsonGroup, "{}");
-        /*Returns empty string {}*/
-        return jsonGroup;
-    }
-
-    /*Otherwise will return newly allocated string in proper format*/
-    char cVal[1000];
-    char attVal[1000];
-    Group* group = (Group*)g;
-
-    /*Put value of number of children into string*/
-    int children = 0;
-    children += getLength(group->rectangles);
-    children += getLength(group->circles);
-    children += getLength(group->paths);
-    children += getLength(group->groups);
-
-    sprintf(cVal,"%d", children);
-    /*Puts number of attributes in Group into string*/
-    List* temp = (List*)group->otherAttributes;
-    if (group->otherAttributes == NULL || getLength(temp) == 0) {
-        strcpy(attVal, "0");
+        appendString(&json, "{}");
     } else {
-        sprintf(attVal, "%d", getLength(group->otherAttributes));
+        appendGroupJSON(&json, g);
     }
 
-    /*Malloc proper amount of memory for string, then catonate whole string in JSON format*/
-    jsonGroup = malloc(sizeof(char) * (strlen("{\"children\":,\"numAttr\":}") + strlen(cVal) + strlen(attVal) + 1));
-    sprintf(jsonGroup, "{\"children\":%s,\"numAttr\":%s}", cVal, attVal);
-
-    return jsonGroup;
+    return finishString(&json);
 }
 
 char* SVGtoJSON(const SVG* img) {
-    char* jsonSVG = NULL;
+    StringBuilder json = createStringBuilder(0);
 
-    /*Check for object to see if its NULL*/
+    /*Returns the empty object {} for NULL*/
     if (img == NULL) {
-        jsonSVG = malloc(sizeof(char) * (strlen("{}") + 1));
-        strcpy(jsonSVG, "{}");
-        /*Returns empty string {}*/
-        return jsonSVG;
+        appendString(&json, "{}");
+        return finishString(&json);
     }
 
-    /*Otherwise will return newly allocated string in proper format*/
-    char numR[1000];
-    char numC[1000];
-    char numP[1000];
-    char numG[1000];
+    /*Counts of components in the whole image, or 0 if there is no list of that type*/
+    const SVGStats* stats = getSVGStats(img);
+    appendFormat(&json, "{\"numRect\":%d,\"numCirc\":%d,\"numPaths\":%d,\"numGroups\":%d}",
+                 (img->rectangles == NULL) ? 0 : stats->numRect,
+                 (img->circles == NULL) ? 0 : stats->numCirc,
+                 (img->paths == NULL) ? 0 : stats->numPaths,
+                 (img->groups == NULL) ? 0 : stats->numGroups);
 
-    /*Get length of rectangles*/
-    if (img->rectangles == NULL) {
-        strcpy(numR, "0");
-    } else {
-        sprintf(numR, "%d", getLength(getRects(img)));
-    }
-    /*Get length of circles*/
-    if (img->circles == NULL) {
-        strcpy(numC, "0");
-    } else {
-        sprintf(numC, "%d", getLength(getCircles(img)));
-    }
-    /*Get length of paths*/
-    if (img->paths == NULL) {
-        strcpy(numP, "0");
-    } else {
-        sprintf(numP, "%d", getLength(getPaths(img)));
-    }
-    /*Get length of groups*/
-    if (img->groups == NULL) {
-        strcpy(numG, "0");
-    } else {
-        sprintf(numG, "%d", getLength(getGroups(img)));
-    }
-
-    /*Malloc proper amount of memory for string, then catonate whole string in JSON format*/
-    jsonSVG = malloc(sizeof(char) * strlen("{\"numRect\":,\"numCirc\":,\"numPaths\":,\"numGroups\":}") + strlen(numR) + strlen(numC) + strlen(numP) + strlen(numG) + 1);
-    sprintf(jsonSVG, "{\"numRect\":%s,\"numCirc\":%s,\"numPaths\":%s,\"numGroups\":%s}", numR, numC, numP, numG);
-
-    return jsonSVG;
+    return finishString(&json);
 }
 
 char* attrListToJSON(const List *list) {
-    char* jsonAttr = NULL;
-    char* attrString = NULL;
-    /*If list is empty*/
-    List *temp = (List*)list;
-    if (list == NULL || getLength(temp) <= 0) {
-        jsonAttr = malloc(sizeof(char) * (strlen("[]") + 1));
-        strcpy(jsonAttr, "[]");
-        /*Returns empty string []*/
-        return jsonAttr;
-    }
-    /*If list is not empty, start string with "["*/
-    jsonAttr = malloc(sizeof(char) * (strlen("[") + 1));
-    strcpy(jsonAttr,"[");
-
-    void* elem;
-    List *tempList = (List*)list;
-    ListIterator iter = createIterator(tempList);
-    /*Go through the elements of Attributes List*/
-    while ((elem = nextElement(&iter)) != NULL) {
-        /*Using the string returned from attrToJSON() function...*/
-        Attribute* tmpAttr = (Attribute*)elem;
-        attrString = attrToJSON(tmpAttr);
-        jsonAttr = realloc(jsonAttr, sizeof(char) * (strlen(jsonAttr) + strlen(attrString) + 2));
-        /*concatenate onto main jsonAttr string*/
-        strcat(jsonAttr, attrString);
-        strcat(jsonAttr, ",");
-        /*Free the string*/
-        free(attrString);
-    }
-    /*End string with "]"*/
-    int length = strlen(jsonAttr);
-    jsonAttr[length - 1] = ']';
-    /*Return string*/
-    return jsonAttr;
+    return listToJSON(list, &appendAttributeJSON);
 }
 
 char* circListToJSON(const List *list) {
-    char* jsonCirc = NULL;
-    char* circString = NULL;
-    /*If list is empty*/
-    List *temp = (List*)list;
-    if (list == NULL || getLength(temp) <= 0) {
-        jsonCirc = malloc(sizeof(char) * (strlen("[]") + 1));
-        strcpy(jsonCirc, "[]");
-        /*Returns empty string []*/
-        return jsonCirc;
-    }
-    /*If list is not empty, start string with "["*/
-    jsonCirc = malloc(sizeof(char) * (strlen("[") + 1));
-    strcpy(jsonCirc,"[");
-
-    void* elem;
-    List *tempList = (List*)list;
-    ListIterator iter = createIterator(tempList);
-    /*Go through the elements of Circles List*/
-    while ((elem = nextElement(&iter)) != NULL) {
-        /*Using the string returned from circleToJSON() function...*/
-        Circle* tmpCirc = (Circle*)elem;
-        circString = circleToJSON(tmpCirc);
-        jsonCirc = realloc(jsonCirc, sizeof(char) * (strlen(jsonCirc) + strlen(circString) + 2));
-        /*concatenate onto main jsonCirc string*/
-        strcat(jsonCirc, circString);
-        strcat(jsonCirc, ",");
-        /*Free the string*/
-        free(circString);
-    }
-    /*End string with "]"*/
-    int length = strlen(jsonCirc);
-    jsonCirc[length - 1] = ']';
-    /*Return string*/
-    return jsonCirc;
+    return listToJSON(list, &appendCircleJSON);
 }
 
 char* rectListToJSON(const List *list) {
-    char* jsonRect = NULL;
-    char* rectString = NULL;
-    /*If list is empty*/
-    List *temp = (List*)list;
-    if (list == NULL || getLength(temp) <= 0) {
-        jsonRect = malloc(sizeof(char) * (strlen("[]") + 1));
-        strcpy(jsonRect, "[]");
-        /*Returns empty string []*/
-        return jsonRect;
-    }
-    /*If list is not empty, start string with "["*/
-    jsonRect = malloc(sizeof(char) * (strlen("[") + 1));
-    strcpy(jsonRect,"[");
-
-    void* elem;
-    List *tempList = (List*)list;
-    ListIterator iter = createIterator(tempList);
-    /*Go through the elements of Rectangle List*/
-    while ((elem = nextElement(&iter)) != NULL) {
-        /*Using the string returned from rectToJSON() function...*/
-        Rectangle* tmpRect = (Rectangle*)elem;
-        rectString = rectToJSON(tmpRect);
-        jsonRect = realloc(jsonRect, sizeof(char) * (strlen(jsonRect) + strlen(rectString) + 2));
-        /*concatenate onto main jsonRect string*/
-        strcat(jsonRect, rectString);
-        strcat(jsonRect, ",");
-        /*Free the string*/
-        free(rectString);
-    }
-    /*End string with "]"*/
-    int length = strlen(jsonRect);
-    jsonRect[length - 1] = ']';
-    /*Return string*/
-    return jsonRect;
+    return listToJSON(list, &appendRectJSON);
 }
 
 char* pathListToJSON(const List *list) {
-    char* jsonPath = NULL;
-    char* pathString = NULL;
-    /*If list is empty*/
-    List *temp = (List*)list;
-    if (list == NULL || getLength(temp) <= 0) {
-        jsonPath = malloc(sizeof(char) * (strlen("[]") + 1));
-        strcpy(jsonPath, "[]");
-        /*Returns empty string []*/
-        return jsonPath;
-    }
-    /*If list is not empty, start string with "["*/
-    jsonPath = malloc(sizeof(char) * (strlen("[") + 1));
-    strcpy(jsonPath,"[");
-
-    void* elem;
-    List *tempList = (List*)list;
-    ListIterator iter = createIterator(tempList);
-    /*Go through the elements of Path List*/
-    while ((elem = nextElement(&iter)) != NULL) {
-        /*Using the string returned from pathToJSON() function...*/
-        Path* tmpPath = (Path*)elem;
-        pathString = pathToJSON(tmpPath);
-        jsonPath = realloc(jsonPath, sizeof(char) * (strlen(jsonPath) + strlen(pathString) + 2));
-        /*concatenate onto main jsonPath string*/
-        strcat(jsonPath, pathString);
-        strcat(jsonPath, ",");
-        /*Free the string*/
-        free(pathString);
-    }
-    /*End string with "]"*/
-    int length = strlen(jsonPath);
-    jsonPath[length - 1] = ']';
-    /*Return string*/
-    return jsonPath;
+    return listToJSON(list, &appendPathJSON);
 }
 
 char* groupListToJSON(const List *list) {
-    char* jsonGroup = NULL;
-    char* groupString = NULL;
-    /*If list is empty*/
-    List *temp = (List*)list;
-    if (list == NULL || getLength(temp) <= 0) {
-        jsonGroup = malloc(sizeof(char) * (strlen("[]") + 1));
-        strcpy(jsonGroup, "[]");
-        /*Returns empty string []*/
-        return jsonGroup;
-    }
-    /*If list is not empty, start string with "["*/
-    jsonGroup = malloc(sizeof(char) * (strlen("[") + 1));
-    strcpy(jsonGroup,"[");
-
-    void* elem;
-    List *tempList = (List*)list;
-    ListIterator iter = createIterator(tempList);
-    /*Go through the elements of Group List*/
-    while ((elem = nextElement(&iter)) != NULL) {
-        /*Using the string returned from groupToJSON() function...*/
-        Group* tmpGroup = (Group*)elem;
-        groupString = groupToJSON(tmpGroup);
-        jsonGroup = realloc(jsonGroup, sizeof(char) * (strlen(jsonGroup) + strlen(groupString) + 2));
-        /*concatenate onto main jsonGroup string*/
-        strcat(jsonGroup, groupString);
-        strcat(jsonGroup, ",");
-        /*Free the string*/
-        free(groupString);
-    }
-    /*End string with "]"*/
-    int length = strlen(jsonGroup);
-    jsonGroup[length - 1] = ']';
-    /*Return string*/
-    return jsonGroup;
+    return listToJSON(list, &appendGroupJSON);
 }
 
 /************************* Bonus A2 functions *************************/
 
-SVG* JSONtoSVG(const char* svgString) {
-    SVG *tmpSVG = NULL;
-
-    if (svgString == NULL  || strcmp(svgString, "") == 0) {
-        return tmpSVG;
-    } else {
-        return tmpSVG;
-    }
-}
-
-Rectangle* JSONtoRect(const char* svgString) {
-    Rectangle *tmpRect = NULL;
-
-    if (svgString == NULL  || strcmp(svgString, "") == 0) {
-        return tmpRect;
-    } else {
-        return tmpRect;
-    }
-}
-
-Circle* JSONtoCircle(const char* svgString) {
-    Circle *tmpCirc = NULL;
-
-    if (svgString == NULL  || strcmp(svgString, "") == 0) {
-        return tmpCirc;
-    } else {
-        return tmpCirc;
-    }
-}
-
 /**************************** Validate SVG File Functions ***************************/
 
 /**
- * @brief This function takes a SVG struct and saves it to a file in SVG Format
- * Most code used from the documentation references that Prof. Denis has provided
- * in the Modules
+ * @brief This function takes a SVG struct and saves it to a file in SVG Format.
+ * The XML is streamed straight from the struct (see SVGWriter.h), so no xmlDoc is built
  * @param img 
  * @param fileName 
  * @return true 
- * @return false 
+ * @return false if the namespace is empty or the file could not be written
  */
 bool writeSVG(const SVG* img, const char* fileName) {
     /*If SVG object or fileName is NULL, return false*/
@@ -1292,85 +921,47 @@ bool writeSVG(const SVG* img, const char* fileName) {
         return false;
     }
 
-    xmlDocPtr doc = NULL;
-    xmlNodePtr root_node = NULL;
-
-    LIBXML_TEST_VERSION;
+    bool written = writeSVGToFile(img, fileName, SVG_WRITE_PRETTY);
+    cleanupSVGParser();
+    xmlMemoryDump();
 
-    doc = xmlNewDoc(BAD_CAST "1.0");
-    root_node = xmlNewNode(NULL, BAD_CAST "svg");
-    xmlDocSetRootElement(doc, root_node);
+    return written;
+}
 
-    if (doc == NULL) {
+/**
+ * @brief Function to validating an existing an SVG struct against a SVG schema file
+ * and make sure all content within is valid. Return true if valid, false otherwise.
+ * @param img 
+ * @param schemaFile 
+ * @return true 
+ * @return false 
+ */
+bool validateSVG(const SVG* img, const char* schemaFile) {
+    /*Any arguments NULL, must return NULL*/
+    if (img == NULL || schemaFile == NULL) {
         return false;
     }
 
-    /*Sets the namespace in the XML tree*/
-    if (strcmp(img->namespace, "") == 0 || (img->namespace) == NULL) {
+    /*The schema is compiled on the first call and shared by every later one*/
+    const SVGSchema* schema = getCachedSVGSchema(schemaFile);
+    if (schema == NULL) {
         return false;
-    } else {
-        xmlNsPtr ns = xmlNewNs(root_node, BAD_CAST img->namespace, NULL);
-        xmlSetNs(root_node, ns);
-    }
-
-    /*Sets the title of SVG image in the XML tree*/
-    if (strcmp(img->title, "") != 0) {
-        xmlNewChild(root_node, NULL, BAD_CAST "title", BAD_CAST img->title);
-    }
-
-    /*Sets the description of SVG image in the XML tree*/
-    if (strcmp(img->description, "") != 0) {
-        xmlNewChild(root_node, NULL, BAD_CAST "desc", BAD_CAST img->description);
-    }
-
-    rectToNode(root_node, img->rectangles);
-    circleToNode(root_node, img->circles);
-    pathToNode(root_node, img->paths);
-    groupToNode(root_node, img->groups);
-
-    ListIterator attrIter;
-    void* elem;
-    attrIter = createIterator(img->otherAttributes);
-
-    /*Adding other attributes to the SVG Object node*/
-    while((elem = nextElement(&attrIter)) != NULL){
-        Attribute* tmpAttr = (Attribute*)elem;
-
-        if ((tmpAttr->name) == NULL && (tmpAttr->value) == NULL) {
-            continue;
-        }
-
-        xmlNewProp(root_node, BAD_CAST tmpAttr->name, BAD_CAST tmpAttr->value);
     }
 
-    if (doc != NULL) {
-        /*Dumping document to file*/
-        xmlSaveFormatFileEnc(fileName, doc, "UTF-8", 1);
-        xmlFreeDoc(doc);
-        xmlCleanupParser();
-        xmlMemoryDump();
-        /*Return true*/
-        return true;
-    } else {
-        xmlFreeDoc(doc);
-        xmlCleanupParser();
-        xmlMemoryDump();
-        /*Return false*/
-        return false;
-    }
+    return validateSVGWithSchema(img, schema);
 }
 
 /**
- * @brief Function to validating an existing an SVG struct against a SVG schema file
- * and make sure all content within is valid. Return true if valid, false otherwise.
+ * @brief Validates an SVG struct against a schema that has already been compiled,
+ * so the schema can be shared between calls
  * @param img 
- * @param schemaFile 
+ * @param schema 
  * @return true 
  * @return false 
  */
-bool validateSVG(const SVG* img, const char* schemaFile) {
+bool validateSVGWithSchema(const SVG* img, const SVGSchema* schema) {
     /*Any arguments NULL, must return NULL*/
-    if (img == NULL || schemaFile == NULL) {
+    if (img == NULL || schema == NULL) {
         return false;
     }
     /*Namespace may not be null or empty*/
@@ -1399,73 +990,9 @@ bool validateSVG(const SVG* img, const char* schemaFile) {
         }
     }
 
-    /*SVG contents must represent a valid SVG struct once converted to XMl.*/
-    xmlDoc* doc = svgToXML(img);
-    if (doc == NULL) {
-        return false;
-    }
-
-    xmlSchemaPtr schema = NULL;
-    xmlSchemaParserCtxtPtr ctxt;
-    char buf[20000];
-    setbuf(stderr, buf);
-
-    xmlLineNumbersDefault(1);
-
-    ctxt = xmlSchemaNewParserCtxt(schemaFile);
-
-    //xmlSchemaSetParserErrors(ctxt, (xmlSchemaValidityErrorFunc) fprintf, (xmlSchemaValidityWarningFunc) fprintf, stderr);
-    xmlSchemaSetParserErrors(ctxt, (xmlSchemaValidityErrorFunc) sprintf, (xmlSchemaValidityWarningFunc) sprintf, buf);
-    schema = xmlSchemaParse(ctxt);
-    xmlSchemaFreeParserCtxt(ctxt);
-    
-    if (doc == NULL) {
-        if(schema != NULL) {
-            xmlSchemaFree(schema);
-        }
-
-        xmlSchemaCleanupTypes();
-        xmlCleanupParser();
-        xmlMemoryDump();
-
-        return false;
-    } else {
-        xmlSchemaValidCtxtPtr ctxt;
-        int ret;
-
-        ctxt = xmlSchemaNewValidCtxt(schema);
-        //xmlSchemaSetValidErrors(ctxt, (xmlSchemaValidityErrorFunc) fprintf, (xmlSchemaValidityWarningFunc) fprintf, stderr);
-        xmlSchemaSetValidErrors(ctxt, (xmlSchemaValidityErrorFunc) sprintf, (xmlSchemaValidityWarningFunc) sprintf, buf);
-        ret = xmlSchemaValidateDoc(ctxt, doc);
-        
-        if (ret == 0) {
-            if(schema != NULL) {
-                xmlSchemaFree(schema);
-            }
-
-            xmlSchemaCleanupTypes();
-            xmlCleanupParser();
-            xmlMemoryDump();
-
-            xmlSchemaFreeValidCtxt(ctxt);
-            xmlFreeDoc(doc);
-            
-            return true;
-        } else {
-            if(schema != NULL) {
-                xmlSchemaFree(schema);
-            }
-
-            xmlSchemaCleanupTypes();
-            xmlCleanupParser();
-            xmlMemoryDump();
-
-            xmlSchemaFreeValidCtxt(ctxt);
-            xmlFreeDoc(doc);
-            
-            return false;
-        }
-    }
+    /*SVG contents must represent a valid SVG struct once converted to XMl.
+    The struct is streamed into the validator, so no xmlDoc is built*/
+    return validateStructWithSchema(img, schema);
 }
 
 /**
@@ -1479,212 +1006,141 @@ bool validateSVG(const SVG* img, const char* schemaFile) {
  * @return SVG* validSVGObject
  */
 SVG* createValidSVG(const char* fileName, const char* schemaFile) {
-    xmlDoc *doc = NULL;
-    xmlNode *root_element = NULL;
-    char buf[20000];
-    setbuf(stderr, buf);
-    
-    LIBXML_TEST_VERSION
+    if (fileName == NULL || schemaFile == NULL) {
+        return NULL;
+    }
 
-    xmlSchemaPtr schema = NULL;
-    xmlSchemaParserCtxtPtr ctxt;
-    const char *xsdFileName = schemaFile;
+    /*The schema is compiled on the first call and shared by every later one*/
+    const SVGSchema* schema = getCachedSVGSchema(schemaFile);
+    if (schema == NULL) {
+        return NULL;
+    }
 
-    xmlLineNumbersDefault(1);
+    return createValidSVGWithSchema(fileName, schema);
+}
 
-    ctxt = xmlSchemaNewParserCtxt(xsdFileName);
+/**
+ * @brief Create a Valid SVG object using a schema that has already been compiled.
+ * The schema is only read from, so the same handle can be used for every file
+ * @param fileName 
+ * @param schema 
+ * @return SVG* validSVGObject
+ */
+SVG* createValidSVGWithSchema(const char* fileName, const SVGSchema* schema) {
+    if (fileName == NULL || schema == NULL) {
+        return NULL;
+    }
 
-    xmlSchemaSetParserErrors(ctxt, (xmlSchemaValidityErrorFunc) sprintf, (xmlSchemaValidityWarningFunc) sprintf, buf);
-    //xmlSchemaSetParserErrors(ctxt, (xmlSchemaValidityErrorFunc) fprintf, (xmlSchemaValidityWarningFunc) fprintf, NULL);
-    schema = xmlSchemaParse(ctxt);
-    xmlSchemaFreeParserCtxt(ctxt);
+    LIBXML_TEST_VERSION
 
     /*parse the file and get the DOM */
-    doc = xmlReadFile(fileName, NULL, 0);
-
+    xmlDoc *doc = xmlReadFile(fileName, NULL, 0);
     if (doc == NULL) {
-        if (schema != NULL) {
-            xmlSchemaFree(schema);
-        }
-
-        xmlSchemaCleanupTypes();
-        xmlCleanupParser();
-        xmlMemoryDump();
-
         return NULL;
-    } else {
-        xmlSchemaValidCtxtPtr ctxt;
-        int ret;
-        
-        ctxt = xmlSchemaNewValidCtxt(schema);
-        //xmlSchemaSetValidErrors(ctxt, (xmlSchemaValidityErrorFunc) fprintf, (xmlSchemaValidityWarningFunc) fprintf, NULL);
-        xmlSchemaSetValidErrors(ctxt, (xmlSchemaValidityErrorFunc) sprintf, (xmlSchemaValidityWarningFunc) sprintf, buf);
-        ret = xmlSchemaValidateDoc(ctxt, doc);
-        
-        /*File is not valid, return NULL*/
-        if (ret != 0) {
-            if(schema != NULL) {
-                xmlSchemaFree(schema);
-            }
-
-            xmlSchemaCleanupTypes();
-            xmlCleanupParser();
-            xmlMemoryDump();
-
-            xmlSchemaFreeValidCtxt(ctxt);
-            xmlFreeDoc(doc);
+    }
 
-            return NULL;
-        }
+    /*File is not valid, return NULL*/
+    if (!validateDocWithSchema(doc, schema)) {
+        xmlFreeDoc(doc);
+        return NULL;
     }
 
     /********* Continues to create regular SVG Object - createSVG() *********/
+    SVG *SVGObject = parseSVGRoot(xmlDocGetRootElement(doc));
 
-    /*Get the root element node */
-    root_element = xmlDocGetRootElement(doc);
+    /*Free the document*/
+    xmlFreeDoc(doc);
 
-    if (doc == NULL) {
-        /*free the document */
-        xmlFreeDoc(doc);
+    /*Return object*/
+    return SVGObject;
+}
 
-        /*
-        *Free the global variables that may
-        *have been allocated by the parser.
-        */
-        xmlCleanupParser();
-        /*Error: could not parse file*/
+/**
+ * @brief Parses SVG contents that are already in memory into an xmlDoc
+ * @param buffer 
+ * @param length 
+ * @return xmlDoc* 
+ */
+static xmlDoc* readSVGBuffer(const char* buffer, int length) {
+    if (buffer == NULL || length <= 0) {
         return NULL;
     }
 
-    /*Get the root element node */
-    root_element = xmlDocGetRootElement(doc);
+    LIBXML_TEST_VERSION
 
-    /*Main SVG Struct Object that will be returned*/
-    SVG *SVGObject = malloc(sizeof(SVG));
+    return xmlReadMemory(buffer, length, NULL, NULL, 0);
+}
 
-    /*Assign namespace, title, and desc with default values - In case they are empty*/
-    strcpy(SVGObject->namespace, "empty-namespace");
-    strcpy(SVGObject->title, "");
-    strcpy(SVGObject->description, "");
+/**
+ * @brief Create an SVG object from SVG contents that are already in memory
+ * @param buffer 
+ * @param length 
+ * @return SVG* SVGObject
+ */
+SVG* createSVGFromBuffer(const char* buffer, int length) {
+    xmlDoc *doc = readSVGBuffer(buffer, length);
 
-    /*Initializing Lists for the main SVG Object file*/
-    SVGObject->rectangles = initializeList(&rectangleToString, &deleteRectangle, &compareRectangles);
-    SVGObject->circles = initializeList(&circleToString, &deleteCircle, &compareCircles);
-    SVGObject->paths = initializeList(&pathToString, &deletePath, &comparePaths);
-    SVGObject->groups = initializeList(&groupToString, &deleteGroup, &compareGroups);
-    SVGObject->otherAttributes = initializeList(&attributeToString, &deleteAttribute, &compareAttributes);
+    if (doc == NULL) {
+        cleanupSVGParser();
+        return NULL;
+    }
 
-    /*Receiving the other attributes for the SVG object*/
-    xmlAttr *attr;
-    for (attr = root_element->properties; attr != NULL; attr = attr->next) {
-        xmlNode *value = attr->children;
-        char *attrName = (char *)attr->name;
-        char *cont = (char *)(value->content);
-        char tmpStr[1000];
+    SVG *SVGObject = parseSVGRoot(xmlDocGetRootElement(doc));
 
-        /*Adding handling of multiple attributes for an SVG component*/
-        Attribute *svgAttributes = malloc(sizeof(Attribute));
+    /*Free the document and the global variables*/
+    xmlFreeDoc(doc);
+    cleanupSVGParser();
 
-        /*For attribute name*/
-        svgAttributes->name = malloc(sizeof(char) * strlen(attrName) + 1);
-        strcpy(svgAttributes->name, attrName);
-        /*For attribute value*/
-        sprintf(tmpStr, cont);
-        strcpy(svgAttributes->value, tmpStr);
-        //svgAttributes->value = malloc(sizeof(char) * strlen(cont) + 1);
+    return SVGObject;
+}
 
-        /*Insert into main SVG Object list*/
-        insertBack(SVGObject->otherAttributes, (void*)svgAttributes);
+/**
+ * @brief Create a Valid SVG object from SVG contents that are already in memory
+ * @param buffer 
+ * @param length 
+ * @param schemaFile 
+ * @return SVG* validSVGObject
+ */
+SVG* createValidSVGFromBuffer(const char* buffer, int length, const char* schemaFile) {
+    if (buffer == NULL || schemaFile == NULL) {
+        return NULL;
     }
 
-    /*Applying namespace onto the SVG Object*/
-    xmlNs *nameSpace = root_element->ns;
-    if (nameSpace == NULL) {
+    const SVGSchema* schema = getCachedSVGSchema(schemaFile);
+    if (schema == NULL) {
         return NULL;
-    } else {
-        char *nameSpaceChar = (char*)(nameSpace->href);
-        if (nameSpaceChar != NULL) {
-            strcpy(SVGObject->namespace, nameSpaceChar);
-        } else{
-            return NULL;
-        }
     }
 
-    /*Loops through the SVG file to find: Rect, Circles, Paths & Groups*/
-    xmlNode *cur_node = NULL;
-    for (cur_node = root_element->children; cur_node != NULL; cur_node = cur_node->next) {
-        if (cur_node->type == XML_ELEMENT_NODE) {
-            char *nodeName = (char *)cur_node->name;
-
-            if (strcmp(nodeName, "title") == 0) {
-                if (cur_node->children->content != NULL) {
-                    strcpy(SVGObject->title, (char*)cur_node->children->content);
-                }
-            } else if (strcmp(nodeName, "desc") == 0) {
-                if (cur_node->children->content != NULL) {
-                    strcpy(SVGObject->description, (char*)cur_node->children->content);
-                }
-            } else if (strcmp(nodeName, "rect") == 0) {
-                Rectangle *rect = parseRectData(cur_node);
-                /*Rectangle object must not be NULL. It may be empty*/
-                if (rect == NULL) {
-                    deleteSVG(SVGObject);
-                    xmlFreeDoc(doc);
-                    xmlCleanupParser();
-                    return NULL;
-                }
-                /*Insert into main list*/
-                insertBack(SVGObject->rectangles, (void*)rect);
-            } else if (strcmp(nodeName, "circle") == 0) {
-                Circle *circle = parseCircleData(cur_node);
-                /*Circle object must not be NULL. It may be empty*/
-                if (circle == NULL) {
-                    deleteSVG(SVGObject);
-                    xmlFreeDoc(doc);
-                    xmlCleanupParser();
-                    return NULL;
-                }
-                /*Insert into main list*/
-                insertBack(SVGObject->circles, (void*)circle);
-            } else if (strcmp(nodeName, "path") == 0) {
-                Path *path = parsePathData(cur_node);
-                /*Path object must not be NULL. It may be empty*/
-                if (path == NULL) {
-                    deleteSVG(SVGObject);
-                    xmlFreeDoc(doc);
-                    xmlCleanupParser();
-                    return NULL;
-                }
-                
-                insertBack(SVGObject->paths, (void*)path);
-            } else if (strcmp(nodeName, "g") == 0) {
-                Group *group = parseGroupData(cur_node);
-                /*Group object must not be NULL. It may be empty*/
-                if (group == NULL) {
-                    deleteSVG(SVGObject);
-                    xmlFreeDoc(doc);
-                    xmlCleanupParser();
-                    return NULL;
-                }
-                /*Insert into main list*/
-                insertBack(SVGObject->groups, (void*)group);
-            }
-        }
+    return createValidSVGFromBufferWithSchema(buffer, length, schema);
+}
+
+/**
+ * @brief Create a Valid SVG object from SVG contents that are already in memory,
+ * using a schema that has already been compiled
+ * @param buffer 
+ * @param length 
+ * @param schema 
+ * @return SVG* validSVGObject
+ */
+SVG* createValidSVGFromBufferWithSchema(const char* buffer, int length, const SVGSchema* schema) {
+    if (schema == NULL) {
+        return NULL;
     }
 
-    /*Free the document and the global variables*/
-    xmlFreeDoc(doc);
+    xmlDoc *doc = readSVGBuffer(buffer, length);
+    if (doc == NULL) {
+        return NULL;
+    }
 
-    /*Free the resource*/
-    if (schema != NULL) {
-        xmlSchemaFree(schema);
+    /*Contents are not valid, return NULL*/
+    if (!validateDocWithSchema(doc, schema)) {
+        xmlFreeDoc(doc);
+        return NULL;
     }
 
-    xmlSchemaCleanupTypes();
-    xmlCleanupParser();
-    xmlMemoryDump();
+    SVG *SVGObject = parseSVGRoot(xmlDocGetRootElement(doc));
+    xmlFreeDoc(doc);
 
-    /*Return object*/
     return SVGObject;
 }
 
@@ -1699,6 +1155,17 @@ void deleteSVG(SVG* img) {
         return ;
     }
 
+    /*Only structs the library created have views or an arena*/
+    if (isLibrarySVG(img)) {
+        freeSVGViews(img->views);
+
+        /*Everything of an arena-backed SVG, including the struct itself, lives in its arena*/
+        if (img->arena != NULL) {
+            freeArena(img->arena);
+            return ;
+        }
+    }
+
     freeList(img->rectangles);
     freeList(img->circles);
     freeList(img->paths);
@@ -1714,21 +1181,14 @@ void deleteSVG(SVG* img) {
  * @return char* 
  */
 char* SVGToString(const SVG* img) {
-    char *temp;
-    const SVG *tempSVG;
-
     if (img == NULL) {
         return NULL;
     }
 
-    tempSVG = img;
-
-    int length = strlen(tempSVG->namespace) + strlen(tempSVG->title) + strlen(tempSVG->description) + 25;
-    temp = (char *) malloc(sizeof(char) * length);
+    StringBuilder str = createStringBuilder(0);
+    appendFormat(&str, "Namespace: %s Title: %s Desc: %s", img->namespace, img->title, img->description);
 
-    sprintf(temp,"Namespace: %s Title: %s Desc: %s", tempSVG->namespace, tempSVG->title, tempSVG->description);
-
-    return temp;
+    return finishString(&str);
 }
 
 /******************************* A1 CreateSVG Function ******************************/
@@ -1742,7 +1202,6 @@ char* SVGToString(const SVG* img) {
  */
 SVG* createSVG(const char* filename) {
     xmlDoc *doc = NULL;
-    xmlNode *root_element = NULL;
     
     /*
      * This initializes the library and check potential ABI mismatches
@@ -1755,137 +1214,21 @@ SVG* createSVG(const char* filename) {
     doc = xmlReadFile(filename, NULL, 0);
 
     if (doc == NULL) {
-        /*free the document */
-        xmlFreeDoc(doc);
-
         /*
         *Free the global variables that may
         *have been allocated by the parser.
         */
-        xmlCleanupParser();
+        cleanupSVGParser();
         /*Error: could not parse file*/
         return NULL;
     }
 
-    /*Get the root element node */
-    root_element = xmlDocGetRootElement(doc);
-
-    /*Main SVG Struct Object that will be returned*/
-    SVG *SVGObject = malloc(sizeof(SVG));
-
-    /*Assign namespace, title, and desc with default values - In case they are empty*/
-    strcpy(SVGObject->namespace, "empty-namespace");
-    strcpy(SVGObject->title, "");
-    strcpy(SVGObject->description, "");
-
-    /*Initializing Lists for the main SVG Object file*/
-    SVGObject->rectangles = initializeList(&rectangleToString, &deleteRectangle, &compareRectangles);
-    SVGObject->circles = initializeList(&circleToString, &deleteCircle, &compareCircles);
-    SVGObject->paths = initializeList(&pathToString, &deletePath, &comparePaths);
-    SVGObject->groups = initializeList(&groupToString, &deleteGroup, &compareGroups);
-    SVGObject->otherAttributes = initializeList(&attributeToString, &deleteAttribute, &compareAttributes);
-
-    /*Receiving the other attributes for the SVG object*/
-    xmlAttr *attr;
-    for (attr = root_element->properties; attr != NULL; attr = attr->next) {
-        xmlNode *value = attr->children;
-        char *attrName = (char *)attr->name;
-        char *cont = (char *)(value->content);
-        char tmpStr[256];
-
-        /*Adding handling of multiple attributes for an SVG component*/
-        Attribute *svgAttributes = malloc(sizeof(Attribute));
-
-        /*For attribute name*/
-        svgAttributes->name = malloc(sizeof(char) * strlen(attrName) + 1);
-        strcpy(svgAttributes->name, attrName);
-        /*For attribute value*/
-        sprintf(tmpStr, cont);
-        strcpy(svgAttributes->value, tmpStr);
-        //svgAttributes->value = malloc(sizeof(char) * strlen(cont) + 1);
-
-        /*Insert into main SVG Object list*/
-        insertBack(SVGObject->otherAttributes, (void*)svgAttributes);
-    }
-
-    /*Applying namespace onto the SVG Object*/
-    xmlNs *nameSpace = root_element->ns;
-    if (nameSpace == NULL) {
-        return NULL;
-    } else {
-        char *nameSpaceChar = (char*)(nameSpace->href);
-        if (nameSpaceChar != NULL) {
-            strcpy(SVGObject->namespace, nameSpaceChar);
-        } else{
-            return NULL;
-        }
-    }
-
-    /*Loops through the SVG file to find: Rect, Circles, Paths & Groups*/
-    xmlNode *cur_node = NULL;
-    for (cur_node = root_element->children; cur_node != NULL; cur_node = cur_node->next) {
-        if (cur_node->type == XML_ELEMENT_NODE) {
-            char *nodeName = (char *)cur_node->name;
-
-            if (strcmp(nodeName, "title") == 0) {
-                if (cur_node->children->content != NULL) {
-                    strcpy(SVGObject->title, (char*)cur_node->children->content);
-                }
-            } else if (strcmp(nodeName, "desc") == 0) {
-                if (cur_node->children->content != NULL) {
-                    strcpy(SVGObject->description, (char*)cur_node->children->content);
-                }
-            } else if (strcmp(nodeName, "rect") == 0) {
-                Rectangle *rect = parseRectData(cur_node);
-                /*Rectangle object must not be NULL. It may be empty*/
-                if (rect == NULL) {
-                    deleteSVG(SVGObject);
-                    xmlFreeDoc(doc);
-                    xmlCleanupParser();
-                    return NULL;
-                }
-                /*Insert into main list*/
-                insertBack(SVGObject->rectangles, (void*)rect);
-            } else if (strcmp(nodeName, "circle") == 0) {
-                Circle *circle = parseCircleData(cur_node);
-                /*Circle object must not be NULL. It may be empty*/
-                if (circle == NULL) {
-                    deleteSVG(SVGObject);
-                    xmlFreeDoc(doc);
-                    xmlCleanupParser();
-                    return NULL;
-                }
-                /*Insert into main list*/
-                insertBack(SVGObject->circles, (void*)circle);
-            } else if (strcmp(nodeName, "path") == 0) {
-                Path *path = parsePathData(cur_node);
-                /*Path object must not be NULL. It may be empty*/
-                if (path == NULL) {
-                    deleteSVG(SVGObject);
-                    xmlFreeDoc(doc);
-                    xmlCleanupParser();
-                    return NULL;
-                }
-                
-                insertBack(SVGObject->paths, (void*)path);
-            } else if (strcmp(nodeName, "g") == 0) {
-                Group *group = parseGroupData(cur_node);
-                /*Group object must not be NULL. It may be empty*/
-                if (group == NULL) {
-                    deleteSVG(SVGObject);
-                    xmlFreeDoc(doc);
-                    xmlCleanupParser();
-                    return NULL;
-                }
-                /*Insert into main list*/
-                insertBack(SVGObject->groups, (void*)group);
-            }
-        }
-    }  
+    /*Get the root element node and build the SVG Object from it*/
+    SVG *SVGObject = parseSVGRoot(xmlDocGetRootElement(doc));
 
     /*Free the document and the global variables*/
     xmlFreeDoc(doc);
-    xmlCleanupParser();
+    cleanupSVGParser();
     /*Return object*/
     return SVGObject;
 }
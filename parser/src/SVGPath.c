@@ -0,0 +1,502 @@
+/**
+ * @file SVGPath.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief This file contains the path data compiler, which parses a path's 'd' string
+ * once into absolute commands that geometry code can walk without re-tokenizing text
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SVGParser.h"
+#include "SVGHelpers.h"
+#include "SVGPath.h"
+#include "LinkedListAPI.h"
+
+const int SVG_PATH_OP_COORDS[] = {2, 2, 6, 4, 9, 2};
+
+/*Growable opcode and coordinate arrays the commands are collected in while compiling*/
+typedef struct {
+    unsigned char* ops;
+    int numOps;
+    int opsCapacity;
+    float* coords;
+    int numCoords;
+    int coordsCapacity;
+    bool outOfMemory;
+} PathBuilder;
+
+/*Current point, subpath start and the last control point, for relative and smooth commands*/
+typedef struct {
+    double x;
+    double y;
+    double startX;
+    double startY;
+    double ctrlX;
+    double ctrlY;
+    //Opcode of the last command, so S/T know whether there is a control point to reflect
+    int lastOp;
+} PathCursor;
+
+/**
+ * @brief Appends one command to the builder
+ * @param builder
+ * @param op
+ * @param coords - SVG_PATH_OP_COORDS[op] values
+ */
+static void emitCommand(PathBuilder* builder, SVGPathOp op, const double* coords) {
+    int numCoords = SVG_PATH_OP_COORDS[op];
+
+    if (builder->outOfMemory) {
+        return ;
+    }
+
+    if (builder->numOps == builder->opsCapacity) {
+        int capacity = (builder->opsCapacity == 0) ? 16 : builder->opsCapacity * 2;
+        unsigned char* ops = realloc(builder->ops, capacity);
+        if (ops == NULL) {
+            builder->outOfMemory = true;
+            return ;
+        }
+        builder->ops = ops;
+        builder->opsCapacity = capacity;
+    }
+    if (builder->numCoords + numCoords > builder->coordsCapacity) {
+        int capacity = (builder->coordsCapacity == 0) ? 64 : builder->coordsCapacity * 2;
+        float* newCoords = realloc(builder->coords, sizeof(float) * capacity);
+        if (newCoords == NULL) {
+            builder->outOfMemory = true;
+            return ;
+        }
+        builder->coords = newCoords;
+        builder->coordsCapacity = capacity;
+    }
+
+    builder->ops[builder->numOps++] = (unsigned char)op;
+    for (int i = 0; i < numCoords; i++) {
+        builder->coords[builder->numCoords++] = (float)coords[i];
+    }
+}
+
+static bool isPathSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+/**
+ * @brief Skips whitespace and commas between numbers
+ * @param cur
+ * @return const char*
+ */
+static const char* skipSeparators(const char* cur) {
+    while (isPathSpace(*cur) || *cur == ',') {
+        cur++;
+    }
+    return cur;
+}
+
+static bool startsNumber(char c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.';
+}
+
+/**
+ * @brief Reads count numbers into args.  Arc flags are single '0'/'1' characters that
+ * do not need a separator, so they are read separately when flagMask has their bit set
+ * @param cur
+ * @param args
+ * @param count
+ * @param flagMask - bit i set if args[i] is a flag
+ * @return const char* past the numbers, or NULL if there were not enough
+ */
+static const char* readArgs(const char* cur, double* args, int count, int flagMask) {
+    for (int i = 0; i < count; i++) {
+        cur = skipSeparators(cur);
+
+        if (flagMask & (1 << i)) {
+            if (*cur != '0' && *cur != '1') {
+                return NULL;
+            }
+            args[i] = *cur - '0';
+            cur++;
+        } else {
+            cur = parseNumber(cur, &args[i]);
+            if (cur == NULL) {
+                return NULL;
+            }
+        }
+    }
+
+    return cur;
+}
+
+/**
+ * @brief Angle from vector (ux, uy) to vector (vx, vy), as in the SVG implementation notes
+ * @return double
+ */
+static double vectorAngle(double ux, double uy, double vx, double vy) {
+    return atan2(ux * vy - uy * vx, ux * vx + uy * vy);
+}
+
+/**
+ * @brief Emits an endpoint arc, converted to centre form (SVG implementation notes F.6.5/F.6.6)
+ * @param builder
+ * @param pos
+ * @param args - rx ry rotation largeArc sweep x y, with x y already absolute
+ */
+static void emitArc(PathBuilder* builder, const PathCursor* pos, const double* args) {
+    double x1 = pos->x;
+    double y1 = pos->y;
+    double x2 = args[5];
+    double y2 = args[6];
+    double rx = fabs(args[0]);
+    double ry = fabs(args[1]);
+
+    /*An arc to the current point is left out, and one without a radius is a straight line*/
+    if (x1 == x2 && y1 == y2) {
+        return ;
+    }
+    if (rx == 0 || ry == 0) {
+        double line[2] = {x2, y2};
+        emitCommand(builder, PATH_LINE, line);
+        return ;
+    }
+
+    double phi = fmod(args[2], 360.0) * PI / 180.0;
+    double cosPhi = cos(phi);
+    double sinPhi = sin(phi);
+    double dx = (x1 - x2) / 2;
+    double dy = (y1 - y2) / 2;
+    double x1p = cosPhi * dx + sinPhi * dy;
+    double y1p = -sinPhi * dx + cosPhi * dy;
+
+    /*Radii too small to reach the end point are scaled up just enough*/
+    double lambda = (x1p * x1p) / (rx * rx) + (y1p * y1p) / (ry * ry);
+    if (lambda > 1) {
+        rx *= sqrt(lambda);
+        ry *= sqrt(lambda);
+    }
+
+    double num = rx * rx * ry * ry - rx * rx * y1p * y1p - ry * ry * x1p * x1p;
+    double den = rx * rx * y1p * y1p + ry * ry * x1p * x1p;
+    double coef = (num > 0 && den > 0) ? sqrt(num / den) : 0;
+    if ((args[3] != 0) == (args[4] != 0)) {
+        coef = -coef;
+    }
+
+    double cxp = coef * rx * y1p / ry;
+    double cyp = -coef * ry * x1p / rx;
+    double cx = cosPhi * cxp - sinPhi * cyp + (x1 + x2) / 2;
+    double cy = sinPhi * cxp + cosPhi * cyp + (y1 + y2) / 2;
+
+    double ux = (x1p - cxp) / rx;
+    double uy = (y1p - cyp) / ry;
+    double vx = (-x1p - cxp) / rx;
+    double vy = (-y1p - cyp) / ry;
+    double start = vectorAngle(1, 0, ux, uy);
+    double sweep = vectorAngle(ux, uy, vx, vy);
+
+    if (args[4] == 0 && sweep > 0) {
+        sweep -= 2 * PI;
+    } else if (args[4] != 0 && sweep < 0) {
+        sweep += 2 * PI;
+    }
+
+    double arc[9] = {rx, ry, phi, cx, cy, start, sweep, x2, y2};
+    emitCommand(builder, PATH_ARC, arc);
+}
+
+/**
+ * @brief Applies one set of arguments of a path command, updating the cursor
+ * @param builder
+ * @param pos
+ * @param cmd - command letter, with implicit M repeats already turned into L
+ * @param args
+ */
+static void applyCommand(PathBuilder* builder, PathCursor* pos, char cmd, double* args) {
+    bool relative = (cmd >= 'a' && cmd <= 'z');
+    double baseX = relative ? pos->x : 0;
+    double baseY = relative ? pos->y : 0;
+    double out[9];
+    int op;
+
+    switch (cmd) {
+        case 'M': case 'm':
+            out[0] = baseX + args[0];
+            out[1] = baseY + args[1];
+            pos->startX = out[0];
+            pos->startY = out[1];
+            op = PATH_MOVE;
+            break;
+        case 'L': case 'l':
+            out[0] = baseX + args[0];
+            out[1] = baseY + args[1];
+            op = PATH_LINE;
+            break;
+        case 'H': case 'h':
+            out[0] = baseX + args[0];
+            out[1] = pos->y;
+            op = PATH_LINE;
+            break;
+        case 'V': case 'v':
+            out[0] = pos->x;
+            out[1] = baseY + args[0];
+            op = PATH_LINE;
+            break;
+        case 'C': case 'c':
+            for (int i = 0; i < 6; i += 2) {
+                out[i] = baseX + args[i];
+                out[i + 1] = baseY + args[i + 1];
+            }
+            op = PATH_CUBIC;
+            break;
+        case 'S': case 's':
+            /*The first control point is the previous one reflected, if there was a cubic before*/
+            out[0] = (pos->lastOp == PATH_CUBIC) ? 2 * pos->x - pos->ctrlX : pos->x;
+            out[1] = (pos->lastOp == PATH_CUBIC) ? 2 * pos->y - pos->ctrlY : pos->y;
+            for (int i = 0; i < 4; i += 2) {
+                out[i + 2] = baseX + args[i];
+                out[i + 3] = baseY + args[i + 1];
+            }
+            op = PATH_CUBIC;
+            break;
+        case 'Q': case 'q':
+            for (int i = 0; i < 4; i += 2) {
+                out[i] = baseX + args[i];
+                out[i + 1] = baseY + args[i + 1];
+            }
+            op = PATH_QUAD;
+            break;
+        case 'T': case 't':
+            out[0] = (pos->lastOp == PATH_QUAD) ? 2 * pos->x - pos->ctrlX : pos->x;
+            out[1] = (pos->lastOp == PATH_QUAD) ? 2 * pos->y - pos->ctrlY : pos->y;
+            out[2] = baseX + args[0];
+            out[3] = baseY + args[1];
+            op = PATH_QUAD;
+            break;
+        case 'A': case 'a':
+            for (int i = 0; i < 5; i++) {
+                out[i] = args[i];
+            }
+            out[5] = baseX + args[5];
+            out[6] = baseY + args[6];
+            emitArc(builder, pos, out);
+            pos->x = out[5];
+            pos->y = out[6];
+            pos->lastOp = PATH_ARC;
+            return ;
+        default:
+            out[0] = pos->startX;
+            out[1] = pos->startY;
+            op = PATH_CLOSE;
+            break;
+    }
+
+    emitCommand(builder, op, out);
+
+    /*The end point is always the last pair, and a curve's last control point comes right before it*/
+    int numCoords = SVG_PATH_OP_COORDS[op];
+    pos->x = out[numCoords - 2];
+    pos->y = out[numCoords - 1];
+    if (op == PATH_CUBIC || op == PATH_QUAD) {
+        pos->ctrlX = out[numCoords - 4];
+        pos->ctrlY = out[numCoords - 3];
+    }
+    pos->lastOp = op;
+}
+
+/**
+ * @brief Number of arguments taken by a path command letter, or -1 if it is not one
+ * @param cmd
+ * @param flagMask - set to the arguments that are arc flags
+ * @return int
+ */
+static int commandArgs(char cmd, int* flagMask) {
+    *flagMask = 0;
+
+    switch (cmd) {
+        case 'M': case 'm': case 'L': case 'l': case 'T': case 't':
+            return 2;
+        case 'H': case 'h': case 'V': case 'v':
+            return 1;
+        case 'C': case 'c':
+            return 6;
+        case 'S': case 's': case 'Q': case 'q':
+            return 4;
+        case 'A': case 'a':
+            *flagMask = (1 << 3) | (1 << 4);
+            return 7;
+        case 'Z': case 'z':
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+/**
+ * @brief Parses path data into the builder
+ * @param builder
+ * @param data
+ * @return true if all of data was valid
+ * @return false if it stopped at an error
+ */
+static bool compileInto(PathBuilder* builder, const char* data) {
+    PathCursor pos = {0, 0, 0, 0, 0, 0, -1};
+    const char* cur = skipSeparators(data);
+    bool first = true;
+
+    while (*cur != '\0') {
+        char cmd = *cur++;
+        int flagMask;
+        int numArgs = commandArgs(cmd, &flagMask);
+
+        /*Data has to start with a moveto*/
+        if (numArgs < 0 || (first && cmd != 'M' && cmd != 'm')) {
+            return false;
+        }
+        first = false;
+
+        if (numArgs == 0) {
+            applyCommand(builder, &pos, cmd, NULL);
+            cur = skipSeparators(cur);
+            continue;
+        }
+
+        /*A command applies to every following set of arguments - and after a moveto, they are linetos*/
+        do {
+            double args[7];
+
+            cur = readArgs(cur, args, numArgs, flagMask);
+            if (cur == NULL) {
+                return false;
+            }
+            applyCommand(builder, &pos, cmd, args);
+
+            if (cmd == 'M') {
+                cmd = 'L';
+            } else if (cmd == 'm') {
+                cmd = 'l';
+            }
+            cur = skipSeparators(cur);
+        } while (startsNumber(*cur));
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compiles path data into a new SVGPathCommands, in a single block of memory
+ * @param data
+ * @return SVGPathCommands*
+ */
+SVGPathCommands* compilePathData(const char* data) {
+    if (data == NULL) {
+        return NULL;
+    }
+
+    PathBuilder builder = {NULL, 0, 0, NULL, 0, 0, false};
+    bool complete = compileInto(&builder, data);
+
+    SVGPathCommands* commands = NULL;
+    if (!builder.outOfMemory) {
+        /*Coordinates go right after the struct, so they stay aligned, and the opcodes last*/
+        size_t size = sizeof(SVGPathCommands) + sizeof(float) * builder.numCoords + builder.numOps;
+        commands = malloc(size);
+    }
+
+    if (commands != NULL) {
+        commands->numOps = builder.numOps;
+        commands->numCoords = builder.numCoords;
+        commands->complete = complete;
+        commands->coords = (float*)(commands + 1);
+        commands->ops = (unsigned char*)(commands->coords + builder.numCoords);
+        if (builder.numCoords > 0) {
+            memcpy(commands->coords, builder.coords, sizeof(float) * builder.numCoords);
+        }
+        if (builder.numOps > 0) {
+            memcpy(commands->ops, builder.ops, builder.numOps);
+        }
+    }
+
+    free(builder.ops);
+    free(builder.coords);
+
+    return commands;
+}
+
+/**
+ * @brief Frees commands returned by compilePathData()
+ * @param commands
+ */
+void freePathCommands(SVGPathCommands* commands) {
+    free(commands);
+}
+
+/**
+ * @brief Returns the compiled commands of a path, compiling its data on first use.
+ * The commands are on the heap for paths of an arena SVG too, so every recompile after
+ * a change to 'd' frees the old ones instead of taking more of the arena
+ * @param path
+ * @return const SVGPathCommands*
+ */
+const SVGPathCommands* getPathCommands(Path* path) {
+    if (path == NULL) {
+        return NULL;
+    }
+
+    if (path->commands == NULL) {
+        path->commands = compilePathData(path->data);
+    }
+
+    return path->commands;
+}
+
+/**
+ * @brief Drops the compiled commands of a path
+ * @param path
+ */
+void invalidatePathCommands(Path* path) {
+    if (path == NULL || path->commands == NULL) {
+        return ;
+    }
+
+    freePathCommands(path->commands);
+    path->commands = NULL;
+}
+
+/**
+ * @brief Creates an iterator over compiled commands
+ * @param commands
+ * @return SVGPathIterator
+ */
+SVGPathIterator createPathIterator(const SVGPathCommands* commands) {
+    SVGPathIterator iter;
+
+    iter.commands = commands;
+    iter.op = 0;
+    iter.coord = 0;
+    iter.current.op = PATH_MOVE;
+    iter.current.coords = NULL;
+
+    return iter;
+}
+
+/**
+ * @brief Returns the next command, or NULL after the last one
+ * @param iter
+ * @return const SVGPathCommand*
+ */
+const SVGPathCommand* nextPathCommand(SVGPathIterator* iter) {
+    if (iter == NULL || iter->commands == NULL || iter->op >= iter->commands->numOps) {
+        return NULL;
+    }
+
+    iter->current.op = (SVGPathOp)iter->commands->ops[iter->op];
+    iter->current.coords = iter->commands->coords + iter->coord;
+    iter->op++;
+    iter->coord += SVG_PATH_OP_COORDS[iter->current.op];
+
+    return &iter->current;
+}
@@ -0,0 +1,455 @@
+/**
+ * @file SVGSchema.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief This file contains the functions for compiling an SVG schema once and
+ * sharing it between every createValidSVG/validateSVG call in the process
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <pthread.h>
+
+#include <libxml/parser.h>
+#include <libxml/xmlschemas.h>
+#include <libxml/xmlschemastypes.h>
+
+#include "SVGParser.h"
+#include "SVGSchema.h"
+#include "LinkedListAPI.h"
+#include "StringBuilder.h"
+
+/*Process-wide list of compiled schemas, keyed by schema file name*/
+static List* schemaCache = NULL;
+static pthread_mutex_t schemaCacheLock = PTHREAD_MUTEX_INITIALIZER;
+
+/*Number of schema handles that have not been released yet, plus schemas being compiled*/
+static int liveSchemas = 0;
+
+static void countSchema(int change) {
+    pthread_mutex_lock(&schemaCacheLock);
+    liveSchemas += change;
+    pthread_mutex_unlock(&schemaCacheLock);
+}
+
+/**
+ * @brief Swallows schema parser/validator messages, so invalid uploads do not
+ * flood the server's stderr
+ * @param ctx
+ * @param msg
+ * @param ...
+ */
+static void ignoreSchemaErrors(void* ctx, const char* msg, ...) {
+    (void)ctx;
+    (void)msg;
+}
+
+/*Schema cache List functions*/
+static char* schemaToString(void* data) {
+    if (data == NULL) {
+        return NULL;
+    }
+
+    SVGSchema* tmpSchema = (SVGSchema*)data;
+    char* tmpStr = malloc(sizeof(char) * (strlen(tmpSchema->fileName) + strlen("Schema: ") + 1));
+
+    sprintf(tmpStr, "Schema: %s", tmpSchema->fileName);
+    return tmpStr;
+}
+
+static void deleteSchema(void* data) {
+    releaseSVGSchema((SVGSchema*)data);
+}
+
+static int compareSchemas(const void* first, const void* second) {
+    if (first == NULL || second == NULL) {
+        return 0;
+    }
+
+    return strcmp(((SVGSchema*)first)->fileName, ((SVGSchema*)second)->fileName);
+}
+
+static bool schemaHasName(const void* first, const void* second) {
+    return strcmp(((SVGSchema*)first)->fileName, (char*)second) == 0;
+}
+
+/**
+ * @brief Compiles a schema file once so it can be reused for many documents.
+ * Most code used from the documentation references that Prof. Denis has provided
+ * in the Modules
+ * @param schemaFile
+ * @return SVGSchema*
+ */
+SVGSchema* loadSVGSchema(const char* schemaFile) {
+    if (schemaFile == NULL || strcmp(schemaFile, "") == 0) {
+        return NULL;
+    }
+
+    LIBXML_TEST_VERSION
+
+    /*Counted before compiling, so cleanupSVGParser() cannot free the built-in types
+    while the compiler is using them*/
+    countSchema(1);
+
+    xmlSchemaParserCtxtPtr ctxt = xmlSchemaNewParserCtxt(schemaFile);
+    if (ctxt == NULL) {
+        countSchema(-1);
+        return NULL;
+    }
+
+    xmlSchemaSetParserErrors(ctxt, (xmlSchemaValidityErrorFunc) ignoreSchemaErrors, (xmlSchemaValidityWarningFunc) ignoreSchemaErrors, NULL);
+    xmlSchemaPtr schema = xmlSchemaParse(ctxt);
+    xmlSchemaFreeParserCtxt(ctxt);
+
+    if (schema == NULL) {
+        countSchema(-1);
+        return NULL;
+    }
+
+    SVGSchema* handle = malloc(sizeof(SVGSchema));
+    handle->fileName = malloc(sizeof(char) * (strlen(schemaFile) + 1));
+    strcpy(handle->fileName, schemaFile);
+    handle->schema = schema;
+
+    return handle;
+}
+
+/**
+ * @brief Frees a schema handle created by loadSVGSchema()
+ * @param schema
+ */
+void releaseSVGSchema(SVGSchema* schema) {
+    if (schema == NULL) {
+        return ;
+    }
+
+    xmlSchemaFree(schema->schema);
+    free(schema->fileName);
+    free(schema);
+
+    countSchema(-1);
+}
+
+/**
+ * @brief Returns the process-wide compiled schema for schemaFile, compiling it on first use
+ * @param schemaFile
+ * @return const SVGSchema*
+ */
+const SVGSchema* getCachedSVGSchema(const char* schemaFile) {
+    if (schemaFile == NULL || strcmp(schemaFile, "") == 0) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&schemaCacheLock);
+    if (schemaCache == NULL) {
+        schemaCache = initializeList(&schemaToString, &deleteSchema, &compareSchemas);
+    }
+    SVGSchema* schema = (SVGSchema*)findElement(schemaCache, &schemaHasName, schemaFile);
+    pthread_mutex_unlock(&schemaCacheLock);
+
+    if (schema != NULL) {
+        return schema;
+    }
+
+    /*Compile outside the lock, then re-check in case another thread beat us to it*/
+    SVGSchema* newSchema = loadSVGSchema(schemaFile);
+    if (newSchema == NULL) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&schemaCacheLock);
+    schema = (SVGSchema*)findElement(schemaCache, &schemaHasName, schemaFile);
+    if (schema == NULL) {
+        insertBack(schemaCache, (void*)newSchema);
+        schema = newSchema;
+        newSchema = NULL;
+    }
+    pthread_mutex_unlock(&schemaCacheLock);
+
+    releaseSVGSchema(newSchema);
+    return schema;
+}
+
+/**
+ * @brief Releases every schema held by the process-wide cache
+ */
+void releaseCachedSVGSchemas(void) {
+    pthread_mutex_lock(&schemaCacheLock);
+    List* oldCache = schemaCache;
+    schemaCache = NULL;
+    pthread_mutex_unlock(&schemaCacheLock);
+
+    if (oldCache != NULL) {
+        freeList(oldCache);
+    }
+}
+
+/**
+ * @brief Frees libxml2's global parser state, unless a compiled schema still needs it,
+ * and the list node pool, unless nodes are still in use
+ */
+void cleanupSVGParser(void) {
+    /*The lock is held through the cleanup, so no schema can start compiling until it is done*/
+    pthread_mutex_lock(&schemaCacheLock);
+    if (liveSchemas == 0) {
+        xmlSchemaCleanupTypes();
+        xmlCleanupParser();
+    }
+    pthread_mutex_unlock(&schemaCacheLock);
+
+    releaseListPool();
+}
+
+/**
+ * @brief Validates a parsed XML document against a compiled schema
+ * @param doc
+ * @param schema
+ * @return true
+ * @return false
+ */
+bool validateDocWithSchema(xmlDoc* doc, const SVGSchema* schema) {
+    if (doc == NULL || schema == NULL) {
+        return false;
+    }
+
+    /*Validation contexts are cheap and per-call, the compiled schema is shared*/
+    xmlSchemaValidCtxtPtr ctxt = xmlSchemaNewValidCtxt(schema->schema);
+    if (ctxt == NULL) {
+        return false;
+    }
+
+    xmlSchemaSetValidErrors(ctxt, (xmlSchemaValidityErrorFunc) ignoreSchemaErrors, (xmlSchemaValidityWarningFunc) ignoreSchemaErrors, NULL);
+    int ret = xmlSchemaValidateDoc(ctxt, doc);
+    xmlSchemaFreeValidCtxt(ctxt);
+
+    return ret == 0;
+}
+
+/**
+ * @brief Adds the value of an id attribute to a set of ids
+ * @param ids
+ * @param value
+ * @return true
+ * @return false
+ */
+bool addUniqueId(xmlHashTablePtr ids, const char* value) {
+    xmlChar* collapsed = xmlSchemaCollapseString(BAD_CAST value);
+    bool added = xmlHashAddEntry(ids, (collapsed != NULL) ? collapsed : BAD_CAST value, ids) == 0;
+
+    xmlFree(collapsed);
+    return added;
+}
+
+/*Feeds the XML an SVG struct would be written as to a schema validator, one SAX event at a time*/
+typedef struct {
+    xmlSAXHandlerPtr sax;
+    void* userData;
+    xmlSchemaValidCtxtPtr validator;
+    //Namespace of every element - children inherit the namespace of the svg element
+    const xmlChar* uri;
+    //Formatted coordinates and sizes of the current element
+    StringBuilder values;
+    //SAX attribute array of the current element: name, prefix, URI, value and end of value
+    //for every attribute
+    const xmlChar** attributes;
+    size_t capacity;
+    //Values of the id attributes sent so far (see addUniqueId)
+    xmlHashTablePtr ids;
+    bool failed;
+} StructEvents;
+
+/*Formats the coordinates and sizes of a shape the way writeSVG() writes them*/
+static void formatLengths(StructEvents* events, const float* lengths, int count, const char* units, const char** values) {
+    size_t offsets[4];
+
+    events->values.length = 0;
+    for (int i = 0; i < count; i++) {
+        offsets[i] = events->values.length;
+        appendFormat(&events->values, "%f%s", lengths[i], units);
+        appendChar(&events->values, '\0');
+    }
+
+    /*The buffer may have moved while it grew, so the values are only located once it is done*/
+    if (events->values.failed) {
+        events->failed = true;
+        return ;
+    }
+    for (int i = 0; i < count; i++) {
+        values[i] = events->values.data + offsets[i];
+    }
+}
+
+static void setSAXAttribute(const xmlChar** slot, const char* name, const char* value) {
+    slot[0] = BAD_CAST name;
+    slot[1] = NULL;
+    slot[2] = NULL;
+    slot[3] = BAD_CAST value;
+    slot[4] = BAD_CAST value + strlen(value);
+}
+
+/*Starts an element with its own attributes (names and values) followed by its other attributes*/
+static void startElement(StructEvents* events, const char* name, const char** names, const char** values, int count, List* otherAttributes, bool declareNamespace) {
+    size_t numAttributes = (size_t)count + ((otherAttributes != NULL) ? (size_t)getLength(otherAttributes) : 0);
+
+    if (events->failed) {
+        return ;
+    }
+
+    if (numAttributes * 5 > events->capacity) {
+        size_t capacity = numAttributes * 5 * 2;
+        const xmlChar** attributes = realloc(events->attributes, capacity * sizeof(xmlChar*));
+
+        if (attributes == NULL) {
+            events->failed = true;
+            return ;
+        }
+        events->attributes = attributes;
+        events->capacity = capacity;
+    }
+
+    int numSet = 0;
+    for (int i = 0; i < count; i++) {
+        setSAXAttribute(events->attributes + 5 * numSet++, names[i], values[i]);
+    }
+
+    if (otherAttributes != NULL) {
+        void* elem;
+        ListIterator iter = createIterator(otherAttributes);
+
+        while ((elem = nextElement(&iter)) != NULL) {
+            Attribute* attr = (Attribute*)elem;
+
+            if (attr->name != NULL) {
+                setSAXAttribute(events->attributes + 5 * numSet++, attr->name, attr->value);
+                if (strcmp(attr->name, "id") == 0 && !addUniqueId(events->ids, attr->value)) {
+                    events->failed = true;
+                }
+            }
+        }
+    }
+
+    /*The namespace is declared on the svg element as the default namespace*/
+    const xmlChar* namespaces[2] = {NULL, events->uri};
+    events->sax->startElementNs(events->userData, BAD_CAST name, NULL, events->uri, declareNamespace ? 1 : 0, namespaces, numSet, 0, events->attributes);
+}
+
+static void endElement(StructEvents* events, const char* name) {
+    if (!events->failed) {
+        events->sax->endElementNs(events->userData, BAD_CAST name, NULL, events->uri);
+    }
+}
+
+/*Stops feeding events as soon as the validator has found an error*/
+static bool stillValid(StructEvents* events) {
+    return !events->failed && xmlSchemaIsValid(events->validator) == 1;
+}
+
+static void textElement(StructEvents* events, const char* name, const char* text) {
+    startElement(events, name, NULL, NULL, 0, NULL, false);
+    if (!events->failed) {
+        events->sax->characters(events->userData, BAD_CAST text, (int)strlen(text));
+    }
+    endElement(events, name);
+}
+
+/*Sends the shapes and groups shared by groups and the svg element, in the order writeSVG() writes them*/
+static void sendComponents(StructEvents* events, List* rectangles, List* circles, List* paths, List* groups) {
+    static const char* rectNames[] = {"x", "y", "width", "height"};
+    static const char* circleNames[] = {"cx", "cy", "r"};
+    static const char* pathNames[] = {"d"};
+    const char* values[4];
+    void* elem;
+    ListIterator iter;
+
+    iter = createIterator(rectangles);
+    while ((elem = nextElement(&iter)) != NULL && stillValid(events)) {
+        Rectangle* rect = (Rectangle*)elem;
+        float lengths[] = {rect->x, rect->y, rect->width, rect->height};
+
+        formatLengths(events, lengths, 4, rect->units, values);
+        startElement(events, "rect", rectNames, values, 4, rect->otherAttributes, false);
+        endElement(events, "rect");
+    }
+
+    iter = createIterator(circles);
+    while ((elem = nextElement(&iter)) != NULL && stillValid(events)) {
+        Circle* circle = (Circle*)elem;
+        float lengths[] = {circle->cx, circle->cy, circle->r};
+
+        formatLengths(events, lengths, 3, circle->units, values);
+        startElement(events, "circle", circleNames, values, 3, circle->otherAttributes, false);
+        endElement(events, "circle");
+    }
+
+    iter = createIterator(paths);
+    while ((elem = nextElement(&iter)) != NULL && stillValid(events)) {
+        Path* path = (Path*)elem;
+
+        values[0] = path->data;
+        startElement(events, "path", pathNames, values, 1, path->otherAttributes, false);
+        endElement(events, "path");
+    }
+
+    iter = createIterator(groups);
+    while ((elem = nextElement(&iter)) != NULL && stillValid(events)) {
+        Group* group = (Group*)elem;
+
+        startElement(events, "g", NULL, NULL, 0, group->otherAttributes, false);
+        sendComponents(events, group->rectangles, group->circles, group->paths, group->groups);
+        endElement(events, "g");
+    }
+}
+
+/**
+ * @brief Validates the XML an SVG struct is written as against a compiled schema, without
+ * building or printing that XML
+ * @param img
+ * @param schema
+ * @return true
+ * @return false
+ */
+bool validateStructWithSchema(const SVG* img, const SVGSchema* schema) {
+    if (img == NULL || schema == NULL) {
+        return false;
+    }
+
+    xmlSchemaValidCtxtPtr ctxt = xmlSchemaNewValidCtxt(schema->schema);
+    if (ctxt == NULL) {
+        return false;
+    }
+    xmlSchemaSetValidErrors(ctxt, (xmlSchemaValidityErrorFunc) ignoreSchemaErrors, (xmlSchemaValidityWarningFunc) ignoreSchemaErrors, NULL);
+
+    /*Without a SAX handler of our own, the plug hands back the validator's handlers directly*/
+    StructEvents events = {NULL, NULL, ctxt, BAD_CAST img->namespace, createStringBuilder(0), NULL, 0, xmlHashCreate(0), false};
+    xmlSchemaSAXPlugPtr plug = (events.ids != NULL) ? xmlSchemaSAXPlug(ctxt, &events.sax, &events.userData) : NULL;
+    if (plug == NULL) {
+        xmlSchemaFreeValidCtxt(ctxt);
+        discardString(&events.values);
+        xmlHashFree(events.ids, NULL);
+        return false;
+    }
+
+    startElement(&events, "svg", NULL, NULL, 0, img->otherAttributes, true);
+    if (strcmp(img->title, "") != 0) {
+        textElement(&events, "title", img->title);
+    }
+    if (strcmp(img->description, "") != 0) {
+        textElement(&events, "desc", img->description);
+    }
+    sendComponents(&events, img->rectangles, img->circles, img->paths, img->groups);
+    endElement(&events, "svg");
+
+    bool valid = stillValid(&events);
+    xmlSchemaSAXUnplug(plug);
+    valid = valid && xmlSchemaIsValid(ctxt) == 1;
+
+    xmlSchemaFreeValidCtxt(ctxt);
+    discardString(&events.values);
+    free(events.attributes);
+    xmlHashFree(events.ids, NULL);
+
+    return valid;
+}
@@ -0,0 +1,659 @@
+/**
+ * @file SVGSnapshot.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief This file contains the binary snapshot format (see SVGSnapshot.h), which saves a
+ * parsed SVG struct so it can be loaded back without parsing or validating XML again
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+/*open(), fstat() and mmap() are POSIX, not C11*/
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "SVGParser.h"
+#include "SVGSnapshot.h"
+#include "SVGHelpers.h"
+#include "SVGArena.h"
+#include "SVGIntern.h"
+#include "StringBuilder.h"
+#include "LinkedListAPI.h"
+
+/*Sections of a snapshot, in the order they are written*/
+enum {
+    SECTION_STRINGS,
+    SECTION_STRING_DATA,
+    SECTION_ATTRIBUTES,
+    SECTION_RECTS,
+    SECTION_CIRCLES,
+    SECTION_PATHS,
+    SECTION_GROUPS,
+    NUM_SECTIONS
+};
+
+/*Sections start on multiples of this, so records are aligned once the snapshot is mapped*/
+#define SNAPSHOT_ALIGNMENT 8
+
+_Static_assert(sizeof(SVGSnapshotHeader) % SNAPSHOT_ALIGNMENT == 0, "the header must keep the sections aligned");
+
+/* ******************************* Writer ******************************* */
+
+/*State of one SVGtoSnapshot() call.  Every section is built in its own buffer*/
+typedef struct {
+    StringBuilder sections[NUM_SECTIONS];
+    //Hash table of the strings written so far.  A slot holds a string index + 1, or 0 if empty
+    uint32_t* slots;
+    size_t numSlots;
+    uint32_t numStrings;
+    //Groups in breadth-first order.  Group i of the snapshot is queue[i]
+    Group** queue;
+    size_t queueLength;
+    size_t queueCapacity;
+    bool failed;
+} SnapshotWriter;
+
+static size_t numRecords(const SnapshotWriter* writer, int section, size_t recordSize) {
+    return writer->sections[section].length / recordSize;
+}
+
+/*Index the next record of a section will get, failing once it no longer fits the format*/
+static uint32_t nextIndex(SnapshotWriter* writer, int section, size_t recordSize) {
+    size_t index = numRecords(writer, section, recordSize);
+
+    if (index >= UINT32_MAX) {
+        writer->failed = true;
+        return 0;
+    }
+    return (uint32_t)index;
+}
+
+static void appendRecord(SnapshotWriter* writer, int section, const void* record, size_t recordSize) {
+    appendChars(&writer->sections[section], (const char*)record, recordSize);
+    if (writer->sections[section].failed) {
+        writer->failed = true;
+    }
+}
+
+/*FNV-1a*/
+static uint32_t hashString(const char* str) {
+    uint32_t hash = 2166136261u;
+
+    for (const unsigned char* c = (const unsigned char*)str; *c != '\0'; c++) {
+        hash = (hash ^ *c) * 16777619u;
+    }
+    return hash;
+}
+
+static const char* stringAt(const SnapshotWriter* writer, uint32_t index) {
+    SVGSnapshotString entry;
+
+    memcpy(&entry, writer->sections[SECTION_STRINGS].data + index * sizeof(entry), sizeof(entry));
+    return writer->sections[SECTION_STRING_DATA].data + entry.offset;
+}
+
+/*Doubles the hash table, keeping it at most half full*/
+static bool growStringTable(SnapshotWriter* writer) {
+    size_t numSlots = (writer->numSlots == 0) ? 256 : writer->numSlots * 2;
+    uint32_t* slots = calloc(numSlots, sizeof(uint32_t));
+
+    if (slots == NULL) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < writer->numStrings; i++) {
+        size_t slot = hashString(stringAt(writer, i)) & (numSlots - 1);
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & (numSlots - 1);
+        }
+        slots[slot] = i + 1;
+    }
+
+    free(writer->slots);
+    writer->slots = slots;
+    writer->numSlots = numSlots;
+    return true;
+}
+
+/*Returns the index of str, adding it to the string table if it is not there yet*/
+static uint32_t addString(SnapshotWriter* writer, const char* str) {
+    if (str == NULL) {
+        str = "";
+    }
+    if (writer->failed || ((writer->numStrings + 1) * 2 > writer->numSlots && !growStringTable(writer))) {
+        writer->failed = true;
+        return 0;
+    }
+
+    size_t slot = hashString(str) & (writer->numSlots - 1);
+    while (writer->slots[slot] != 0) {
+        if (strcmp(stringAt(writer, writer->slots[slot] - 1), str) == 0) {
+            return writer->slots[slot] - 1;
+        }
+        slot = (slot + 1) & (writer->numSlots - 1);
+    }
+
+    StringBuilder* data = &writer->sections[SECTION_STRING_DATA];
+    size_t length = strlen(str);
+    if (writer->numStrings == UINT32_MAX || data->length + length >= UINT32_MAX) {
+        writer->failed = true;
+        return 0;
+    }
+
+    SVGSnapshotString entry = {(uint32_t)data->length, (uint32_t)length};
+    /*The NUL is kept in the string data, so loaded strings can be used in place*/
+    appendChars(data, str, length + 1);
+    appendRecord(writer, SECTION_STRINGS, &entry, sizeof(entry));
+    if (data->failed || writer->failed) {
+        writer->failed = true;
+        return 0;
+    }
+
+    writer->slots[slot] = writer->numStrings + 1;
+    return writer->numStrings++;
+}
+
+/*Writes every attribute of a list, setting the range they take*/
+static void writeAttributes(SnapshotWriter* writer, List* list, uint32_t* first, uint32_t* num) {
+    *first = nextIndex(writer, SECTION_ATTRIBUTES, sizeof(SVGSnapshotAttribute));
+
+    void* elem;
+    ListIterator iter = createIterator(list);
+    while ((elem = nextElement(&iter)) != NULL && !writer->failed) {
+        Attribute* attr = (Attribute*)elem;
+        SVGSnapshotAttribute record = {addString(writer, attr->name), addString(writer, attr->value)};
+
+        appendRecord(writer, SECTION_ATTRIBUTES, &record, sizeof(record));
+    }
+
+    *num = nextIndex(writer, SECTION_ATTRIBUTES, sizeof(SVGSnapshotAttribute)) - *first;
+}
+
+/*Writes the attributes and shapes of the svg element or a group, and queues its child groups*/
+static void writeOwner(SnapshotWriter* writer, SVGSnapshotGroup* record, List* attributes, List* rectangles, List* circles, List* paths, List* groups) {
+    void* elem;
+    ListIterator iter;
+
+    writeAttributes(writer, attributes, &record->firstAttribute, &record->numAttributes);
+
+    record->firstRect = nextIndex(writer, SECTION_RECTS, sizeof(SVGSnapshotRect));
+    iter = createIterator(rectangles);
+    while ((elem = nextElement(&iter)) != NULL && !writer->failed) {
+        Rectangle* rect = (Rectangle*)elem;
+        SVGSnapshotRect shape = {rect->x, rect->y, rect->width, rect->height, addString(writer, rect->units), 0, 0};
+
+        writeAttributes(writer, rect->otherAttributes, &shape.firstAttribute, &shape.numAttributes);
+        appendRecord(writer, SECTION_RECTS, &shape, sizeof(shape));
+    }
+    record->numRects = nextIndex(writer, SECTION_RECTS, sizeof(SVGSnapshotRect)) - record->firstRect;
+
+    record->firstCircle = nextIndex(writer, SECTION_CIRCLES, sizeof(SVGSnapshotCircle));
+    iter = createIterator(circles);
+    while ((elem = nextElement(&iter)) != NULL && !writer->failed) {
+        Circle* circle = (Circle*)elem;
+        SVGSnapshotCircle shape = {circle->cx, circle->cy, circle->r, addString(writer, circle->units), 0, 0};
+
+        writeAttributes(writer, circle->otherAttributes, &shape.firstAttribute, &shape.numAttributes);
+        appendRecord(writer, SECTION_CIRCLES, &shape, sizeof(shape));
+    }
+    record->numCircles = nextIndex(writer, SECTION_CIRCLES, sizeof(SVGSnapshotCircle)) - record->firstCircle;
+
+    record->firstPath = nextIndex(writer, SECTION_PATHS, sizeof(SVGSnapshotPath));
+    iter = createIterator(paths);
+    while ((elem = nextElement(&iter)) != NULL && !writer->failed) {
+        Path* path = (Path*)elem;
+        SVGSnapshotPath shape = {addString(writer, path->data), 0, 0};
+
+        writeAttributes(writer, path->otherAttributes, &shape.firstAttribute, &shape.numAttributes);
+        appendRecord(writer, SECTION_PATHS, &shape, sizeof(shape));
+    }
+    record->numPaths = nextIndex(writer, SECTION_PATHS, sizeof(SVGSnapshotPath)) - record->firstPath;
+
+    /*Child groups get the next free indices, and are written when the queue reaches them*/
+    if (writer->queueLength >= UINT32_MAX) {
+        writer->failed = true;
+    }
+    record->firstGroup = (uint32_t)writer->queueLength;
+    iter = createIterator(groups);
+    while ((elem = nextElement(&iter)) != NULL && !writer->failed) {
+        if (writer->queueLength == writer->queueCapacity) {
+            size_t capacity = (writer->queueCapacity == 0) ? 64 : writer->queueCapacity * 2;
+            Group** queue = realloc(writer->queue, capacity * sizeof(Group*));
+
+            if (queue == NULL) {
+                writer->failed = true;
+                break;
+            }
+            writer->queue = queue;
+            writer->queueCapacity = capacity;
+        }
+        writer->queue[writer->queueLength++] = (Group*)elem;
+    }
+    record->numGroups = (uint32_t)writer->queueLength - record->firstGroup;
+}
+
+static size_t alignSize(size_t size) {
+    return (size + SNAPSHOT_ALIGNMENT - 1) & ~(size_t)(SNAPSHOT_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Encodes an SVG struct as a snapshot in memory
+ * @param img
+ * @param length
+ * @return void*
+ */
+void* SVGtoSnapshot(const SVG* img, size_t* length) {
+    if (img == NULL || length == NULL) {
+        return NULL;
+    }
+
+    SnapshotWriter writer;
+    memset(&writer, 0, sizeof(writer));
+    for (int i = 0; i < NUM_SECTIONS; i++) {
+        writer.sections[i] = createStringBuilder(0);
+    }
+
+    SVGSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SVG_SNAPSHOT_MAGIC, sizeof(SVG_SNAPSHOT_MAGIC));
+    header.version = SVG_SNAPSHOT_VERSION;
+    header.byteOrder = SVG_SNAPSHOT_BYTE_ORDER;
+    header.namespace = addString(&writer, img->namespace);
+    header.title = addString(&writer, img->title);
+    header.description = addString(&writer, img->description);
+
+    writeOwner(&writer, &header.root, img->otherAttributes, img->rectangles, img->circles, img->paths, img->groups);
+    for (size_t i = 0; i < writer.queueLength && !writer.failed; i++) {
+        Group* group = writer.queue[i];
+        SVGSnapshotGroup record;
+
+        writeOwner(&writer, &record, group->otherAttributes, group->rectangles, group->circles, group->paths, group->groups);
+        appendRecord(&writer, SECTION_GROUPS, &record, sizeof(record));
+    }
+
+    /*Lays the sections out one after the other behind the header*/
+    uint64_t* offsets[NUM_SECTIONS] = {&header.stringsOffset, &header.stringDataOffset, &header.attributesOffset,
+        &header.rectsOffset, &header.circlesOffset, &header.pathsOffset, &header.groupsOffset};
+    size_t size = sizeof(header);
+    for (int i = 0; i < NUM_SECTIONS; i++) {
+        *offsets[i] = size;
+        size = alignSize(size + writer.sections[i].length);
+    }
+
+    header.fileSize = size;
+    header.stringDataSize = writer.sections[SECTION_STRING_DATA].length;
+    header.numStrings = writer.numStrings;
+    header.numAttributes = (uint32_t)numRecords(&writer, SECTION_ATTRIBUTES, sizeof(SVGSnapshotAttribute));
+    header.numRects = (uint32_t)numRecords(&writer, SECTION_RECTS, sizeof(SVGSnapshotRect));
+    header.numCircles = (uint32_t)numRecords(&writer, SECTION_CIRCLES, sizeof(SVGSnapshotCircle));
+    header.numPaths = (uint32_t)numRecords(&writer, SECTION_PATHS, sizeof(SVGSnapshotPath));
+    header.numGroups = (uint32_t)numRecords(&writer, SECTION_GROUPS, sizeof(SVGSnapshotGroup));
+
+    /*The padding between sections is zeroed, so equal structs give identical snapshots*/
+    char* snapshot = writer.failed ? NULL : calloc(1, size);
+    if (snapshot != NULL) {
+        memcpy(snapshot, &header, sizeof(header));
+        for (int i = 0; i < NUM_SECTIONS; i++) {
+            if (writer.sections[i].length > 0) {
+                memcpy(snapshot + *offsets[i], writer.sections[i].data, writer.sections[i].length);
+            }
+        }
+        *length = size;
+    }
+
+    for (int i = 0; i < NUM_SECTIONS; i++) {
+        discardString(&writer.sections[i]);
+    }
+    free(writer.slots);
+    free(writer.queue);
+
+    return snapshot;
+}
+
+/**
+ * @brief Writes a snapshot of an SVG struct to a file, replacing it if it exists
+ * @param img
+ * @param fileName
+ * @return true
+ * @return false
+ */
+bool writeSVGSnapshot(const SVG* img, const char* fileName) {
+    if (img == NULL || fileName == NULL || strcmp(fileName, "") == 0) {
+        return false;
+    }
+
+    size_t length;
+    void* snapshot = SVGtoSnapshot(img, &length);
+    if (snapshot == NULL) {
+        return false;
+    }
+
+    FILE* file = fopen(fileName, "wb");
+    bool written = (file != NULL && fwrite(snapshot, 1, length, file) == length);
+    if (file != NULL && fclose(file) != 0) {
+        written = false;
+    }
+    free(snapshot);
+
+    return written;
+}
+
+/* ******************************* Loader ******************************* */
+
+/*Kinds of records, in the order of the counters of a SnapshotReader*/
+enum {
+    NEXT_ATTRIBUTE,
+    NEXT_RECT,
+    NEXT_CIRCLE,
+    NEXT_PATH,
+    NEXT_GROUP,
+    NUM_COUNTERS
+};
+
+/*State of one SVGFromSnapshot() call*/
+typedef struct {
+    const unsigned char* base;
+    SVGSnapshotHeader header;
+    SVGArena* arena;
+    //Index of the first record of each kind not used yet.  Every range must start there
+    uint32_t next[NUM_COUNTERS];
+    //Groups created so far, by index
+    Group** groups;
+} SnapshotReader;
+
+/*Claims the next num records of a kind*/
+static bool claimRange(SnapshotReader* reader, int kind, uint32_t first, uint32_t num, uint32_t total) {
+    if (first != reader->next[kind] || num > total - first) {
+        return false;
+    }
+
+    reader->next[kind] += num;
+    return true;
+}
+
+/*Records may be unaligned if the snapshot is, so they are copied out rather than cast*/
+static void readRecord(const SnapshotReader* reader, uint64_t offset, uint32_t index, void* record, size_t recordSize) {
+    memcpy(record, reader->base + offset + (uint64_t)index * recordSize, recordSize);
+}
+
+static const char* getString(const SnapshotReader* reader, uint32_t index, size_t* length) {
+    SVGSnapshotString entry;
+
+    if (index >= reader->header.numStrings) {
+        return NULL;
+    }
+    readRecord(reader, reader->header.stringsOffset, index, &entry, sizeof(entry));
+
+    /*Each string must end with its NUL inside the string data*/
+    const char* data = (const char*)reader->base + reader->header.stringDataOffset;
+    if (entry.offset >= reader->header.stringDataSize || entry.length >= reader->header.stringDataSize - entry.offset || data[entry.offset + entry.length] != '\0') {
+        return NULL;
+    }
+
+    if (length != NULL) {
+        *length = entry.length;
+    }
+    return data + entry.offset;
+}
+
+static bool readAttributes(SnapshotReader* reader, List* list, uint32_t first, uint32_t num) {
+    if (!claimRange(reader, NEXT_ATTRIBUTE, first, num, reader->header.numAttributes)) {
+        return false;
+    }
+
+    for (uint32_t i = first; i < first + num; i++) {
+        SVGSnapshotAttribute record;
+        readRecord(reader, reader->header.attributesOffset, i, &record, sizeof(record));
+
+        const char* name = getString(reader, record.name, NULL);
+        const char* value = getString(reader, record.value, NULL);
+        Attribute* attr = (name != NULL && value != NULL) ? createAttribute(reader->arena, name, value) : NULL;
+        if (attr == NULL) {
+            return false;
+        }
+        insertBack(list, attr);
+    }
+
+    return true;
+}
+
+static bool readUnits(const SnapshotReader* reader, uint32_t index, const char** units) {
+    size_t length;
+    const char* str = getString(reader, index, &length);
+
+    if (str == NULL) {
+        return false;
+    }
+    return setShapeUnits(reader->arena, units, str, length);
+}
+
+/*Builds the attributes and shapes of the svg element or a group, and creates its child groups*/
+static bool readOwner(SnapshotReader* reader, const SVGSnapshotGroup* record, List* attributes, List* rectangles, List* circles, List* paths, List* groups) {
+    const SVGSnapshotHeader* header = &reader->header;
+
+    if (!readAttributes(reader, attributes, record->firstAttribute, record->numAttributes)) {
+        return false;
+    }
+
+    if (!claimRange(reader, NEXT_RECT, record->firstRect, record->numRects, header->numRects)) {
+        return false;
+    }
+    for (uint32_t i = record->firstRect; i < record->firstRect + record->numRects; i++) {
+        SVGSnapshotRect shape;
+        readRecord(reader, header->rectsOffset, i, &shape, sizeof(shape));
+
+        Rectangle* rect = createRectangle(reader->arena);
+        if (rect == NULL || !readUnits(reader, shape.units, &rect->units)) {
+            return false;
+        }
+        rect->x = shape.x;
+        rect->y = shape.y;
+        rect->width = shape.width;
+        rect->height = shape.height;
+        insertBack(rectangles, rect);
+
+        if (!readAttributes(reader, rect->otherAttributes, shape.firstAttribute, shape.numAttributes)) {
+            return false;
+        }
+    }
+
+    if (!claimRange(reader, NEXT_CIRCLE, record->firstCircle, record->numCircles, header->numCircles)) {
+        return false;
+    }
+    for (uint32_t i = record->firstCircle; i < record->firstCircle + record->numCircles; i++) {
+        SVGSnapshotCircle shape;
+        readRecord(reader, header->circlesOffset, i, &shape, sizeof(shape));
+
+        Circle* circle = createCircle(reader->arena);
+        if (circle == NULL || !readUnits(reader, shape.units, &circle->units)) {
+            return false;
+        }
+        circle->cx = shape.cx;
+        circle->cy = shape.cy;
+        circle->r = shape.r;
+        insertBack(circles, circle);
+
+        if (!readAttributes(reader, circle->otherAttributes, shape.firstAttribute, shape.numAttributes)) {
+            return false;
+        }
+    }
+
+    if (!claimRange(reader, NEXT_PATH, record->firstPath, record->numPaths, header->numPaths)) {
+        return false;
+    }
+    for (uint32_t i = record->firstPath; i < record->firstPath + record->numPaths; i++) {
+        SVGSnapshotPath shape;
+        readRecord(reader, header->pathsOffset, i, &shape, sizeof(shape));
+
+        const char* data = getString(reader, shape.data, NULL);
+        Path* path = (data != NULL) ? createPath(reader->arena, data) : NULL;
+        if (path == NULL) {
+            return false;
+        }
+        insertBack(paths, path);
+
+        if (!readAttributes(reader, path->otherAttributes, shape.firstAttribute, shape.numAttributes)) {
+            return false;
+        }
+    }
+
+    /*Child groups are only created here, and filled in when the loader reaches their index*/
+    if (!claimRange(reader, NEXT_GROUP, record->firstGroup, record->numGroups, header->numGroups)) {
+        return false;
+    }
+    for (uint32_t i = record->firstGroup; i < record->firstGroup + record->numGroups; i++) {
+        Group* group = createGroup(reader->arena);
+        if (group == NULL) {
+            return false;
+        }
+        reader->groups[i] = group;
+        insertBack(groups, group);
+    }
+
+    return true;
+}
+
+/*Checks that count records of a section lie inside the snapshot*/
+static bool sectionFits(uint64_t offset, uint64_t count, size_t recordSize, size_t length) {
+    return offset <= length && count <= (length - offset) / recordSize;
+}
+
+/*Checks the header and that every section lies inside the snapshot*/
+static bool checkHeader(const SVGSnapshotHeader* header, size_t length) {
+    char magic[sizeof(header->magic)] = SVG_SNAPSHOT_MAGIC;
+
+    return memcmp(header->magic, magic, sizeof(magic)) == 0
+        && header->version == SVG_SNAPSHOT_VERSION
+        && header->byteOrder == SVG_SNAPSHOT_BYTE_ORDER
+        && header->fileSize == length
+        && sectionFits(header->stringsOffset, header->numStrings, sizeof(SVGSnapshotString), length)
+        && sectionFits(header->stringDataOffset, header->stringDataSize, 1, length)
+        && sectionFits(header->attributesOffset, header->numAttributes, sizeof(SVGSnapshotAttribute), length)
+        && sectionFits(header->rectsOffset, header->numRects, sizeof(SVGSnapshotRect), length)
+        && sectionFits(header->circlesOffset, header->numCircles, sizeof(SVGSnapshotCircle), length)
+        && sectionFits(header->pathsOffset, header->numPaths, sizeof(SVGSnapshotPath), length)
+        && sectionFits(header->groupsOffset, header->numGroups, sizeof(SVGSnapshotGroup), length);
+}
+
+/*Copies one of the strings of the svg element into its fixed-size field, truncating it*/
+static bool readField(const SnapshotReader* reader, uint32_t index, char* field, size_t size) {
+    const char* str = getString(reader, index, NULL);
+
+    if (str == NULL) {
+        return false;
+    }
+    strncpy(field, str, size - 1);
+    field[size - 1] = '\0';
+    return true;
+}
+
+/**
+ * @brief Builds an SVG struct from a snapshot in memory
+ * @param data
+ * @param length
+ * @return SVG*
+ */
+SVG* SVGFromSnapshot(const void* data, size_t length) {
+    SnapshotReader reader;
+
+    if (data == NULL || length < sizeof(SVGSnapshotHeader)) {
+        return NULL;
+    }
+
+    memset(&reader, 0, sizeof(reader));
+    reader.base = (const unsigned char*)data;
+    memcpy(&reader.header, data, sizeof(reader.header));
+    if (!checkHeader(&reader.header, length)) {
+        return NULL;
+    }
+
+    /*checkHeader() bounds the number of groups by the size of the snapshot*/
+    reader.groups = malloc((reader.header.numGroups > 0 ? reader.header.numGroups : 1) * sizeof(Group*));
+    reader.arena = createArena(0);
+    SVG* img = (reader.arena != NULL) ? createSVGObject(reader.arena) : NULL;
+    if (reader.groups == NULL || img == NULL) {
+        free(reader.groups);
+        /*Once the SVG exists it owns the arena*/
+        if (img == NULL && reader.arena != NULL) {
+            freeArena(reader.arena);
+        }
+        deleteSVG(img);
+        return NULL;
+    }
+
+    bool loaded = readField(&reader, reader.header.namespace, img->namespace, sizeof(img->namespace))
+        && readField(&reader, reader.header.title, img->title, sizeof(img->title))
+        && readField(&reader, reader.header.description, img->description, sizeof(img->description))
+        && readOwner(&reader, &reader.header.root, img->otherAttributes, img->rectangles, img->circles, img->paths, img->groups);
+
+    /*Group i must have been created by an earlier owner before it is filled in*/
+    for (uint32_t i = 0; loaded && i < reader.header.numGroups; i++) {
+        SVGSnapshotGroup record;
+        Group* group = reader.groups[i];
+
+        if (i >= reader.next[NEXT_GROUP]) {
+            loaded = false;
+            break;
+        }
+        readRecord(&reader, reader.header.groupsOffset, i, &record, sizeof(record));
+        loaded = readOwner(&reader, &record, group->otherAttributes, group->rectangles, group->circles, group->paths, group->groups);
+    }
+
+    /*Every record must belong to something*/
+    loaded = loaded && reader.next[NEXT_ATTRIBUTE] == reader.header.numAttributes
+        && reader.next[NEXT_RECT] == reader.header.numRects
+        && reader.next[NEXT_CIRCLE] == reader.header.numCircles
+        && reader.next[NEXT_PATH] == reader.header.numPaths
+        && reader.next[NEXT_GROUP] == reader.header.numGroups;
+
+    free(reader.groups);
+    if (!loaded) {
+        deleteSVG(img);
+        return NULL;
+    }
+
+    return img;
+}
+
+/**
+ * @brief Maps a snapshot file into memory and builds an SVG struct from it
+ * @param fileName
+ * @return SVG*
+ */
+SVG* loadSVGSnapshot(const char* fileName) {
+    if (fileName == NULL || strcmp(fileName, "") == 0) {
+        return NULL;
+    }
+
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || (size_t)info.st_size < sizeof(SVGSnapshotHeader)) {
+        close(fd);
+        return NULL;
+    }
+
+    /*The mapping stays valid after the descriptor is closed*/
+    size_t length = (size_t)info.st_size;
+    void* data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+
+    posix_madvise(data, length, POSIX_MADV_SEQUENTIAL);
+    SVG* img = SVGFromSnapshot(data, length);
+    munmap(data, length);
+
+    return img;
+}
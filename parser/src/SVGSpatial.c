@@ -0,0 +1,779 @@
+/**
+ * @file SVGSpatial.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief This file contains the spatial index of an SVG struct: an R-tree over the bounds of
+ * every rectangle, circle and path, bulk-loaded with Sort-Tile-Recursive packing and updated
+ * in place by addComponent() and setAttribute().  It is cached in the views of the struct
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SVGParser.h"
+#include "SVGHelpers.h"
+#include "SVGViews.h"
+#include "SVGBounds.h"
+#include "SVGSpatial.h"
+#include "LinkedListAPI.h"
+
+/*A child of a node, or an entry, while nodes are being packed or split*/
+typedef struct {
+    float key;
+    int id;
+    SVGBounds bounds;
+} PackItem;
+
+/*Growable array of the entries matched by a query*/
+typedef struct {
+    const SVGSpatialEntry** entries;
+    int length;
+    int capacity;
+} EntryMatches;
+
+/*Queries return rectangles, then circles, then paths*/
+static int typeRank(elementType type) {
+    if (type == RECT) {
+        return 0;
+    } else if (type == CIRC) {
+        return 1;
+    }
+    return 2;
+}
+
+static SVGBounds elementBounds(SVGElementHandle handle) {
+    if (handle.type == RECT) {
+        return getRectBounds((Rectangle*)handle.element);
+    } else if (handle.type == CIRC) {
+        return getCircleBounds((Circle*)handle.element);
+    } else if (handle.type == PATH) {
+        return getPathBounds((Path*)handle.element);
+    }
+    return emptyBounds();
+}
+
+/*Shapes with NaN coordinates can never be matched, so they are kept out of the tree*/
+static bool isIndexable(SVGBounds bounds) {
+    return !bounds.empty && !isnan(bounds.minX) && !isnan(bounds.minY) && !isnan(bounds.maxX) && !isnan(bounds.maxY);
+}
+
+static bool intersects(SVGBounds a, SVGBounds b) {
+    return !a.empty && !b.empty && a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY;
+}
+
+static double boundsArea(SVGBounds bounds) {
+    if (bounds.empty) {
+        return 0;
+    }
+    return ((double)bounds.maxX - bounds.minX) * ((double)bounds.maxY - bounds.minY);
+}
+
+static SVGBounds nodeBounds(const SVGSpatialNode* node) {
+    SVGBounds bounds = emptyBounds();
+
+    for (int i = 0; i < node->count; i++) {
+        bounds = unionBounds(bounds, node->bounds[i]);
+    }
+    return bounds;
+}
+
+/* ******************************* Element table ******************************* */
+
+static int elementSlot(const SVGSpatialIndex* index, const void* element) {
+    unsigned long long hash = (unsigned long long)(size_t)element * 0x9E3779B97F4A7C15ULL;
+    return (int)(hash >> 32) & (index->numSlots - 1);
+}
+
+static void addSlot(SVGSpatialIndex* index, int entry) {
+    int slot = elementSlot(index, index->entries[entry].handle.element);
+
+    while (index->slots[slot] != 0) {
+        slot = (slot + 1) & (index->numSlots - 1);
+    }
+    index->slots[slot] = entry + 1;
+}
+
+/**
+ * @brief Finds the entry of an element
+ * @param index
+ * @param element
+ * @return int - position of the entry, or -1 if the element is not in the index
+ */
+static int findEntry(const SVGSpatialIndex* index, const void* element) {
+    if (index->numSlots == 0) {
+        return -1;
+    }
+
+    int slot = elementSlot(index, element);
+    while (index->slots[slot] != 0) {
+        int entry = index->slots[slot] - 1;
+
+        if (index->entries[entry].handle.element == element) {
+            return entry;
+        }
+        slot = (slot + 1) & (index->numSlots - 1);
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Adds an entry for an element, outside of the tree
+ * @param index
+ * @param handle
+ * @return int - position of the new entry, or -1 if memory ran out
+ */
+static int addEntry(SVGSpatialIndex* index, SVGElementHandle handle) {
+    if (index->numEntries == index->entriesCapacity) {
+        int capacity = (index->entriesCapacity == 0) ? 64 : index->entriesCapacity * 2;
+        SVGSpatialEntry* entries = realloc(index->entries, sizeof(SVGSpatialEntry) * capacity);
+
+        if (entries == NULL) {
+            return -1;
+        }
+        index->entries = entries;
+        index->entriesCapacity = capacity;
+    }
+
+    /*Keep the element table at most half full*/
+    if ((index->numEntries + 1) * 2 > index->numSlots) {
+        int numSlots = (index->numSlots == 0) ? 128 : index->numSlots * 2;
+        int* slots = calloc(numSlots, sizeof(int));
+
+        if (slots == NULL) {
+            return -1;
+        }
+        free(index->slots);
+        index->slots = slots;
+        index->numSlots = numSlots;
+        for (int i = 0; i < index->numEntries; i++) {
+            addSlot(index, i);
+        }
+    }
+
+    int entry = index->numEntries++;
+    index->entries[entry].handle = handle;
+    index->entries[entry].bounds = elementBounds(handle);
+    index->entries[entry].leaf = -1;
+    index->entries[entry].position = 0;
+    addSlot(index, entry);
+
+    return entry;
+}
+
+/* ******************************* Tree ******************************* */
+
+/**
+ * @brief Adds an empty node to the tree
+ * @param index
+ * @param leaf
+ * @return int - position of the node, or -1 if memory ran out
+ */
+static int newNode(SVGSpatialIndex* index, bool leaf) {
+    if (index->numNodes == index->nodesCapacity) {
+        int capacity = (index->nodesCapacity == 0) ? 16 : index->nodesCapacity * 2;
+        SVGSpatialNode* nodes = realloc(index->nodes, sizeof(SVGSpatialNode) * capacity);
+
+        if (nodes == NULL) {
+            return -1;
+        }
+        index->nodes = nodes;
+        index->nodesCapacity = capacity;
+    }
+
+    SVGSpatialNode* node = &index->nodes[index->numNodes];
+    node->count = 0;
+    node->parent = -1;
+    node->leaf = leaf;
+
+    return index->numNodes++;
+}
+
+/*Appends a child to a node that has room for it, and points the child back at the node*/
+static void appendChild(SVGSpatialIndex* index, int nodeId, int child, SVGBounds bounds) {
+    SVGSpatialNode* node = &index->nodes[nodeId];
+
+    node->bounds[node->count] = bounds;
+    node->children[node->count] = child;
+    node->count++;
+
+    if (node->leaf) {
+        index->entries[child].leaf = nodeId;
+    } else {
+        index->nodes[child].parent = nodeId;
+    }
+}
+
+/*Recomputes the bounds the ancestors of a node keep for their children, up to the root*/
+static void refitUpward(SVGSpatialIndex* index, int nodeId) {
+    while (index->nodes[nodeId].parent != -1) {
+        SVGSpatialNode* parent = &index->nodes[index->nodes[nodeId].parent];
+
+        for (int i = 0; i < parent->count; i++) {
+            if (parent->children[i] == nodeId) {
+                parent->bounds[i] = nodeBounds(&index->nodes[nodeId]);
+                break;
+            }
+        }
+        nodeId = index->nodes[nodeId].parent;
+    }
+}
+
+static int compareKeys(const void* first, const void* second) {
+    const PackItem* a = (const PackItem*)first;
+    const PackItem* b = (const PackItem*)second;
+
+    if (a->key != b->key) {
+        return (a->key < b->key) ? -1 : 1;
+    }
+    return a->id - b->id;
+}
+
+static float centreX(SVGBounds bounds) {
+    return bounds.minX * 0.5f + bounds.maxX * 0.5f;
+}
+
+static float centreY(SVGBounds bounds) {
+    return bounds.minY * 0.5f + bounds.maxY * 0.5f;
+}
+
+/**
+ * @brief Packs one level of the tree with Sort-Tile-Recursive: the items are sorted into
+ * vertical slices by the x of their centres, each slice by y, then cut into full nodes.
+ * The items are replaced by the new nodes
+ * @param index
+ * @param items - entries if leaf is true, otherwise nodes
+ * @param count
+ * @param leaf
+ * @return int - number of new nodes, or -1 if memory ran out
+ */
+static int packLevel(SVGSpatialIndex* index, PackItem* items, int count, bool leaf) {
+    int numNodes = (count + SPATIAL_NODE_SIZE - 1) / SPATIAL_NODE_SIZE;
+    int sliceSize = (int)ceil(sqrt((double)numNodes)) * SPATIAL_NODE_SIZE;
+
+    for (int i = 0; i < count; i++) {
+        items[i].key = centreX(items[i].bounds);
+    }
+    qsort(items, count, sizeof(PackItem), &compareKeys);
+
+    for (int start = 0; start < count; start += sliceSize) {
+        int length = (count - start < sliceSize) ? count - start : sliceSize;
+
+        for (int i = start; i < start + length; i++) {
+            items[i].key = centreY(items[i].bounds);
+        }
+        qsort(&items[start], length, sizeof(PackItem), &compareKeys);
+    }
+
+    /*Node i replaces items[i], which was already read as part of an earlier node*/
+    int written = 0;
+    for (int start = 0; start < count; start += SPATIAL_NODE_SIZE) {
+        int node = newNode(index, leaf);
+        if (node < 0) {
+            return -1;
+        }
+
+        for (int i = start; i < count && i < start + SPATIAL_NODE_SIZE; i++) {
+            appendChild(index, node, items[i].id, items[i].bounds);
+        }
+        items[written].id = node;
+        items[written].bounds = nodeBounds(&index->nodes[node]);
+        written++;
+    }
+
+    return written;
+}
+
+/**
+ * @brief Bulk-loads the index with every rectangle, circle and path of the views
+ * @param index
+ * @param views - must be up to date
+ * @return true
+ * @return false if memory ran out
+ */
+static bool loadSpatialIndex(SVGSpatialIndex* index, const SVGViews* views) {
+    const SVGView* shapes[] = {&views->rects, &views->circles, &views->paths};
+    const elementType types[] = {RECT, CIRC, PATH};
+
+    index->numNodes = 0;
+    index->numEntries = 0;
+    if (index->slots != NULL) {
+        memset(index->slots, 0, sizeof(int) * index->numSlots);
+    }
+
+    for (int type = 0; type < 3; type++) {
+        for (int i = 0; i < shapes[type]->length; i++) {
+            SVGElementHandle handle = {types[type], shapes[type]->elements[i]};
+            int entry = addEntry(index, handle);
+
+            if (entry < 0) {
+                return false;
+            }
+            index->entries[entry].position = i;
+        }
+    }
+
+    PackItem* items = malloc(sizeof(PackItem) * (index->numEntries > 0 ? index->numEntries : 1));
+    if (items == NULL) {
+        return false;
+    }
+
+    int count = 0;
+    for (int i = 0; i < index->numEntries; i++) {
+        if (isIndexable(index->entries[i].bounds)) {
+            items[count].id = i;
+            items[count].bounds = index->entries[i].bounds;
+            count++;
+        }
+    }
+
+    if (count == 0) {
+        index->root = newNode(index, true);
+        free(items);
+        return index->root >= 0;
+    }
+
+    /*Every level is packed into the next one until a single node, the root, is left*/
+    bool leaf = true;
+    do {
+        count = packLevel(index, items, count, leaf);
+        leaf = false;
+    } while (count > 1);
+
+    index->root = (count == 1) ? items[0].id : -1;
+    free(items);
+
+    return index->root >= 0;
+}
+
+/*Finds the leaf whose bounds grow the least when bounds are added to it*/
+static int chooseLeaf(const SVGSpatialIndex* index, SVGBounds bounds) {
+    int nodeId = index->root;
+
+    while (!index->nodes[nodeId].leaf) {
+        const SVGSpatialNode* node = &index->nodes[nodeId];
+        int best = 0;
+        double bestGrowth = INFINITY;
+        double bestArea = INFINITY;
+
+        for (int i = 0; i < node->count; i++) {
+            double area = boundsArea(node->bounds[i]);
+            double growth = boundsArea(unionBounds(node->bounds[i], bounds)) - area;
+
+            if (growth < bestGrowth || (growth == bestGrowth && area < bestArea)) {
+                best = i;
+                bestGrowth = growth;
+                bestArea = area;
+            }
+        }
+        nodeId = node->children[best];
+    }
+
+    return nodeId;
+}
+
+/**
+ * @brief Adds a child to a node, splitting the node (and its ancestors) if it is full
+ * @param index
+ * @param nodeId
+ * @param child
+ * @param bounds
+ * @return true
+ * @return false if memory ran out, in which case the tree is no longer usable
+ */
+static bool addChild(SVGSpatialIndex* index, int nodeId, int child, SVGBounds bounds) {
+    if (index->nodes[nodeId].count < SPATIAL_NODE_SIZE) {
+        appendChild(index, nodeId, child, bounds);
+        refitUpward(index, nodeId);
+        return true;
+    }
+
+    /*A full node is split in two halves along the axis its children's centres spread most on*/
+    PackItem items[SPATIAL_NODE_SIZE + 1];
+    SVGSpatialNode* node = &index->nodes[nodeId];
+    float minX = INFINITY, maxX = -INFINITY, minY = INFINITY, maxY = -INFINITY;
+
+    for (int i = 0; i <= SPATIAL_NODE_SIZE; i++) {
+        items[i].id = (i < SPATIAL_NODE_SIZE) ? node->children[i] : child;
+        items[i].bounds = (i < SPATIAL_NODE_SIZE) ? node->bounds[i] : bounds;
+        minX = fminf(minX, centreX(items[i].bounds));
+        maxX = fmaxf(maxX, centreX(items[i].bounds));
+        minY = fminf(minY, centreY(items[i].bounds));
+        maxY = fmaxf(maxY, centreY(items[i].bounds));
+    }
+    for (int i = 0; i <= SPATIAL_NODE_SIZE; i++) {
+        items[i].key = (maxX - minX >= maxY - minY) ? centreX(items[i].bounds) : centreY(items[i].bounds);
+    }
+    qsort(items, SPATIAL_NODE_SIZE + 1, sizeof(PackItem), &compareKeys);
+
+    int sibling = newNode(index, index->nodes[nodeId].leaf);
+    if (sibling < 0) {
+        return false;
+    }
+
+    index->nodes[nodeId].count = 0;
+    for (int i = 0; i <= SPATIAL_NODE_SIZE; i++) {
+        appendChild(index, (i < (SPATIAL_NODE_SIZE + 1) / 2) ? nodeId : sibling, items[i].id, items[i].bounds);
+    }
+
+    if (index->nodes[nodeId].parent == -1) {
+        int root = newNode(index, false);
+        if (root < 0) {
+            return false;
+        }
+        appendChild(index, root, nodeId, nodeBounds(&index->nodes[nodeId]));
+        appendChild(index, root, sibling, nodeBounds(&index->nodes[sibling]));
+        index->root = root;
+        return true;
+    }
+
+    /*The parent gets the shrunk bounds of the node, then the sibling as a new child*/
+    SVGSpatialNode* parent = &index->nodes[index->nodes[nodeId].parent];
+    for (int i = 0; i < parent->count; i++) {
+        if (parent->children[i] == nodeId) {
+            parent->bounds[i] = nodeBounds(&index->nodes[nodeId]);
+            break;
+        }
+    }
+
+    return addChild(index, index->nodes[nodeId].parent, sibling, nodeBounds(&index->nodes[sibling]));
+}
+
+static bool insertEntry(SVGSpatialIndex* index, int entry) {
+    SVGBounds bounds = index->entries[entry].bounds;
+
+    if (!isIndexable(bounds)) {
+        return true;
+    }
+    return addChild(index, chooseLeaf(index, bounds), entry, bounds);
+}
+
+/*Takes an entry out of its leaf.  Leaves may become empty - they are kept until the next load*/
+static void removeEntry(SVGSpatialIndex* index, int entry) {
+    int leaf = index->entries[entry].leaf;
+
+    if (leaf < 0) {
+        return ;
+    }
+
+    SVGSpatialNode* node = &index->nodes[leaf];
+    for (int i = 0; i < node->count; i++) {
+        if (node->children[i] == entry) {
+            node->count--;
+            node->children[i] = node->children[node->count];
+            node->bounds[i] = node->bounds[node->count];
+            break;
+        }
+    }
+
+    index->entries[entry].leaf = -1;
+    refitUpward(index, leaf);
+}
+
+/* ******************************* Cache ******************************* */
+
+/**
+ * @brief Returns the spatial index of the struct, loading it again if it is out of date
+ * @param img
+ * @return SVGSpatialIndex* or NULL if the index is not enabled or memory ran out
+ */
+static SVGSpatialIndex* getSpatialIndex(const SVG* img) {
+    if (!isLibrarySVG(img) || img->views == NULL || !img->views->useSpatialIndex) {
+        return NULL;
+    }
+
+    /*Brings the views up to date*/
+    if (getRectView(img) == NULL) {
+        return NULL;
+    }
+
+    SVGViews* views = img->views;
+    if (!views->hasSpatialIndex || views->spatialGeneration != img->generation) {
+        views->hasSpatialIndex = loadSpatialIndex(&views->spatial, views);
+        if (!views->hasSpatialIndex) {
+            return NULL;
+        }
+        views->spatialGeneration = img->generation;
+        views->spatialOrderGeneration = img->generation;
+    }
+
+    /*Added elements may have moved the others in the views*/
+    if (views->spatialOrderGeneration != img->generation) {
+        const SVGView* shapes[] = {&views->rects, &views->circles, &views->paths};
+
+        for (int type = 0; type < 3; type++) {
+            for (int i = 0; i < shapes[type]->length; i++) {
+                int entry = findEntry(&views->spatial, shapes[type]->elements[i]);
+
+                if (entry >= 0) {
+                    views->spatial.entries[entry].position = i;
+                }
+            }
+        }
+        views->spatialOrderGeneration = img->generation;
+    }
+
+    return &views->spatial;
+}
+
+/**
+ * @brief Turns the spatial index of the struct on or off
+ * @param img
+ * @param enabled
+ */
+void enableSpatialIndex(const SVG* img, bool enabled) {
+    /*Structs built by hand have no cache to keep the index in*/
+    if (!isLibrarySVG(img) || getRectView(img) == NULL) {
+        return ;
+    }
+
+    SVGViews* views = img->views;
+    views->useSpatialIndex = enabled;
+
+    if (enabled) {
+        getSpatialIndex(img);
+    } else {
+        freeSpatialIndex(&views->spatial);
+        views->hasSpatialIndex = false;
+    }
+}
+
+/**
+ * @brief Updates the spatial index after the given element was added or had an attribute set
+ * @param img
+ * @param handle
+ */
+void updateSpatialIndex(SVG* img, SVGElementHandle handle) {
+    if (!isLibrarySVG(img) || img->views == NULL) {
+        return ;
+    }
+
+    /*Only a single change since the index was last up to date can be applied in place*/
+    SVGViews* views = img->views;
+    if (!views->useSpatialIndex || !views->hasSpatialIndex || views->spatialGeneration + 1 != img->generation) {
+        return ;
+    }
+
+    SVGSpatialIndex* index = &views->spatial;
+    bool positionsKept = true;
+    bool updated = true;
+
+    if (handle.element != NULL && (handle.type == RECT || handle.type == CIRC || handle.type == PATH)) {
+        int entry = findEntry(index, handle.element);
+
+        if (entry < 0) {
+            /*A new element, whose position is set on the next query*/
+            entry = addEntry(index, handle);
+            updated = (entry >= 0) && insertEntry(index, entry);
+            positionsKept = false;
+        } else {
+            removeEntry(index, entry);
+            index->entries[entry].bounds = elementBounds(handle);
+            updated = insertEntry(index, entry);
+        }
+    }
+
+    if (!updated) {
+        views->hasSpatialIndex = false;
+        return ;
+    }
+
+    if (positionsKept && views->spatialOrderGeneration == views->spatialGeneration) {
+        views->spatialOrderGeneration = img->generation;
+    }
+    views->spatialGeneration = img->generation;
+}
+
+/**
+ * @brief Frees the memory of a spatial index
+ * @param index
+ */
+void freeSpatialIndex(SVGSpatialIndex* index) {
+    if (index == NULL) {
+        return ;
+    }
+
+    free(index->nodes);
+    free(index->entries);
+    free(index->slots);
+    memset(index, 0, sizeof(SVGSpatialIndex));
+}
+
+/* ******************************* Queries ******************************* */
+
+static void deleteHandle(void* data) {
+    free(data);
+}
+
+static char* handleToString(void* data) {
+    SVGElementHandle* handle = (SVGElementHandle*)data;
+
+    if (handle->type == RECT) {
+        return rectangleToString(handle->element);
+    } else if (handle->type == CIRC) {
+        return circleToString(handle->element);
+    }
+    return pathToString(handle->element);
+}
+
+static int compareHandles(const void* first, const void* second) {
+    const SVGElementHandle* a = (const SVGElementHandle*)first;
+    const SVGElementHandle* b = (const SVGElementHandle*)second;
+
+    if (a->type != b->type) {
+        return typeRank(a->type) - typeRank(b->type);
+    }
+    return (a->element == b->element) ? 0 : ((a->element < b->element) ? -1 : 1);
+}
+
+static void addHandle(List* list, elementType type, void* element) {
+    SVGElementHandle* handle = malloc(sizeof(SVGElementHandle));
+
+    if (handle != NULL) {
+        handle->type = type;
+        handle->element = element;
+        insertBack(list, handle);
+    }
+}
+
+/*Rectangles are their bounds, circles are tested exactly, paths only by their bounds*/
+static bool containsPoint(SVGElementHandle handle, SVGBounds bounds, float x, float y) {
+    if (!intersects(bounds, (SVGBounds){x, y, x, y, false})) {
+        return false;
+    }
+
+    if (handle.type == CIRC) {
+        const Circle* circle = (const Circle*)handle.element;
+        double dx = (double)x - circle->cx;
+        double dy = (double)y - circle->cy;
+
+        return dx * dx + dy * dy <= (double)circle->r * circle->r;
+    }
+    return true;
+}
+
+static void pushMatch(EntryMatches* matches, const SVGSpatialEntry* entry) {
+    if (matches->length == matches->capacity) {
+        int capacity = (matches->capacity == 0) ? 64 : matches->capacity * 2;
+        const SVGSpatialEntry** entries = realloc(matches->entries, sizeof(SVGSpatialEntry*) * capacity);
+
+        if (entries == NULL) {
+            return ;
+        }
+        matches->entries = entries;
+        matches->capacity = capacity;
+    }
+    matches->entries[matches->length++] = entry;
+}
+
+static void searchNode(const SVGSpatialIndex* index, int nodeId, SVGBounds area, EntryMatches* matches) {
+    const SVGSpatialNode* node = &index->nodes[nodeId];
+
+    for (int i = 0; i < node->count; i++) {
+        if (!intersects(node->bounds[i], area)) {
+            continue;
+        }
+
+        if (node->leaf) {
+            pushMatch(matches, &index->entries[node->children[i]]);
+        } else {
+            searchNode(index, node->children[i], area, matches);
+        }
+    }
+}
+
+static int compareMatches(const void* first, const void* second) {
+    const SVGSpatialEntry* a = *(const SVGSpatialEntry* const*)first;
+    const SVGSpatialEntry* b = *(const SVGSpatialEntry* const*)second;
+
+    if (a->handle.type != b->handle.type) {
+        return typeRank(a->handle.type) - typeRank(b->handle.type);
+    }
+    return a->position - b->position;
+}
+
+/**
+ * @brief Collects the shapes whose bounds intersect area (and contain the point, if point is true)
+ * @param img
+ * @param area
+ * @param point
+ * @return List*
+ */
+static List* collectElements(const SVG* img, SVGBounds area, bool point) {
+    if (img == NULL) {
+        return NULL;
+    }
+
+    List* list = initializeList(&handleToString, &deleteHandle, &compareHandles);
+    if (!isIndexable(area)) {
+        return list;
+    }
+
+    SVGSpatialIndex* index = getSpatialIndex(img);
+    if (index != NULL) {
+        EntryMatches matches = {NULL, 0, 0};
+
+        searchNode(index, index->root, area, &matches);
+        /*The tree is in spatial order, so the matches are sorted back into document order*/
+        if (matches.length > 1) {
+            qsort(matches.entries, matches.length, sizeof(SVGSpatialEntry*), &compareMatches);
+        }
+
+        for (int i = 0; i < matches.length; i++) {
+            const SVGSpatialEntry* entry = matches.entries[i];
+
+            if (!point || containsPoint(entry->handle, entry->bounds, area.minX, area.minY)) {
+                addHandle(list, entry->handle.type, entry->handle.element);
+            }
+        }
+
+        free(matches.entries);
+        return list;
+    }
+
+    /*Without the index every shape is scanned*/
+    const SVGView* shapes[] = {getRectView(img), getCircleView(img), getPathView(img)};
+    const elementType types[] = {RECT, CIRC, PATH};
+
+    for (int type = 0; type < 3; type++) {
+        for (int i = 0; shapes[type] != NULL && i < shapes[type]->length; i++) {
+            SVGElementHandle handle = {types[type], shapes[type]->elements[i]};
+            SVGBounds bounds = elementBounds(handle);
+
+            if (!intersects(bounds, area)) {
+                continue;
+            }
+            if (!point || containsPoint(handle, bounds, area.minX, area.minY)) {
+                addHandle(list, handle.type, handle.element);
+            }
+        }
+    }
+
+    return list;
+}
+
+/**
+ * @brief Returns every shape whose bounds intersect area, in document order
+ * @param img
+ * @param area
+ * @return List*
+ */
+List* getElementsInBounds(const SVG* img, SVGBounds area) {
+    return collectElements(img, area, false);
+}
+
+/**
+ * @brief Returns every shape under the point (x, y), in document order
+ * @param img
+ * @param x
+ * @param y
+ * @return List*
+ */
+List* getElementsAtPoint(const SVG* img, float x, float y) {
+    SVGBounds area = {x, y, x, y, false};
+
+    return collectElements(img, area, true);
+}
@@ -0,0 +1,481 @@
+/**
+ * @file SVGStream.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief This file contains the streaming SVG builder.  Instead of asking libxml2
+ * for the whole document tree and then walking it, the SVG struct is built directly
+ * from xmlTextReader events, so only the current element is ever held by libxml2
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <libxml/parser.h>
+#include <libxml/xmlreader.h>
+
+#include "SVGParser.h"
+#include "SVGHelpers.h"
+#include "SVGSchema.h"
+#include "SVGArena.h"
+#include "SVGStream.h"
+#include "LinkedListAPI.h"
+
+/**
+ * @brief Swallows reader/validator messages, like the DOM based parser does
+ */
+static void ignoreReaderErrors(void* arg, const char* msg, xmlParserSeverities severity, xmlTextReaderLocatorPtr locator) {
+    (void)arg;
+    (void)msg;
+    (void)severity;
+    (void)locator;
+}
+
+/**
+ * @brief Adds the id of the element the reader is on, if it has one, to a set of ids.
+ * Without a schema there is no set, since only valid documents need unique ids
+ * @param reader
+ * @param ids - may be NULL
+ * @return false if another element already has the same id
+ */
+static bool checkElementId(xmlTextReaderPtr reader, xmlHashTablePtr ids) {
+    if (ids == NULL) {
+        return true;
+    }
+
+    xmlChar* id = xmlTextReaderGetAttribute(reader, BAD_CAST "id");
+    bool unique = (id == NULL || addUniqueId(ids, (const char*)id));
+
+    xmlFree(id);
+    return unique;
+}
+
+/**
+ * @brief Moves past the element the reader is on, like xmlTextReaderNext(), but checks
+ * the ids of the elements inside it on the way
+ * @param reader
+ * @param ids - may be NULL
+ * @param failed - set if an id was not unique
+ * @return int - same as xmlTextReaderNext()
+ */
+static int skipElement(xmlTextReaderPtr reader, xmlHashTablePtr ids, bool* failed) {
+    if (ids == NULL || xmlTextReaderIsEmptyElement(reader) == 1) {
+        return xmlTextReaderNext(reader);
+    }
+
+    int depth = xmlTextReaderDepth(reader);
+    int ret;
+
+    while ((ret = xmlTextReaderRead(reader)) == 1 && xmlTextReaderDepth(reader) > depth) {
+        if (xmlTextReaderNodeType(reader) == XML_READER_TYPE_ELEMENT && !checkElementId(reader, ids)) {
+            *failed = true;
+            return ret;
+        }
+    }
+
+    /*The reader is on the end tag of the element, which is skipped too*/
+    return (ret == 1) ? xmlTextReaderRead(reader) : ret;
+}
+
+/**
+ * @brief Calls addAttr for every attribute of the element the reader is on.
+ * Namespace declarations are not attributes in the DOM either, so they are skipped
+ * @param reader
+ * @param arena
+ * @param target
+ * @param addAttr
+ * @return false if addAttr failed for any attribute
+ */
+static bool readAttributes(xmlTextReaderPtr reader, SVGArena* arena, void* target, bool (*addAttr)(SVGArena* arena, void* target, const char* name, const char* value)) {
+    bool added = true;
+
+    while (added && xmlTextReaderMoveToNextAttribute(reader) == 1) {
+        if (xmlTextReaderIsNamespaceDecl(reader) == 1) {
+            continue;
+        }
+
+        const char* value = (const char*)xmlTextReaderConstValue(reader);
+        added = addAttr(arena, target, (const char*)xmlTextReaderConstLocalName(reader), value != NULL ? value : "");
+    }
+    xmlTextReaderMoveToElement(reader);
+
+    return added;
+}
+
+/*Adapters so the shape attribute helpers can be used with readAttributes()*/
+static bool addRectAttr(SVGArena* arena, void* target, const char* name, const char* value) {
+    return addRectAttribute(arena, (Rectangle*)target, name, value);
+}
+
+static bool addCircleAttr(SVGArena* arena, void* target, const char* name, const char* value) {
+    return addCircleAttribute(arena, (Circle*)target, name, value);
+}
+
+static bool addPathAttr(SVGArena* arena, void* target, const char* name, const char* value) {
+    return addPathAttribute(arena, (Path*)target, name, value);
+}
+
+static bool addOtherAttr(SVGArena* arena, void* target, const char* name, const char* value) {
+    Attribute* attr = createAttribute(arena, name, value);
+
+    if (attr == NULL) {
+        return false;
+    }
+    insertBack((List*)target, (void*)attr);
+    return true;
+}
+
+/**
+ * @brief Copies the content of the first child of the current element into dest, truncating
+ * it to 255 chars.  parseSVGRoot() takes the same text from the document tree, so a comment
+ * or CDATA section that comes first is used here too
+ * @param reader
+ * @param dest
+ */
+static void readText(xmlTextReaderPtr reader, char* dest) {
+    /*Only the subtree of this element is built, and the reader moves past it as usual*/
+    xmlNodePtr node = xmlTextReaderExpand(reader);
+
+    if (node != NULL && node->children != NULL && node->children->content != NULL) {
+        strncpy(dest, (char*)node->children->content, 255);
+        dest[255] = '\0';
+    }
+}
+
+/**
+ * @brief Builds an SVG struct from xmlTextReader events
+ * @param reader
+ * @param schema
+ * @param arena
+ * @return SVG*
+ */
+SVG* buildSVGFromReader(xmlTextReaderPtr reader, const SVGSchema* schema, SVGArena* arena) {
+    if (reader == NULL) {
+        freeArena(arena);
+        return NULL;
+    }
+
+    xmlTextReaderSetErrorHandler(reader, &ignoreReaderErrors, NULL);
+    if (schema != NULL && xmlTextReaderSetSchema(reader, schema->schema) != 0) {
+        freeArena(arena);
+        return NULL;
+    }
+
+    SVG* SVGObject = NULL;
+
+    /*Ids of the elements read so far, since the reader does not check that they are unique*/
+    xmlHashTablePtr ids = (schema != NULL) ? xmlHashCreate(0) : NULL;
+
+    /*Stack of the <g> elements that are currently open*/
+    int stackSize = 0;
+    int stackCapacity = 16;
+    Group** groupStack = malloc(sizeof(Group*) * stackCapacity);
+
+    bool failed = (groupStack == NULL || (schema != NULL && ids == NULL));
+    int ret = xmlTextReaderRead(reader);
+
+    while (ret == 1 && !failed) {
+        int nodeType = xmlTextReaderNodeType(reader);
+        const char* nodeName = (const char*)xmlTextReaderConstLocalName(reader);
+
+        if (nodeType == XML_READER_TYPE_END_ELEMENT) {
+            if (stackSize > 0 && strcmp(nodeName, "g") == 0) {
+                stackSize--;
+            }
+            ret = xmlTextReaderRead(reader);
+            continue;
+        }
+        if (nodeType != XML_READER_TYPE_ELEMENT) {
+            ret = xmlTextReaderRead(reader);
+            continue;
+        }
+
+        if (!checkElementId(reader, ids)) {
+            failed = true;
+            break;
+        }
+
+        /*The root element becomes the SVG Object*/
+        if (SVGObject == NULL) {
+            const char* nameSpace = (const char*)xmlTextReaderConstNamespaceUri(reader);
+            SVGObject = createSVGObject(arena);
+
+            if (SVGObject == NULL || nameSpace == NULL) {
+                failed = true;
+                break;
+            }
+            strncpy(SVGObject->namespace, nameSpace, 255);
+            SVGObject->namespace[255] = '\0';
+
+            if (!readAttributes(reader, arena, SVGObject->otherAttributes, &addOtherAttr)) {
+                failed = true;
+                break;
+            }
+            ret = xmlTextReaderRead(reader);
+            continue;
+        }
+
+        /*Elements are added to the innermost open group, or to the SVG Object itself*/
+        Group* parent = (stackSize > 0) ? groupStack[stackSize - 1] : NULL;
+        List* rects = (parent != NULL) ? parent->rectangles : SVGObject->rectangles;
+        List* circles = (parent != NULL) ? parent->circles : SVGObject->circles;
+        List* paths = (parent != NULL) ? parent->paths : SVGObject->paths;
+        List* groups = (parent != NULL) ? parent->groups : SVGObject->groups;
+
+        if (strcmp(nodeName, "g") == 0) {
+            Group* group = createGroup(arena);
+            if (group == NULL) {
+                failed = true;
+                break;
+            }
+
+            /*Objects are added before their attributes are read, so the SVG Object frees them if reading fails*/
+            insertBack(groups, (void*)group);
+            if (!readAttributes(reader, arena, group->otherAttributes, &addOtherAttr)) {
+                failed = true;
+                break;
+            }
+
+            /*Children of a non-empty group go into that group until its end tag*/
+            if (xmlTextReaderIsEmptyElement(reader) == 0) {
+                if (stackSize == stackCapacity) {
+                    Group** newStack = realloc(groupStack, sizeof(Group*) * stackCapacity * 2);
+                    if (newStack == NULL) {
+                        failed = true;
+                        break;
+                    }
+                    groupStack = newStack;
+                    stackCapacity *= 2;
+                }
+                groupStack[stackSize++] = group;
+            }
+            ret = xmlTextReaderRead(reader);
+            continue;
+        }
+
+        if (strcmp(nodeName, "rect") == 0) {
+            Rectangle* rect = createRectangle(arena);
+            if (rect == NULL) {
+                failed = true;
+                break;
+            }
+            insertBack(rects, (void*)rect);
+            if (!readAttributes(reader, arena, rect, &addRectAttr)) {
+                failed = true;
+                break;
+            }
+        } else if (strcmp(nodeName, "circle") == 0) {
+            Circle* circle = createCircle(arena);
+            if (circle == NULL) {
+                failed = true;
+                break;
+            }
+            insertBack(circles, (void*)circle);
+            if (!readAttributes(reader, arena, circle, &addCircleAttr)) {
+                failed = true;
+                break;
+            }
+        } else if (strcmp(nodeName, "path") == 0) {
+            /*Path data is stored inline, so 'd' has to be read first*/
+            xmlChar* data = xmlTextReaderGetAttribute(reader, BAD_CAST "d");
+            Path* path = createPath(arena, (char*)data);
+            xmlFree(data);
+
+            /*Path object must not be NULL. It may be empty*/
+            if (path == NULL) {
+                failed = true;
+                break;
+            }
+            insertBack(paths, (void*)path);
+            if (!readAttributes(reader, arena, path, &addPathAttr)) {
+                failed = true;
+                break;
+            }
+        } else if (parent == NULL && strcmp(nodeName, "title") == 0) {
+            readText(reader, SVGObject->title);
+        } else if (parent == NULL && strcmp(nodeName, "desc") == 0) {
+            readText(reader, SVGObject->description);
+        }
+
+        /*Anything below a shape, title or unknown element is not part of the struct*/
+        ret = skipElement(reader, ids, &failed);
+    }
+
+    free(groupStack);
+    xmlHashFree(ids, NULL);
+
+    /*Parse errors, an empty document or a schema violation all result in NULL*/
+    if (failed || ret != 0 || SVGObject == NULL || (schema != NULL && xmlTextReaderIsValid(reader) != 1)) {
+        /*Deleting an arena-backed SVG frees its arena, otherwise the arena is freed here*/
+        if (SVGObject != NULL) {
+            deleteSVG(SVGObject);
+        } else {
+            freeArena(arena);
+        }
+        return NULL;
+    }
+
+    computeSVGStats(SVGObject);
+    return SVGObject;
+}
+
+/**
+ * @brief Builds an SVG struct from a file without building the libxml2 document tree
+ * @param fileName
+ * @return SVG*
+ */
+SVG* createSVGStreaming(const char* fileName) {
+    return createValidSVGStreaming(fileName, NULL);
+}
+
+/**
+ * @brief Validates and builds an SVG struct from a file in a single streaming pass
+ * @param fileName
+ * @param schema
+ * @return SVG*
+ */
+SVG* createValidSVGStreaming(const char* fileName, const SVGSchema* schema) {
+    if (fileName == NULL || strcmp(fileName, "") == 0) {
+        return NULL;
+    }
+
+    LIBXML_TEST_VERSION
+
+    xmlTextReaderPtr reader = xmlReaderForFile(fileName, NULL, 0);
+    if (reader == NULL) {
+        return NULL;
+    }
+
+    SVG* SVGObject = buildSVGFromReader(reader, schema, NULL);
+    xmlFreeTextReader(reader);
+
+    return SVGObject;
+}
+
+/**
+ * @brief Counts the elements buildSVGFromReader() would add to the SVG struct
+ * @param reader
+ * @param schema
+ * @param counts
+ * @return true
+ * @return false
+ */
+bool countSVGFromReader(xmlTextReaderPtr reader, const SVGSchema* schema, SVGCounts* counts) {
+    if (reader == NULL || counts == NULL) {
+        return false;
+    }
+
+    xmlTextReaderSetErrorHandler(reader, &ignoreReaderErrors, NULL);
+    if (schema != NULL && xmlTextReaderSetSchema(reader, schema->schema) != 0) {
+        return false;
+    }
+
+    counts->numRect = 0;
+    counts->numCirc = 0;
+    counts->numPaths = 0;
+    counts->numGroups = 0;
+
+    /*Same id check as the builder*/
+    xmlHashTablePtr ids = (schema != NULL) ? xmlHashCreate(0) : NULL;
+
+    bool foundRoot = false;
+    bool failed = (schema != NULL && ids == NULL);
+    int ret = xmlTextReaderRead(reader);
+
+    while (ret == 1 && !failed) {
+        if (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT) {
+            ret = xmlTextReaderRead(reader);
+            continue;
+        }
+
+        if (!checkElementId(reader, ids)) {
+            failed = true;
+            break;
+        }
+
+        /*Same rule as the builder: the root element must have a namespace*/
+        if (!foundRoot) {
+            foundRoot = true;
+            failed = (xmlTextReaderConstNamespaceUri(reader) == NULL);
+            ret = xmlTextReaderRead(reader);
+            continue;
+        }
+
+        const char* nodeName = (const char*)xmlTextReaderConstLocalName(reader);
+
+        /*Groups are descended into, everything else is skipped as a whole subtree,
+        so every element seen here is a child of the root or of a group*/
+        if (strcmp(nodeName, "g") == 0) {
+            counts->numGroups++;
+            ret = xmlTextReaderRead(reader);
+            continue;
+        }
+
+        if (strcmp(nodeName, "rect") == 0) {
+            counts->numRect++;
+        } else if (strcmp(nodeName, "circle") == 0) {
+            counts->numCirc++;
+        } else if (strcmp(nodeName, "path") == 0) {
+            /*A path without data cannot be created, which fails the whole parse*/
+            if (xmlTextReaderMoveToAttribute(reader, BAD_CAST "d") != 1) {
+                failed = true;
+                break;
+            }
+            xmlTextReaderMoveToElement(reader);
+            counts->numPaths++;
+        }
+
+        ret = skipElement(reader, ids, &failed);
+    }
+
+    xmlHashFree(ids, NULL);
+    return !failed && ret == 0 && foundRoot && (schema == NULL || xmlTextReaderIsValid(reader) == 1);
+}
+
+/**
+ * @brief Validates a file and counts its elements without building an SVG struct
+ * @param fileName
+ * @param schema
+ * @param counts
+ * @return true
+ * @return false
+ */
+bool countValidSVGStreaming(const char* fileName, const SVGSchema* schema, SVGCounts* counts) {
+    if (fileName == NULL || strcmp(fileName, "") == 0 || counts == NULL) {
+        return false;
+    }
+
+    LIBXML_TEST_VERSION
+
+    xmlTextReaderPtr reader = xmlReaderForFile(fileName, NULL, 0);
+    if (reader == NULL) {
+        return false;
+    }
+
+    bool valid = countSVGFromReader(reader, schema, counts);
+    xmlFreeTextReader(reader);
+
+    return valid;
+}
+
+/**
+ * @brief Returns the counts in the same JSON format as SVGtoJSON()
+ * @param counts
+ * @return char*
+ */
+char* SVGCountsToJSON(const SVGCounts* counts) {
+    char* jsonSVG = NULL;
+
+    if (counts == NULL) {
+        jsonSVG = malloc(sizeof(char) * (strlen("{}") + 1));
+        strcpy(jsonSVG, "{}");
+        return jsonSVG;
+    }
+
+    /*Each count is at most 11 characters long*/
+    jsonSVG = malloc(sizeof(char) * (strlen("{\"numRect\":,\"numCirc\":,\"numPaths\":,\"numGroups\":}") + 4 * 11 + 1));
+    sprintf(jsonSVG, "{\"numRect\":%d,\"numCirc\":%d,\"numPaths\":%d,\"numGroups\":%d}", counts->numRect, counts->numCirc, counts->numPaths, counts->numGroups);
+
+    return jsonSVG;
+}
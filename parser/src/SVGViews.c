@@ -0,0 +1,1022 @@
+/*pthread_key_t is POSIX, not C11*/
+#define _POSIX_C_SOURCE 200809L
+
+/**
+ * @file SVGViews.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief This file contains the cached, flattened views of the components of an SVG
+ * struct.  The views are built with one walk over the groups and reused by every
+ * accessor and summary function until the struct is changed
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "SVGParser.h"
+#include "SVGViews.h"
+#include "SVGKernels.h"
+#include "SVGHelpers.h"
+#include "LinkedListAPI.h"
+
+/**
+ * @brief Appends a component to a view, growing the view if it is full
+ * @param view
+ * @param elem
+ */
+static void viewAppend(SVGView* view, void* elem) {
+    if (view->length == view->capacity) {
+        int newCapacity = (view->capacity == 0) ? 16 : view->capacity * 2;
+        void** newElements = realloc(view->elements, sizeof(void*) * newCapacity);
+
+        if (newElements == NULL) {
+            return ;
+        }
+        view->elements = newElements;
+        view->capacity = newCapacity;
+    }
+
+    view->elements[view->length++] = elem;
+}
+
+/**
+ * @brief Appends every element of a list to a view
+ * @param view
+ * @param list
+ */
+static void viewAppendList(SVGView* view, List* list) {
+    ListIterator iter = createIterator(list);
+    void* elem;
+
+    while ((elem = nextElement(&iter)) != NULL) {
+        viewAppend(view, elem);
+    }
+}
+
+/**
+ * @brief Appends the groups of a list to the group view, each one followed by its
+ * nested groups - the same order parseGroupWithinGroup() uses
+ * @param view
+ * @param groups
+ */
+static void viewAppendGroups(SVGView* view, List* groups) {
+    ListIterator iter = createIterator(groups);
+    void* elem;
+
+    while ((elem = nextElement(&iter)) != NULL) {
+        viewAppend(view, elem);
+        viewAppendGroups(view, ((Group*)elem)->groups);
+    }
+}
+
+/**
+ * @brief Rebuilds all four views of an SVG struct in place
+ * @param views
+ * @param img
+ */
+static void buildViews(SVGViews* views, const SVG* img) {
+    views->rects.length = 0;
+    views->circles.length = 0;
+    views->paths.length = 0;
+    views->groups.length = 0;
+
+    viewAppendGroups(&views->groups, img->groups);
+
+    /*Top level components first, then the components of every group in group order*/
+    viewAppendList(&views->rects, img->rectangles);
+    viewAppendList(&views->circles, img->circles);
+    viewAppendList(&views->paths, img->paths);
+
+    for (int i = 0; i < views->groups.length; i++) {
+        Group* group = (Group*)views->groups.elements[i];
+
+        viewAppendList(&views->rects, group->rectangles);
+        viewAppendList(&views->circles, group->circles);
+        viewAppendList(&views->paths, group->paths);
+    }
+}
+
+/*Views of structs built by hand are rebuilt by every call, in a buffer of the calling
+thread that is freed when the thread exits*/
+static _Thread_local SVGViews* scratchViews = NULL;
+static pthread_key_t scratchKey;
+static pthread_once_t scratchKeyOnce = PTHREAD_ONCE_INIT;
+
+static void freeScratchViews(void* views) {
+    freeSVGViews((SVGViews*)views);
+}
+
+static void createScratchKey(void) {
+    pthread_key_create(&scratchKey, &freeScratchViews);
+}
+
+/**
+ * @brief Rebuilds the views of a struct built by hand in the scratch buffer, with every
+ * index dropped, so nothing is carried over from an earlier call
+ * @param img
+ * @return SVGViews*
+ */
+static SVGViews* getScratchViews(const SVG* img) {
+    if (scratchViews == NULL) {
+        scratchViews = calloc(1, sizeof(SVGViews));
+        if (scratchViews == NULL) {
+            return NULL;
+        }
+        pthread_once(&scratchKeyOnce, &createScratchKey);
+        pthread_setspecific(scratchKey, scratchViews);
+    }
+
+    SVGViews* views = scratchViews;
+    views->hasColumns = false;
+    views->useAreaIndex = false;
+    views->hasAreaIndex = false;
+    views->hasPathIndex = false;
+    views->hasIdIndex = false;
+    views->hasBounds = false;
+    views->useSpatialIndex = false;
+
+    buildViews(views, img);
+    views->generation = 0;
+
+    return views;
+}
+
+/**
+ * @brief Returns the up to date views of an SVG struct, building them if needed
+ * @param img
+ * @return SVGViews*
+ */
+SVGViews* getSVGViews(const SVG* img) {
+    if (img == NULL) {
+        return NULL;
+    }
+
+    /*The cache fields of a struct built by hand are never read*/
+    if (!isLibrarySVG(img)) {
+        return getScratchViews(img);
+    }
+
+    /*The cache is not part of the logical contents of the struct*/
+    SVG* cacheOwner = (SVG*)img;
+
+    if (cacheOwner->views == NULL) {
+        cacheOwner->views = calloc(1, sizeof(SVGViews));
+        if (cacheOwner->views == NULL) {
+            return NULL;
+        }
+        buildViews(cacheOwner->views, img);
+        cacheOwner->views->generation = img->generation;
+    } else if (cacheOwner->views->generation != img->generation) {
+        buildViews(cacheOwner->views, img);
+        cacheOwner->views->generation = img->generation;
+    }
+
+    return cacheOwner->views;
+}
+
+const SVGView* getRectView(const SVG* img) {
+    SVGViews* views = getSVGViews(img);
+    return (views != NULL) ? &views->rects : NULL;
+}
+
+const SVGView* getCircleView(const SVG* img) {
+    SVGViews* views = getSVGViews(img);
+    return (views != NULL) ? &views->circles : NULL;
+}
+
+const SVGView* getPathView(const SVG* img) {
+    SVGViews* views = getSVGViews(img);
+    return (views != NULL) ? &views->paths : NULL;
+}
+
+const SVGView* getGroupView(const SVG* img) {
+    SVGViews* views = getSVGViews(img);
+    return (views != NULL) ? &views->groups : NULL;
+}
+
+/**
+ * @brief Grows a float column to capacity elements
+ * @param column
+ * @param capacity
+ * @return true
+ * @return false
+ */
+static bool growColumn(float** column, int capacity) {
+    float* newColumn = realloc(*column, sizeof(float) * capacity);
+
+    if (newColumn == NULL) {
+        return false;
+    }
+    *column = newColumn;
+
+    return true;
+}
+
+/**
+ * @brief Rebuilds the rect and circle columns from the views
+ * @param views
+ * @return true
+ * @return false if memory ran out
+ */
+static bool buildColumns(SVGViews* views) {
+    SVGRectColumns* rects = &views->rectColumns;
+    SVGCircleColumns* circles = &views->circleColumns;
+
+    if (views->rects.length > rects->capacity) {
+        int capacity = views->rects.length;
+        if (!growColumn(&rects->x, capacity) || !growColumn(&rects->y, capacity) || !growColumn(&rects->width, capacity) || !growColumn(&rects->height, capacity)) {
+            return false;
+        }
+        rects->capacity = capacity;
+    }
+    if (views->circles.length > circles->capacity) {
+        int capacity = views->circles.length;
+        if (!growColumn(&circles->cx, capacity) || !growColumn(&circles->cy, capacity) || !growColumn(&circles->r, capacity)) {
+            return false;
+        }
+        circles->capacity = capacity;
+    }
+
+    for (int i = 0; i < views->rects.length; i++) {
+        Rectangle* rect = (Rectangle*)views->rects.elements[i];
+
+        rects->x[i] = rect->x;
+        rects->y[i] = rect->y;
+        rects->width[i] = rect->width;
+        rects->height[i] = rect->height;
+    }
+    rects->length = views->rects.length;
+
+    for (int i = 0; i < views->circles.length; i++) {
+        Circle* circle = (Circle*)views->circles.elements[i];
+
+        circles->cx[i] = circle->cx;
+        circles->cy[i] = circle->cy;
+        circles->r[i] = circle->r;
+    }
+    circles->length = views->circles.length;
+
+    return true;
+}
+
+/**
+ * @brief Returns the up to date views of an SVG struct with their columns built
+ * @param img
+ * @return SVGViews* or NULL
+ */
+static SVGViews* getViewsWithColumns(const SVG* img) {
+    SVGViews* views = getSVGViews(img);
+
+    if (views == NULL) {
+        return NULL;
+    }
+
+    if (!views->hasColumns || views->columnsGeneration != views->generation) {
+        views->hasColumns = buildColumns(views);
+        if (!views->hasColumns) {
+            return NULL;
+        }
+        views->columnsGeneration = views->generation;
+    }
+
+    return views;
+}
+
+const SVGRectColumns* getRectColumns(const SVG* img) {
+    SVGViews* views = getViewsWithColumns(img);
+    return (views != NULL) ? &views->rectColumns : NULL;
+}
+
+const SVGCircleColumns* getCircleColumns(const SVG* img) {
+    SVGViews* views = getViewsWithColumns(img);
+    return (views != NULL) ? &views->circleColumns : NULL;
+}
+
+/*Pairs sorted while the area index is built*/
+typedef struct {
+    float area;
+    int position;
+} AreaEntry;
+
+static int compareAreaEntries(const void* first, const void* second) {
+    const AreaEntry* a = (const AreaEntry*)first;
+    const AreaEntry* b = (const AreaEntry*)second;
+
+    /*NaN areas go last, so the areas before them are fully ordered*/
+    if (isnan(a->area) || isnan(b->area)) {
+        return isnan(a->area) - isnan(b->area);
+    }
+    if (a->area != b->area) {
+        return (a->area < b->area) ? -1 : 1;
+    }
+
+    return a->position - b->position;
+}
+
+/**
+ * @brief Sorts precomputed areas into an area index
+ * @param index
+ * @param areas - area of the i-th shape of the view
+ * @param length
+ * @return true
+ * @return false if memory ran out
+ */
+static bool buildAreaIndex(SVGAreaIndex* index, const float* areas, int length) {
+    if (length > index->capacity) {
+        float* newAreas = realloc(index->areas, sizeof(float) * length);
+        if (newAreas == NULL) {
+            return false;
+        }
+        index->areas = newAreas;
+
+        int* newOrder = realloc(index->order, sizeof(int) * length);
+        if (newOrder == NULL) {
+            return false;
+        }
+        index->order = newOrder;
+        index->capacity = length;
+    }
+
+    AreaEntry* entries = malloc(sizeof(AreaEntry) * (length > 0 ? length : 1));
+    if (entries == NULL) {
+        return false;
+    }
+
+    for (int i = 0; i < length; i++) {
+        entries[i].area = areas[i];
+        entries[i].position = i;
+    }
+    qsort(entries, length, sizeof(AreaEntry), &compareAreaEntries);
+
+    for (int i = 0; i < length; i++) {
+        index->areas[i] = entries[i].area;
+        index->order[i] = entries[i].position;
+    }
+    index->length = length;
+
+    free(entries);
+    return true;
+}
+
+/**
+ * @brief Returns the up to date views with their area index, or NULL if the index is
+ * not enabled (or could not be built)
+ * @param img
+ * @return SVGViews*
+ */
+static SVGViews* getViewsWithAreaIndex(const SVG* img) {
+    if (!isLibrarySVG(img) || img->views == NULL || !img->views->useAreaIndex) {
+        return NULL;
+    }
+
+    SVGViews* views = getViewsWithColumns(img);
+    if (views == NULL) {
+        return NULL;
+    }
+
+    if (!views->hasAreaIndex || views->areaIndexGeneration != views->generation) {
+        int length = (views->rectColumns.length > views->circleColumns.length) ? views->rectColumns.length : views->circleColumns.length;
+        float* areas = malloc(sizeof(float) * (length > 0 ? length : 1));
+
+        if (areas == NULL) {
+            return NULL;
+        }
+
+        /*The areas are computed with the same kernels as the scanning queries*/
+        computeRectAreas(views->rectColumns.width, views->rectColumns.height, views->rectColumns.length, areas);
+        views->hasAreaIndex = buildAreaIndex(&views->rectAreas, areas, views->rectColumns.length);
+
+        if (views->hasAreaIndex) {
+            computeCircleAreas(views->circleColumns.r, views->circleColumns.length, areas);
+            views->hasAreaIndex = buildAreaIndex(&views->circleAreas, areas, views->circleColumns.length);
+        }
+
+        free(areas);
+        if (!views->hasAreaIndex) {
+            return NULL;
+        }
+        views->areaIndexGeneration = views->generation;
+    }
+
+    return views;
+}
+
+void enableAreaIndex(const SVG* img, bool enabled) {
+    SVGViews* views = isLibrarySVG(img) ? getSVGViews(img) : NULL;
+
+    if (views != NULL) {
+        views->useAreaIndex = enabled;
+    }
+}
+
+/*Binary searches over the sorted areas.  Each returns the first position at which the
+condition stops holding - the conditions are all false for NaN, which is sorted last*/
+
+static int firstCeilNotBelow(const SVGAreaIndex* index, double target) {
+    int low = 0;
+    int high = index->length;
+
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (ceil(index->areas[mid]) < target) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+static int firstCeilAbove(const SVGAreaIndex* index, double target) {
+    int low = 0;
+    int high = index->length;
+
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (ceil(index->areas[mid]) <= target) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+static int firstNotBelow(const SVGAreaIndex* index, float value) {
+    int low = 0;
+    int high = index->length;
+
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (index->areas[mid] < value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+static int firstAbove(const SVGAreaIndex* index, float value) {
+    int low = 0;
+    int high = index->length;
+
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (index->areas[mid] <= value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+int indexedRectsWithArea(const SVG* img, float area) {
+    SVGViews* views = getViewsWithAreaIndex(img);
+
+    if (views == NULL) {
+        return -1;
+    }
+
+    double target = ceil(area);
+    return firstCeilAbove(&views->rectAreas, target) - firstCeilNotBelow(&views->rectAreas, target);
+}
+
+int indexedCirclesWithArea(const SVG* img, float area) {
+    SVGViews* views = getViewsWithAreaIndex(img);
+
+    if (views == NULL) {
+        return -1;
+    }
+
+    double target = ceil(area);
+    return firstCeilAbove(&views->circleAreas, target) - firstCeilNotBelow(&views->circleAreas, target);
+}
+
+int numRectsWithAreaBetween(const SVG* img, float minArea, float maxArea) {
+    if (img == NULL || !(minArea <= maxArea)) {
+        return 0;
+    }
+
+    SVGViews* views = getViewsWithAreaIndex(img);
+    if (views != NULL) {
+        return firstAbove(&views->rectAreas, maxArea) - firstNotBelow(&views->rectAreas, minArea);
+    }
+
+    const SVGRectColumns* rects = getRectColumns(img);
+    if (rects == NULL) {
+        return 0;
+    }
+
+    /*The kernels exclude the lower bound, so it is moved down to the next smaller float*/
+    return countRectAreasInRange(rects->width, rects->height, rects->length, nextafterf(minArea, -INFINITY), maxArea);
+}
+
+int numCirclesWithAreaBetween(const SVG* img, float minArea, float maxArea) {
+    if (img == NULL || !(minArea <= maxArea)) {
+        return 0;
+    }
+
+    SVGViews* views = getViewsWithAreaIndex(img);
+    if (views != NULL) {
+        return firstAbove(&views->circleAreas, maxArea) - firstNotBelow(&views->circleAreas, minArea);
+    }
+
+    const SVGCircleColumns* circles = getCircleColumns(img);
+    if (circles == NULL) {
+        return 0;
+    }
+
+    return countCircleAreasInRange(circles->r, circles->length, nextafterf(minArea, -INFINITY), maxArea);
+}
+
+static int comparePositions(const void* first, const void* second) {
+    return *(const int*)first - *(const int*)second;
+}
+
+/**
+ * @brief Copies the shapes of a view whose area is in [minArea, maxArea] into list, in
+ * document order
+ * @param list
+ * @param view
+ * @param index - area index of the view, or NULL to compute the areas here
+ * @param areas - areas of the view, used when index is NULL
+ * @param minArea
+ * @param maxArea
+ * @return List*
+ */
+static List* collectAreaRange(List* list, const SVGView* view, const SVGAreaIndex* index, const float* areas, float minArea, float maxArea) {
+    if (!(minArea <= maxArea)) {
+        return list;
+    }
+
+    if (index == NULL) {
+        for (int i = 0; i < view->length; i++) {
+            if (areas[i] >= minArea && areas[i] <= maxArea) {
+                insertBack(list, view->elements[i]);
+            }
+        }
+        return list;
+    }
+
+    int first = firstNotBelow(index, minArea);
+    int count = firstAbove(index, maxArea) - first;
+    if (count <= 0) {
+        return list;
+    }
+
+    /*The index is in area order, so the matching positions are sorted back into document order*/
+    int* positions = malloc(sizeof(int) * count);
+    if (positions == NULL) {
+        return list;
+    }
+    memcpy(positions, &index->order[first], sizeof(int) * count);
+    qsort(positions, count, sizeof(int), &comparePositions);
+
+    for (int i = 0; i < count; i++) {
+        insertBack(list, view->elements[positions[i]]);
+    }
+
+    free(positions);
+    return list;
+}
+
+List* getRectsWithAreaBetween(const SVG* img, float minArea, float maxArea) {
+    if (img == NULL) {
+        return NULL;
+    }
+
+    List* list = initializeList(&rectangleToString, &deleteRectangle, &compareRectangles);
+    SVGViews* views = getViewsWithAreaIndex(img);
+    if (views != NULL) {
+        return collectAreaRange(list, &views->rects, &views->rectAreas, NULL, minArea, maxArea);
+    }
+
+    views = getViewsWithColumns(img);
+    if (views == NULL) {
+        return list;
+    }
+
+    float* areas = malloc(sizeof(float) * (views->rectColumns.length > 0 ? views->rectColumns.length : 1));
+    if (areas == NULL) {
+        return list;
+    }
+    computeRectAreas(views->rectColumns.width, views->rectColumns.height, views->rectColumns.length, areas);
+    collectAreaRange(list, &views->rects, NULL, areas, minArea, maxArea);
+
+    free(areas);
+    return list;
+}
+
+List* getCirclesWithAreaBetween(const SVG* img, float minArea, float maxArea) {
+    if (img == NULL) {
+        return NULL;
+    }
+
+    List* list = initializeList(&circleToString, &deleteCircle, &compareCircles);
+    SVGViews* views = getViewsWithAreaIndex(img);
+    if (views != NULL) {
+        return collectAreaRange(list, &views->circles, &views->circleAreas, NULL, minArea, maxArea);
+    }
+
+    views = getViewsWithColumns(img);
+    if (views == NULL) {
+        return list;
+    }
+
+    float* areas = malloc(sizeof(float) * (views->circleColumns.length > 0 ? views->circleColumns.length : 1));
+    if (areas == NULL) {
+        return list;
+    }
+    computeCircleAreas(views->circleColumns.r, views->circleColumns.length, areas);
+    collectAreaRange(list, &views->circles, NULL, areas, minArea, maxArea);
+
+    free(areas);
+    return list;
+}
+
+/**
+ * @brief 64-bit FNV-1a hash of a string, also returning its length
+ * @param str
+ * @param length
+ * @return unsigned long long
+ */
+static unsigned long long hashString(const char* str, size_t* length) {
+    unsigned long long hash = 14695981039346656037ULL;
+    const unsigned char* cur = (const unsigned char*)str;
+
+    while (*cur != '\0') {
+        hash ^= *cur++;
+        hash *= 1099511628211ULL;
+    }
+    *length = (size_t)(cur - (const unsigned char*)str);
+
+    return hash;
+}
+
+/**
+ * @brief Finds the bucket of a data string - either the one holding it, or the empty
+ * bucket where it would be inserted
+ * @param index
+ * @param paths
+ * @param data
+ * @param hash
+ * @param length
+ * @return SVGPathBucket*
+ */
+static SVGPathBucket* findPathBucket(const SVGPathIndex* index, const SVGView* paths, const char* data, unsigned long long hash, size_t length) {
+    int mask = index->capacity - 1;
+    int slot = (int)(hash & (unsigned long long)mask);
+
+    while (index->buckets[slot].first != -1) {
+        SVGPathBucket* bucket = &index->buckets[slot];
+
+        if (bucket->hash == hash && bucket->length == length && memcmp(((Path*)paths->elements[bucket->first])->data, data, length) == 0) {
+            return bucket;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return &index->buckets[slot];
+}
+
+/**
+ * @brief Hashes the data of every path into the path data index
+ * @param index
+ * @param paths
+ * @return true
+ * @return false if memory ran out
+ */
+static bool buildPathIndex(SVGPathIndex* index, const SVGView* paths) {
+    int capacity = 16;
+    while (capacity < paths->length * 2) {
+        capacity *= 2;
+    }
+
+    if (capacity != index->capacity) {
+        SVGPathBucket* newBuckets = realloc(index->buckets, sizeof(SVGPathBucket) * capacity);
+        if (newBuckets == NULL) {
+            return false;
+        }
+        index->buckets = newBuckets;
+        index->capacity = capacity;
+    }
+    if (paths->length > index->nextCapacity) {
+        int* newNext = realloc(index->next, sizeof(int) * paths->length);
+        if (newNext == NULL) {
+            return false;
+        }
+        index->next = newNext;
+        index->nextCapacity = paths->length;
+    }
+
+    for (int i = 0; i < capacity; i++) {
+        index->buckets[i].first = -1;
+    }
+    index->numDistinct = 0;
+
+    /*Paths are inserted back to front, so every chain ends up in document order*/
+    for (int i = paths->length - 1; i >= 0; i--) {
+        const char* data = ((Path*)paths->elements[i])->data;
+        size_t length;
+        unsigned long long hash = hashString(data, &length);
+        SVGPathBucket* bucket = findPathBucket(index, paths, data, hash, length);
+
+        if (bucket->first == -1) {
+            bucket->hash = hash;
+            bucket->length = length;
+            bucket->count = 0;
+            index->next[i] = -1;
+            index->numDistinct++;
+        } else {
+            index->next[i] = bucket->first;
+        }
+        bucket->first = i;
+        bucket->count++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Returns the up to date views with their path data index
+ * @param img
+ * @return SVGViews* or NULL
+ */
+static SVGViews* getViewsWithPathIndex(const SVG* img) {
+    SVGViews* views = getSVGViews(img);
+
+    if (views == NULL) {
+        return NULL;
+    }
+
+    if (!views->hasPathIndex || views->pathIndexGeneration != views->generation) {
+        views->hasPathIndex = buildPathIndex(&views->pathIndex, &views->paths);
+        if (!views->hasPathIndex) {
+            return NULL;
+        }
+        views->pathIndexGeneration = views->generation;
+    }
+
+    return views;
+}
+
+int indexedPathsWithData(const SVG* img, const char* data) {
+    if (data == NULL) {
+        return 0;
+    }
+
+    SVGViews* views = getViewsWithPathIndex(img);
+    if (views == NULL) {
+        return -1;
+    }
+
+    size_t length;
+    unsigned long long hash = hashString(data, &length);
+    SVGPathBucket* bucket = findPathBucket(&views->pathIndex, &views->paths, data, hash, length);
+
+    return (bucket->first == -1) ? 0 : bucket->count;
+}
+
+/*Paths in a duplicate group belong to the SVG struct, so deleting the group list leaves them alone*/
+static void keepPath(void* data) {
+    (void)data;
+}
+
+static void deletePathGroup(void* data) {
+    freeList((List*)data);
+}
+
+static char* pathGroupToString(void* data) {
+    return toString((List*)data);
+}
+
+static int comparePathGroups(const void* first, const void* second) {
+    return getLength((List*)first) - getLength((List*)second);
+}
+
+List* getDuplicatePathGroups(const SVG* img) {
+    if (img == NULL) {
+        return NULL;
+    }
+
+    List* groups = initializeList(&pathGroupToString, &deletePathGroup, &comparePathGroups);
+    SVGViews* views = getViewsWithPathIndex(img);
+    if (views == NULL) {
+        return groups;
+    }
+
+    /*Walking the paths in document order keeps the groups in order of their first path*/
+    const SVGPathIndex* index = &views->pathIndex;
+    for (int i = 0; i < views->paths.length; i++) {
+        const char* data = ((Path*)views->paths.elements[i])->data;
+        size_t length;
+        unsigned long long hash = hashString(data, &length);
+        SVGPathBucket* bucket = findPathBucket(index, &views->paths, data, hash, length);
+
+        if (bucket->first != i || bucket->count < 2) {
+            continue;
+        }
+
+        List* group = initializeList(&pathToString, &keepPath, &comparePaths);
+        for (int j = i; j != -1; j = index->next[j]) {
+            insertBack(group, views->paths.elements[j]);
+        }
+        insertBack(groups, (void*)group);
+    }
+
+    return groups;
+}
+
+/**
+ * @brief Returns the value of the 'id' attribute in a list of attributes
+ * @param attributes
+ * @return const char* or NULL
+ */
+static const char* findId(List* attributes) {
+    return getAttributeValue(attributes, "id");
+}
+
+/**
+ * @brief Finds the bucket of an id - either the one holding it, or the empty bucket
+ * where it would be inserted
+ * @param index
+ * @param id
+ * @param hash
+ * @return SVGIdBucket*
+ */
+static SVGIdBucket* findIdBucket(const SVGIdIndex* index, const char* id, unsigned long long hash) {
+    int mask = index->capacity - 1;
+    int slot = (int)(hash & (unsigned long long)mask);
+
+    while (index->buckets[slot].id != NULL) {
+        SVGIdBucket* bucket = &index->buckets[slot];
+
+        if (bucket->hash == hash && strcmp(bucket->id, id) == 0) {
+            return bucket;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return &index->buckets[slot];
+}
+
+/**
+ * @brief Adds an element to the id index, unless it has no id or its id is already taken
+ * @param index
+ * @param type
+ * @param element
+ * @param attributes - otherAttributes of the element
+ */
+static void addToIdIndex(SVGIdIndex* index, elementType type, void* element, List* attributes) {
+    const char* id = findId(attributes);
+    if (id == NULL) {
+        return ;
+    }
+
+    size_t length;
+    unsigned long long hash = hashString(id, &length);
+    SVGIdBucket* bucket = findIdBucket(index, id, hash);
+
+    if (bucket->id == NULL) {
+        bucket->hash = hash;
+        bucket->id = id;
+        bucket->handle.type = type;
+        bucket->handle.element = element;
+        index->numIds++;
+    }
+}
+
+/**
+ * @brief Indexes the id of the SVG and of every component
+ * @param index
+ * @param views
+ * @param img
+ * @return true
+ * @return false if memory ran out
+ */
+static bool buildIdIndex(SVGIdIndex* index, const SVGViews* views, const SVG* img) {
+    int numElements = 1 + views->rects.length + views->circles.length + views->paths.length + views->groups.length;
+    int capacity = 16;
+    while (capacity < numElements * 2) {
+        capacity *= 2;
+    }
+
+    if (capacity != index->capacity) {
+        SVGIdBucket* newBuckets = realloc(index->buckets, sizeof(SVGIdBucket) * capacity);
+        if (newBuckets == NULL) {
+            return false;
+        }
+        index->buckets = newBuckets;
+        index->capacity = capacity;
+    }
+
+    for (int i = 0; i < capacity; i++) {
+        index->buckets[i].id = NULL;
+    }
+    index->numIds = 0;
+
+    /*The first element with an id keeps it, in the order documented for getElementById()*/
+    addToIdIndex(index, SVG_IMG, (void*)img, img->otherAttributes);
+    for (int i = 0; i < views->rects.length; i++) {
+        addToIdIndex(index, RECT, views->rects.elements[i], ((Rectangle*)views->rects.elements[i])->otherAttributes);
+    }
+    for (int i = 0; i < views->circles.length; i++) {
+        addToIdIndex(index, CIRC, views->circles.elements[i], ((Circle*)views->circles.elements[i])->otherAttributes);
+    }
+    for (int i = 0; i < views->paths.length; i++) {
+        addToIdIndex(index, PATH, views->paths.elements[i], ((Path*)views->paths.elements[i])->otherAttributes);
+    }
+    for (int i = 0; i < views->groups.length; i++) {
+        addToIdIndex(index, GROUP, views->groups.elements[i], ((Group*)views->groups.elements[i])->otherAttributes);
+    }
+
+    return true;
+}
+
+SVGElementHandle getElementById(const SVG* img, const char* id) {
+    SVGElementHandle handle = {SVG_IMG, NULL};
+
+    if (img == NULL || id == NULL) {
+        return handle;
+    }
+
+    /*Only the id index has to be current here, the views are only needed to rebuild it.
+    Structs built by hand rebuild it every time*/
+    bool cached = isLibrarySVG(img);
+    SVGViews* views = cached ? img->views : NULL;
+    if (views == NULL || !views->hasIdIndex || views->idIndexGeneration != img->idGeneration) {
+        views = getSVGViews(img);
+        if (views == NULL) {
+            return handle;
+        }
+
+        views->hasIdIndex = buildIdIndex(&views->idIndex, views, img);
+        if (!views->hasIdIndex) {
+            return handle;
+        }
+        views->idIndexGeneration = cached ? img->idGeneration : 0;
+    }
+
+    size_t length;
+    unsigned long long hash = hashString(id, &length);
+    SVGIdBucket* bucket = findIdBucket(&views->idIndex, id, hash);
+
+    if (bucket->id != NULL) {
+        handle = bucket->handle;
+    }
+
+    return handle;
+}
+
+/**
+ * @brief Marks the struct as changed, so the cached views are rebuilt on their next use
+ * @param img
+ */
+void invalidateSVGViews(SVG* img) {
+    if (isLibrarySVG(img)) {
+        img->generation++;
+    }
+}
+
+/**
+ * @brief Frees the cached views
+ * @param views
+ */
+void freeSVGViews(SVGViews* views) {
+    if (views == NULL) {
+        return ;
+    }
+
+    free(views->rects.elements);
+    free(views->circles.elements);
+    free(views->paths.elements);
+    free(views->groups.elements);
+    free(views->rectColumns.x);
+    free(views->rectColumns.y);
+    free(views->rectColumns.width);
+    free(views->rectColumns.height);
+    free(views->circleColumns.cx);
+    free(views->circleColumns.cy);
+    free(views->circleColumns.r);
+    free(views->rectAreas.areas);
+    free(views->rectAreas.order);
+    free(views->circleAreas.areas);
+    free(views->circleAreas.order);
+    free(views->pathIndex.buckets);
+    free(views->pathIndex.next);
+    free(views->idIndex.buckets);
+    free(views->bounds.groups);
+    free(views->bounds.slots);
+    freeSpatialIndex(&views->spatial);
+    free(views);
+}
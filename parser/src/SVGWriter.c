@@ -0,0 +1,290 @@
+/**
+ * @file SVGWriter.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief This file contains the streaming SVG writer, which emits the XML of an SVG struct
+ * through an xmlTextWriter without building an xmlDoc first
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <libxml/xmlwriter.h>
+
+#include "SVGParser.h"
+#include "SVGWriter.h"
+#include "StringBuilder.h"
+#include "LinkedListAPI.h"
+
+/*Same indentation as xmlSaveFormatFileEnc(), so pretty output matches what writeSVG() used to save*/
+#define SVG_INDENT "  "
+
+/*Where the output buffer of the xmlTextWriter sends its text*/
+typedef struct {
+    SVGWriteSink sink;
+    void* context;
+    //Set once the sink returns false
+    bool failed;
+} SinkContext;
+
+static int sinkWrite(void* context, const char* buffer, int length) {
+    SinkContext* target = (SinkContext*)context;
+
+    if (target->failed || !target->sink(buffer, (size_t)length, target->context)) {
+        target->failed = true;
+        return -1;
+    }
+    return length;
+}
+
+/*Writes every attribute of a list that has a name*/
+static bool writeAttributes(xmlTextWriterPtr writer, List* list) {
+    void* elem;
+    ListIterator iter = createIterator(list);
+
+    while ((elem = nextElement(&iter)) != NULL) {
+        Attribute* attr = (Attribute*)elem;
+
+        if (attr->name != NULL && xmlTextWriterWriteAttribute(writer, BAD_CAST attr->name, BAD_CAST attr->value) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*Writes a coordinate or size the way rectToNode() does - the number, then the units*/
+static bool writeLength(xmlTextWriterPtr writer, const char* name, float value, const char* units) {
+    return xmlTextWriterWriteFormatAttribute(writer, BAD_CAST name, "%f%s", value, units) >= 0;
+}
+
+static bool writeRects(xmlTextWriterPtr writer, List* rectList) {
+    void* elem;
+    ListIterator iter = createIterator(rectList);
+
+    while ((elem = nextElement(&iter)) != NULL) {
+        Rectangle* rect = (Rectangle*)elem;
+
+        if (xmlTextWriterStartElement(writer, BAD_CAST "rect") < 0
+            || !writeLength(writer, "x", rect->x, rect->units)
+            || !writeLength(writer, "y", rect->y, rect->units)
+            || !writeLength(writer, "width", rect->width, rect->units)
+            || !writeLength(writer, "height", rect->height, rect->units)
+            || !writeAttributes(writer, rect->otherAttributes)
+            || xmlTextWriterEndElement(writer) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool writeCircles(xmlTextWriterPtr writer, List* circList) {
+    void* elem;
+    ListIterator iter = createIterator(circList);
+
+    while ((elem = nextElement(&iter)) != NULL) {
+        Circle* circle = (Circle*)elem;
+
+        if (xmlTextWriterStartElement(writer, BAD_CAST "circle") < 0
+            || !writeLength(writer, "cx", circle->cx, circle->units)
+            || !writeLength(writer, "cy", circle->cy, circle->units)
+            || !writeLength(writer, "r", circle->r, circle->units)
+            || !writeAttributes(writer, circle->otherAttributes)
+            || xmlTextWriterEndElement(writer) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool writePaths(xmlTextWriterPtr writer, List* pathList) {
+    void* elem;
+    ListIterator iter = createIterator(pathList);
+
+    while ((elem = nextElement(&iter)) != NULL) {
+        Path* path = (Path*)elem;
+
+        if (xmlTextWriterStartElement(writer, BAD_CAST "path") < 0
+            || xmlTextWriterWriteAttribute(writer, BAD_CAST "d", BAD_CAST path->data) < 0
+            || !writeAttributes(writer, path->otherAttributes)
+            || xmlTextWriterEndElement(writer) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*Writes the shapes and groups shared by groups and the svg element, in the order svgToXML() uses*/
+static bool writeComponents(xmlTextWriterPtr writer, List* rectangles, List* circles, List* paths, List* groups);
+
+static bool writeGroups(xmlTextWriterPtr writer, List* groupList) {
+    void* elem;
+    ListIterator iter = createIterator(groupList);
+
+    while ((elem = nextElement(&iter)) != NULL) {
+        Group* group = (Group*)elem;
+
+        if (xmlTextWriterStartElement(writer, BAD_CAST "g") < 0
+            || !writeAttributes(writer, group->otherAttributes)
+            || !writeComponents(writer, group->rectangles, group->circles, group->paths, group->groups)
+            || xmlTextWriterEndElement(writer) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool writeComponents(xmlTextWriterPtr writer, List* rectangles, List* circles, List* paths, List* groups) {
+    return writeRects(writer, rectangles) && writeCircles(writer, circles) && writePaths(writer, paths) && writeGroups(writer, groups);
+}
+
+/*Writes an element that only holds text.  The text is escaped the way xmlSaveFormatFileEnc()
+escapes text nodes, which leaves quotes alone (xmlTextWriterWriteString() would not)*/
+static bool writeTextElement(xmlTextWriterPtr writer, const char* name, const char* text) {
+    if (xmlTextWriterStartElement(writer, BAD_CAST name) < 0) {
+        return false;
+    }
+
+    const char* run = text;
+    for (const char* c = text; *c != '\0'; c++) {
+        const char* escape = NULL;
+
+        switch (*c) {
+            case '<': escape = "&lt;"; break;
+            case '>': escape = "&gt;"; break;
+            case '&': escape = "&amp;"; break;
+            case '\r': escape = "&#13;"; break;
+            default: continue;
+        }
+
+        /*Everything before the character is written as is*/
+        if ((c > run && xmlTextWriterWriteRawLen(writer, BAD_CAST run, (int)(c - run)) < 0) || xmlTextWriterWriteRaw(writer, BAD_CAST escape) < 0) {
+            return false;
+        }
+        run = c + 1;
+    }
+
+    return (*run == '\0' || xmlTextWriterWriteRaw(writer, BAD_CAST run) >= 0) && xmlTextWriterEndElement(writer) >= 0;
+}
+
+/*Writes the whole document, from the XML declaration to </svg>*/
+static bool writeDocument(xmlTextWriterPtr writer, const SVG* img, SVGWriteFormat format) {
+    if (format == SVG_WRITE_PRETTY && (xmlTextWriterSetIndent(writer, 1) < 0 || xmlTextWriterSetIndentString(writer, BAD_CAST SVG_INDENT) < 0)) {
+        return false;
+    }
+
+    if (xmlTextWriterStartDocument(writer, NULL, "UTF-8", NULL) < 0
+        || xmlTextWriterStartElement(writer, BAD_CAST "svg") < 0
+        || xmlTextWriterWriteAttribute(writer, BAD_CAST "xmlns", BAD_CAST img->namespace) < 0
+        || !writeAttributes(writer, img->otherAttributes)) {
+        return false;
+    }
+
+    /*Title and description are only written when they are set*/
+    if (strcmp(img->title, "") != 0 && !writeTextElement(writer, "title", img->title)) {
+        return false;
+    }
+    if (strcmp(img->description, "") != 0 && !writeTextElement(writer, "desc", img->description)) {
+        return false;
+    }
+
+    return writeComponents(writer, img->rectangles, img->circles, img->paths, img->groups)
+        && xmlTextWriterEndElement(writer) >= 0
+        && xmlTextWriterEndDocument(writer) >= 0;
+}
+
+/**
+ * @brief Streams the SVG XML of an SVG struct to a sink in a single traversal
+ * @param img
+ * @param format
+ * @param sink
+ * @param context
+ * @return true
+ * @return false
+ */
+bool writeSVGToSink(const SVG* img, SVGWriteFormat format, SVGWriteSink sink, void* context) {
+    if (img == NULL || sink == NULL || strcmp(img->namespace, "") == 0) {
+        return false;
+    }
+
+    LIBXML_TEST_VERSION
+
+    /*The output buffer collects the text into chunks before handing them to the sink*/
+    SinkContext target = {sink, context, false};
+    xmlOutputBufferPtr out = xmlOutputBufferCreateIO(&sinkWrite, NULL, &target, NULL);
+    if (out == NULL) {
+        return false;
+    }
+
+    /*From here on the writer owns the output buffer, and closes it when it is freed*/
+    xmlTextWriterPtr writer = xmlNewTextWriter(out);
+    if (writer == NULL) {
+        xmlOutputBufferClose(out);
+        return false;
+    }
+
+    bool written = writeDocument(writer, img, format);
+    xmlFreeTextWriter(writer);
+
+    return written && !target.failed;
+}
+
+/**
+ * @brief Writes the SVG XML of an SVG struct to a file, replacing it if it exists
+ * @param img
+ * @param fileName
+ * @param format
+ * @return true
+ * @return false
+ */
+bool writeSVGToFile(const SVG* img, const char* fileName, SVGWriteFormat format) {
+    if (img == NULL || fileName == NULL || strcmp(fileName, "") == 0) {
+        return false;
+    }
+
+    FILE* file = fopen(fileName, "wb");
+    if (file == NULL) {
+        return false;
+    }
+
+    bool written = writeSVGToSink(img, format, &fileSink, file);
+    if (fclose(file) != 0) {
+        written = false;
+    }
+
+    return written;
+}
+
+/**
+ * @brief Writes the SVG XML of an SVG struct to a file descriptor
+ * @param img
+ * @param fd
+ * @param format
+ * @return true
+ * @return false
+ */
+bool writeSVGToFd(const SVG* img, int fd, SVGWriteFormat format) {
+    if (fd < 0) {
+        return false;
+    }
+
+    return writeSVGToSink(img, format, &fdSink, &fd);
+}
+
+/**
+ * @brief Returns the SVG XML of an SVG struct as one string
+ * @param img
+ * @param format
+ * @return char*
+ */
+char* SVGtoXMLString(const SVG* img, SVGWriteFormat format) {
+    StringBuilder xml = createStringBuilder(0);
+
+    if (!writeSVGToSink(img, format, &builderSink, &xml)) {
+        discardString(&xml);
+        return NULL;
+    }
+
+    return finishString(&xml);
+}
@@ -0,0 +1,238 @@
+/*write() is POSIX, not C11*/
+#define _POSIX_C_SOURCE 200809L
+
+/**
+ * @file StringBuilder.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief This file contains the growable string used by the list, toString and JSON
+ * functions.  It is linked into both the parser and the list library
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "StringBuilder.h"
+
+/*Smallest buffer allocated, so short strings are not grown several times*/
+#define BUILDER_MIN_CAPACITY 64
+
+/**
+ * @brief Makes room for extra more characters (and the NUL), at least doubling the buffer
+ * @param builder
+ * @param extra
+ * @return true
+ * @return false if memory ran out
+ */
+static bool reserve(StringBuilder* builder, size_t extra) {
+    if (builder->failed) {
+        return false;
+    }
+
+    size_t needed = builder->length + extra + 1;
+    if (needed <= builder->capacity) {
+        return true;
+    }
+
+    size_t capacity = (builder->capacity < BUILDER_MIN_CAPACITY) ? BUILDER_MIN_CAPACITY : builder->capacity;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+
+    char* data = realloc(builder->data, capacity);
+    if (data == NULL) {
+        builder->failed = true;
+        return false;
+    }
+    builder->data = data;
+    builder->capacity = capacity;
+
+    return true;
+}
+
+/**
+ * @brief Creates an empty builder
+ * @param capacity
+ * @return StringBuilder
+ */
+StringBuilder createStringBuilder(size_t capacity) {
+    StringBuilder builder = {NULL, 0, 0, false};
+
+    if (reserve(&builder, capacity)) {
+        builder.data[0] = '\0';
+    }
+
+    return builder;
+}
+
+/**
+ * @brief Appends the first length characters of chars
+ * @param builder
+ * @param chars
+ * @param length
+ */
+void appendChars(StringBuilder* builder, const char* chars, size_t length) {
+    if (chars == NULL || !reserve(builder, length)) {
+        return ;
+    }
+
+    memcpy(builder->data + builder->length, chars, length);
+    builder->length += length;
+    builder->data[builder->length] = '\0';
+}
+
+/**
+ * @brief Appends a NUL-terminated string
+ * @param builder
+ * @param str
+ */
+void appendString(StringBuilder* builder, const char* str) {
+    if (str != NULL) {
+        appendChars(builder, str, strlen(str));
+    }
+}
+
+/**
+ * @brief Appends one character
+ * @param builder
+ * @param c
+ */
+void appendChar(StringBuilder* builder, char c) {
+    if (!reserve(builder, 1)) {
+        return ;
+    }
+
+    builder->data[builder->length++] = c;
+    builder->data[builder->length] = '\0';
+}
+
+/**
+ * @brief Appends printf-style formatted text
+ * @param builder
+ * @param format
+ */
+void appendFormat(StringBuilder* builder, const char* format, ...) {
+    /*Most formatted values are short, so the text is first written into the free space*/
+    if (format == NULL || !reserve(builder, BUILDER_MIN_CAPACITY)) {
+        return ;
+    }
+
+    va_list args;
+    va_start(args, format);
+    size_t room = builder->capacity - builder->length;
+    int written = vsnprintf(builder->data + builder->length, room, format, args);
+    va_end(args);
+
+    if (written < 0) {
+        builder->data[builder->length] = '\0';
+        return ;
+    }
+
+    /*It did not fit, so it is written again once there is room for all of it*/
+    if ((size_t)written >= room) {
+        if (!reserve(builder, (size_t)written)) {
+            builder->data[builder->length] = '\0';
+            return ;
+        }
+        va_start(args, format);
+        vsnprintf(builder->data + builder->length, builder->capacity - builder->length, format, args);
+        va_end(args);
+    }
+
+    builder->length += (size_t)written;
+}
+
+/**
+ * @brief Hands the built string to the caller
+ * @param builder
+ * @return char*
+ */
+char* finishString(StringBuilder* builder) {
+    if (!reserve(builder, 0)) {
+        discardString(builder);
+        return NULL;
+    }
+
+    char* str = builder->data;
+    if (builder->length == 0) {
+        str[0] = '\0';
+    }
+
+    builder->data = NULL;
+    builder->length = 0;
+    builder->capacity = 0;
+
+    return str;
+}
+
+/**
+ * @brief Frees the contents of a builder that will not be finished
+ * @param builder
+ */
+void discardString(StringBuilder* builder) {
+    free(builder->data);
+    builder->data = NULL;
+    builder->length = 0;
+    builder->capacity = 0;
+    builder->failed = false;
+}
+
+/**
+ * @brief Writes text to the FILE* given as context
+ * @param text
+ * @param length
+ * @param context
+ * @return true
+ * @return false
+ */
+bool fileSink(const char* text, size_t length, void* context) {
+    return fwrite(text, 1, length, (FILE*)context) == length;
+}
+
+/**
+ * @brief Writes text to the file descriptor context points to
+ * @param text
+ * @param length
+ * @param context
+ * @return true
+ * @return false
+ */
+bool fdSink(const char* text, size_t length, void* context) {
+    int fd = *(int*)context;
+
+    /*write() may take only part of the text, e.g. for pipes and sockets*/
+    while (length > 0) {
+        ssize_t written = write(fd, text, length);
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        text += written;
+        length -= (size_t)written;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Appends text to the StringBuilder given as context
+ * @param text
+ * @param length
+ * @param context
+ * @return true
+ * @return false
+ */
+bool builderSink(const char* text, size_t length, void* context) {
+    StringBuilder* builder = (StringBuilder*)context;
+
+    appendChars(builder, text, length);
+    return !builder->failed;
+}
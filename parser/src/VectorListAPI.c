@@ -0,0 +1,355 @@
+/**
+ * @file VectorListAPI.c
+ * @brief Array-backed implementation of the List API in LinkedListAPI.h.  Compiled in place of
+ * LinkedListAPI.c when LIST_VECTOR is defined (make LIST=vector).  Elements are kept in one
+ * contiguous, growable array, so iterating a list does not chase a pointer per element
+ */
+
+#include "LinkedListAPI.h"
+#include "assert.h"
+#include "StringBuilder.h"
+
+#ifdef LIST_VECTOR
+
+/*Number of slots a list gets the first time something is added to it*/
+#define LIST_INITIAL_CAPACITY 4
+
+/** Function to initialize the list metadata head to the appropriate function pointers. Allocates memory to the struct.
+*@return pointer to the list head
+*@param printFunction function pointer to print a single node of the list
+*@param deleteFunction function pointer to delete a single piece of data from the list
+*@param compareFunction function pointer to compare two nodes of the list in order to test for equality or order
+**/
+List * initializeList(char* (*printFunction)(void* toBePrinted),void (*deleteFunction)(void* toBeDeleted),int (*compareFunction)(const void* first,const void* second)){
+    //Asserts create a partial function...
+    assert(printFunction != NULL);
+    assert(deleteFunction != NULL);
+    assert(compareFunction != NULL);
+
+    return initializeListWithAllocator(printFunction, deleteFunction, compareFunction, NULL);
+}
+
+/** Same as initializeList(), but the List struct and its element array are taken from allocator.
+*@return pointer to the list head
+*@param printFunction function pointer to print a single node of the list
+*@param deleteFunction function pointer to delete a single piece of data from the list
+*@param compareFunction function pointer to compare two nodes of the list in order to test for equality or order
+*@param allocator allocator the list memory is taken from, or NULL for malloc
+**/
+List * initializeListWithAllocator(char* (*printFunction)(void* toBePrinted),void (*deleteFunction)(void* toBeDeleted),int (*compareFunction)(const void* first,const void* second), ListAllocator* allocator){
+    assert(printFunction != NULL);
+    assert(deleteFunction != NULL);
+    assert(compareFunction != NULL);
+
+    List * tmpList;
+    if (allocator != NULL){
+        tmpList = allocator->alloc(allocator->context, sizeof(List));
+    }else{
+        tmpList = malloc(sizeof(List));
+    }
+
+    if (tmpList == NULL){
+        return NULL;
+    }
+
+    tmpList->elements = NULL;
+    tmpList->capacity = 0;
+    tmpList->length = 0;
+
+    tmpList->deleteData = deleteFunction;
+    tmpList->compare = compareFunction;
+    tmpList->printData = printFunction;
+    tmpList->allocator = allocator;
+    tmpList->index = NULL;
+    tmpList->freeIndex = NULL;
+
+    return tmpList;
+}
+
+/** Makes room for at least one more element, doubling the array when it is full.
+* Allocator-backed lists copy into a new array and leave the old one to the allocator
+*@return true if there is room for one more element
+*@param list pointer to the List struct
+**/
+static bool growList(List* list){
+    if (list->length < list->capacity){
+        return true;
+    }
+
+    int newCapacity = (list->capacity == 0) ? LIST_INITIAL_CAPACITY : list->capacity * 2;
+    void** newElements;
+
+    if (list->allocator != NULL){
+        newElements = list->allocator->alloc(list->allocator->context, sizeof(void*) * newCapacity);
+        if (newElements != NULL && list->length > 0){
+            memcpy(newElements, list->elements, sizeof(void*) * list->length);
+        }
+    }else{
+        newElements = realloc(list->elements, sizeof(void*) * newCapacity);
+    }
+
+    if (newElements == NULL){
+        return false;
+    }
+
+    list->elements = newElements;
+    list->capacity = newCapacity;
+
+    return true;
+}
+
+/** Inserts data at a position of the list, shifting everything after it back by one
+*@param list pointer to the List struct
+*@param index position of the new element, from 0 to list->length
+*@param toBeAdded a pointer to data that is to be added to the list
+**/
+static void insertAt(List* list, int index, void* toBeAdded){
+    if (!growList(list)){
+        return;
+    }
+
+    if (index < list->length){
+        memmove(&list->elements[index + 1], &list->elements[index], sizeof(void*) * (list->length - index));
+    }
+    list->elements[index] = toBeAdded;
+    (list->length)++;
+}
+
+/** Frees the lookup index of a list, since it may no longer match the list
+*@param list pointer to the List struct
+**/
+static void dropIndex(List* list){
+    if (list->index != NULL && list->freeIndex != NULL){
+        list->freeIndex(list->index);
+    }
+    list->index = NULL;
+}
+
+/** Deletes the entire list, freeing all memory.
+* uses the supplied function pointer to release allocated memory for the data
+*@pre 'List' type must exist and be used in order to keep track of the list.
+*@param list pointer to the List struct
+**/
+void freeList(List* list){
+    if (list == NULL){
+        return;
+    }
+
+    clearList(list);
+
+    /*Memory of allocator-backed lists belongs to the allocator*/
+    if (list->allocator == NULL){
+        free(list);
+    }
+}
+
+/** Clears the list: frees the data stored in it and the element array, without deleting the List struct
+* uses the supplied function pointer to release allocated memory for the data
+*@pre 'List' type must exist and be used in order to keep track of the list.
+*@post List struct still exists, list length = 0
+*@param list pointer to the List struct
+**/
+void clearList(List* list){
+    if (list == NULL){
+        return;
+    }
+
+    dropIndex(list);
+
+    if (list->allocator == NULL){
+        for (int i = 0; i < list->length; i++){
+            list->deleteData(list->elements[i]);
+        }
+        free(list->elements);
+    }
+
+    list->elements = NULL;
+    list->capacity = 0;
+    list->length = 0;
+}
+
+/**Function for creating a node for the linked list.
+* The array-backed list does not use nodes, but the function is kept so the API is the same
+*@return On success returns a node. On failure, returns NULL.
+*@param data - is a void * pointer to any data type.  Data must be allocated on the heap.
+**/
+Node* initializeNode(void* data){
+    Node* tmpNode = (Node*)malloc(sizeof(Node));
+
+    if (tmpNode == NULL){
+        return NULL;
+    }
+
+    tmpNode->data = data;
+    tmpNode->previous = NULL;
+    tmpNode->next = NULL;
+
+    return tmpNode;
+}
+
+/**Inserts data at the back of the list. Amortized O(1)
+*@param list pointer to the List struct
+*@param toBeAdded a pointer to data that is to be added to the list
+**/
+void insertBack(List* list, void* toBeAdded){
+    if (list == NULL || toBeAdded == NULL){
+        return;
+    }
+
+    insertAt(list, list->length, toBeAdded);
+}
+
+/**Inserts data at the front of the list. O(length)
+*@param list pointer to the List struct
+*@param toBeAdded a pointer to data that is to be added to the list
+**/
+void insertFront(List* list, void* toBeAdded){
+    if (list == NULL || toBeAdded == NULL){
+        return;
+    }
+
+    dropIndex(list);
+
+    insertAt(list, 0, toBeAdded);
+}
+
+/**Returns a pointer to the data at the front of the list. Does not alter list structure.
+ *@param list the List struct
+ *@return pointer to the data located at the front of the list
+ **/
+void* getFromFront(List * list){
+    if (list->length == 0){
+        return NULL;
+    }
+
+    return list->elements[0];
+}
+
+/**Returns a pointer to the data at the back of the list. Does not alter list structure.
+ *@param list the List struct
+ *@return pointer to the data located at the back of the list
+ **/
+void* getFromBack(List * list){
+    if (list->length == 0){
+        return NULL;
+    }
+
+    return list->elements[list->length - 1];
+}
+
+void* deleteDataFromList(List* list, void* toBeDeleted){
+    if (list == NULL || toBeDeleted == NULL){
+        return NULL;
+    }
+
+    for (int i = 0; i < list->length; i++){
+        if (list->compare(toBeDeleted, list->elements[i]) == 0){
+            void* data = list->elements[i];
+
+            dropIndex(list);
+
+            //Close the gap
+            memmove(&list->elements[i], &list->elements[i + 1], sizeof(void*) * (list->length - i - 1));
+            (list->length)--;
+
+            return data;
+        }
+    }
+
+    return NULL;
+}
+
+/** Uses the comparison function pointer to place the element in the
+* appropriate position in the list - before the first element it does not compare greater than.
+*@param list a pointer to the List struct
+*@param toBeAdded a pointer to data that is to be added to the list
+**/
+void insertSorted(List *list, void *toBeAdded){
+    if (list == NULL || toBeAdded == NULL){
+        return;
+    }
+
+    dropIndex(list);
+
+    int index = 0;
+    while (index < list->length && list->compare(toBeAdded, list->elements[index]) > 0){
+        index++;
+    }
+
+    insertAt(list, index, toBeAdded);
+}
+
+/**Returns a string that contains a string representation of the list traversed from front to back.
+returned string must be freed by the calling function.
+ *@param list Pointer to the List struct.
+ *@return on success: char * to string representation of list (must be freed after use).  on failure: NULL
+ **/
+char* toString(List * list){
+    ListIterator iter = createIterator(list);
+    StringBuilder str = createStringBuilder(0);
+
+    void* elem;
+    while((elem = nextElement(&iter)) != NULL){
+        char* currDescr = list->printData(elem);
+        appendChar(&str, '\n');
+        appendString(&str, currDescr);
+
+        free(currDescr);
+    }
+
+    return finishString(&str);
+}
+
+ListIterator createIterator(List* list){
+    ListIterator iter;
+
+    iter.list = list;
+    iter.index = 0;
+
+    return iter;
+}
+
+void* nextElement(ListIterator* iter){
+    if (iter->list != NULL && iter->index < iter->list->length){
+        return iter->list->elements[(iter->index)++];
+    }else{
+        return NULL;
+    }
+}
+
+int getLength(List* list){
+    return list->length;
+}
+
+void* getElementAt(List* list, int index){
+    if (list == NULL || index < 0 || index >= list->length){
+        return NULL;
+    }
+
+    return list->elements[index];
+}
+
+ListPoolStats getListPoolStats(void){
+    /*Elements are stored in the array directly, so there is no node pool*/
+    ListPoolStats stats = {0, 0, 0};
+    return stats;
+}
+
+bool releaseListPool(void){
+    /*No pool, so there is nothing to free*/
+    return true;
+}
+
+void* findElement(List * list, bool (*customCompare)(const void* first,const void* second), const void* searchRecord){
+    if (customCompare == NULL)
+        return NULL;
+
+    for (int i = 0; i < list->length; i++){
+        if (customCompare(list->elements[i], searchRecord))
+            return list->elements[i];
+    }
+
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,191 @@
+/**
+ * @file benchJSON.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief Benchmark for the JSON and toString functions.  Builds a document with the given
+ * number of shapes (100000 by default) in groups of 50, then times turning its rectangles,
+ * circles and paths into JSON arrays and toString() text, both the old way (realloc, strlen
+ * and strcat for every element) and with the StringBuilder the library now uses.  It also
+ * times writing the whole document as JSON against reading it back with JSONtoSVG()
+ * Usage: make benchJSON, then LD_LIBRARY_PATH=bin bin/benchJSON [numShapes]
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+/*clock_gettime() is POSIX, not C11*/
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "SVGParser.h"
+#include "SVGJSON.h"
+#include "StringBuilder.h"
+
+#define SHAPES_PER_GROUP 50
+
+static double secondsSince(struct timespec start) {
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/*The document: every third shape is a rectangle, a circle or a path*/
+static char* buildDocument(int numShapes) {
+    StringBuilder doc = createStringBuilder(0);
+
+    appendString(&doc, "<svg xmlns=\"http://www.w3.org/2000/svg\"><title>bench</title>\n");
+    for (int i = 0; i < numShapes; i++) {
+        if (i % SHAPES_PER_GROUP == 0) {
+            appendFormat(&doc, "%s<g fill=\"#%06x\">\n", (i > 0) ? "</g>\n" : "", i);
+        }
+        if (i % 3 == 0) {
+            appendFormat(&doc, "<rect x=\"%d\" y=\"%d\" width=\"%d.5\" height=\"10\" stroke=\"black\"/>\n", i % 1000, i / 1000, i % 37);
+        } else if (i % 3 == 1) {
+            appendFormat(&doc, "<circle cx=\"%d\" cy=\"%d\" r=\"%dcm\" opacity=\"0.5\"/>\n", i % 1000, i / 1000, i % 11 + 1);
+        } else {
+            appendFormat(&doc, "<path d=\"M%d %d l 10 20 c 1 2 3 4 5 6 z\" stroke-width=\"2\"/>\n", i % 1000, i / 1000);
+        }
+    }
+    appendString(&doc, (numShapes > 0) ? "</g></svg>\n" : "</svg>\n");
+
+    return finishString(&doc);
+}
+
+/*What the list JSON functions used to do*/
+static char* oldListToJSON(List* list, char* (*elemToJSON)(void*)) {
+    if (getLength(list) <= 0) {
+        char* json = malloc(3);
+        strcpy(json, "[]");
+        return json;
+    }
+
+    char* json = malloc(2);
+    strcpy(json, "[");
+
+    void* elem;
+    ListIterator iter = createIterator(list);
+    while ((elem = nextElement(&iter)) != NULL) {
+        char* elemString = elemToJSON(elem);
+        json = realloc(json, strlen(json) + strlen(elemString) + 2);
+        strcat(json, elemString);
+        strcat(json, ",");
+        free(elemString);
+    }
+    json[strlen(json) - 1] = ']';
+
+    return json;
+}
+
+/*What toString() used to do*/
+static char* oldToString(List* list) {
+    char* str = malloc(1);
+    strcpy(str, "");
+
+    void* elem;
+    ListIterator iter = createIterator(list);
+    while ((elem = nextElement(&iter)) != NULL) {
+        char* currDescr = list->printData(elem);
+        str = realloc(str, strlen(str) + 50 + strlen(currDescr));
+        strcat(str, "\n");
+        strcat(str, currDescr);
+        free(currDescr);
+    }
+
+    return str;
+}
+
+static char* rectJSON(void* data) {
+    return rectToJSON((Rectangle*)data);
+}
+
+static char* circleJSON(void* data) {
+    return circleToJSON((Circle*)data);
+}
+
+static char* pathJSON(void* data) {
+    return pathToJSON((Path*)data);
+}
+
+/*The lists returned by getRects() etc. do not own their elements*/
+static void keepData(void* data) {
+}
+
+int main(int argc, char** argv) {
+    int numShapes = (argc > 1) ? atoi(argv[1]) : 100000;
+    char* doc = buildDocument(numShapes);
+    SVG* img = createSVGFromBuffer(doc, strlen(doc));
+
+    free(doc);
+    if (img == NULL) {
+        printf("could not parse the generated document\n");
+        return 1;
+    }
+
+    List* lists[] = {getRects(img), getCircles(img), getPaths(img)};
+    char* (*elemToJSON[])(void*) = {&rectJSON, &circleJSON, &pathJSON};
+    char* (*listJSON[])(const List*) = {&rectListToJSON, &circListToJSON, &pathListToJSON};
+    double oldJSON = 0, newJSON = 0, oldText = 0, newText = 0;
+    size_t bytes = 0;
+    int mismatches = 0;
+    struct timespec start;
+
+    for (int i = 0; i < 3; i++) {
+        lists[i]->deleteData = &keepData;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        char* oldString = oldListToJSON(lists[i], elemToJSON[i]);
+        oldJSON += secondsSince(start);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        char* newString = listJSON[i](lists[i]);
+        newJSON += secondsSince(start);
+
+        mismatches += (strcmp(oldString, newString) != 0);
+        bytes += strlen(newString);
+        free(oldString);
+        free(newString);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        oldString = oldToString(lists[i]);
+        oldText += secondsSince(start);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        newString = toString(lists[i]);
+        newText += secondsSince(start);
+
+        mismatches += (strcmp(oldString, newString) != 0);
+        bytes += strlen(newString);
+        free(oldString);
+        free(newString);
+        freeList(lists[i]);
+    }
+
+    printf("%d shapes, %zu bytes of output, %d mismatches\n", numShapes, bytes, mismatches);
+    printf("list JSON:  old %8.1f ms, StringBuilder %8.1f ms (%.1fx)\n", oldJSON * 1e3, newJSON * 1e3, oldJSON / newJSON);
+    printf("toString(): old %8.1f ms, StringBuilder %8.1f ms (%.1fx)\n", oldText * 1e3, newText * 1e3, oldText / newText);
+
+    /*Document JSON: writing it, then reading it back, which must give the same document*/
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    char* json = SVGtoDocumentJSON(img, -1);
+    double writeTime = secondsSince(start);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    SVG* copy = JSONtoSVG(json);
+    double readTime = secondsSince(start);
+
+    char* again = (copy != NULL) ? SVGtoDocumentJSON(copy, -1) : NULL;
+    double megabytes = strlen(json) / 1e6;
+
+    printf("document JSON: %.1f MB, write %8.1f ms (%.0f MB/s), read %8.1f ms (%.0f MB/s), round trip %s\n",
+           megabytes, writeTime * 1e3, megabytes / writeTime, readTime * 1e3, megabytes / readTime,
+           (again != NULL && strcmp(json, again) == 0) ? "identical" : "DIFFERENT");
+    free(json);
+    free(again);
+    deleteSVG(copy);
+
+    deleteSVG(img);
+    return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file benchLength.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief Microbenchmark for parseLength().  Collects every x/y/width/height/cx/cy/r
+ * value of the given SVG files and times reading them with atof() plus a separate
+ * units loop (what the shape parsers used to do) against parseLength()
+ * Usage: make benchLength, then LD_LIBRARY_PATH=bin bin/benchLength with the SVG files to read
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+/*clock_gettime() is POSIX, not C11*/
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <libxml/parser.h>
+#include <libxml/tree.h>
+
+#include "SVGParser.h"
+#include "SVGHelpers.h"
+
+/*Values are read over and over until roughly this many have been parsed*/
+#define BENCH_TARGET 20000000
+
+static const char *lengthNames[] = {"x", "y", "width", "height", "cx", "cy", "r"};
+
+static char **values = NULL;
+static int numValues = 0;
+static int valuesCapacity = 0;
+
+static void addValue(const char *value) {
+    if (numValues == valuesCapacity) {
+        valuesCapacity = (valuesCapacity == 0) ? 256 : valuesCapacity * 2;
+        values = realloc(values, sizeof(char *) * valuesCapacity);
+    }
+    values[numValues] = malloc(strlen(value) + 1);
+    strcpy(values[numValues], value);
+    numValues++;
+}
+
+static void collectValues(xmlNode *node) {
+    for (; node != NULL; node = node->next) {
+        if (node->type == XML_ELEMENT_NODE) {
+            for (xmlAttr *attr = node->properties; attr != NULL; attr = attr->next) {
+                for (int i = 0; i < (int)(sizeof(lengthNames) / sizeof(lengthNames[0])); i++) {
+                    if (strcmp((char *)attr->name, lengthNames[i]) == 0 && attr->children != NULL && attr->children->content != NULL) {
+                        addValue((char *)attr->children->content);
+                    }
+                }
+            }
+        }
+        collectValues(node->children);
+    }
+}
+
+/*The old way - atof(), then every letter of the value copied into a units buffer*/
+static float oldParse(const char *cont, char *units) {
+    float value = atof(cont);
+    int j = 0;
+
+    for (int i = 0; cont[i] != '\0' && j < 255; i++) {
+        if ((cont[i] >= 'A' && cont[i] <= 'Z') || (cont[i] >= 'a' && cont[i] <= 'z')) {
+            units[j] = cont[i];
+            j++;
+        }
+    }
+    units[j] = '\0';
+
+    return value;
+}
+
+static double secondsSince(struct timespec start) {
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("usage: benchLength <file.svg>...\n");
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        xmlDoc *doc = xmlReadFile(argv[i], NULL, 0);
+        if (doc != NULL) {
+            collectValues(xmlDocGetRootElement(doc));
+            xmlFreeDoc(doc);
+        }
+    }
+    xmlCleanupParser();
+
+    if (numValues == 0) {
+        printf("no length attributes found\n");
+        return 1;
+    }
+
+    int rounds = BENCH_TARGET / numValues + 1;
+    long total = (long)rounds * numValues;
+    int mismatches = 0;
+    volatile float sink = 0;
+    char units[256];
+    struct timespec start;
+
+    /*Both versions must read every value the same way*/
+    for (int i = 0; i < numValues; i++) {
+        float value;
+        parseLength(values[i], &value, NULL);
+        if (value != oldParse(values[i], units)) {
+            mismatches++;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < numValues; i++) {
+            sink += oldParse(values[i], units);
+        }
+    }
+    double oldTime = secondsSince(start);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < numValues; i++) {
+            float value;
+            const char *parsedUnits;
+            parseLength(values[i], &value, &parsedUnits);
+            sink += value;
+        }
+    }
+    double newTime = secondsSince(start);
+
+    printf("%d distinct values, %ld parses each, %d value mismatches\n", numValues, total, mismatches);
+    printf("atof + units loop: %7.2f ns/value\n", oldTime * 1e9 / total);
+    printf("parseLength:       %7.2f ns/value (%.2fx)\n", newTime * 1e9 / total, oldTime / newTime);
+
+    for (int i = 0; i < numValues; i++) {
+        free(values[i]);
+    }
+    free(values);
+
+    return 0;
+}
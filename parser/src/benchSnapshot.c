@@ -0,0 +1,91 @@
+/**
+ * @file benchSnapshot.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief Benchmark for the snapshot format.  For every given SVG file, times parsing and
+ * validating it against the schema with createValidSVG() against loading a snapshot of
+ * the same struct with loadSVGSnapshot(), and checks that both give the same document
+ * Usage: make benchSnapshot, then LD_LIBRARY_PATH=bin bin/benchSnapshot schema.xsd files...
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+/*clock_gettime() is POSIX, not C11*/
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "SVGParser.h"
+#include "SVGJSON.h"
+#include "SVGSnapshot.h"
+
+/*Each way of loading a file is repeated until it has taken at least this long*/
+#define BENCH_SECONDS 0.5
+
+/*Where the snapshots are written*/
+#define SNAPSHOT_FILE "bench.snap"
+
+static double secondsSince(struct timespec start) {
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/*Average time of one load, in seconds*/
+static double timeLoads(SVG* (*load)(const char*, const char*), const char* fileName, const char* schemaFile) {
+    struct timespec start;
+    double elapsed = 0;
+    int runs = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (elapsed < BENCH_SECONDS) {
+        deleteSVG(load(fileName, schemaFile));
+        runs++;
+        elapsed = secondsSince(start);
+    }
+
+    return elapsed / runs;
+}
+
+static SVG* loadSnapshot(const char* fileName, const char* schemaFile) {
+    return loadSVGSnapshot(fileName);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printf("usage: %s schema.xsd files...\n", argv[0]);
+        return 1;
+    }
+
+    for (int i = 2; i < argc; i++) {
+        SVG* img = createValidSVG(argv[i], argv[1]);
+
+        if (img == NULL || !writeSVGSnapshot(img, SNAPSHOT_FILE)) {
+            printf("%s: not a valid SVG file\n", argv[i]);
+            deleteSVG(img);
+            continue;
+        }
+
+        /*The snapshot must load back as the same document*/
+        SVG* copy = loadSVGSnapshot(SNAPSHOT_FILE);
+        char* original = SVGtoDocumentJSON(img, SVG_JSON_MAX_PRECISION);
+        char* loaded = (copy != NULL) ? SVGtoDocumentJSON(copy, SVG_JSON_MAX_PRECISION) : NULL;
+        bool same = (original != NULL && loaded != NULL && strcmp(original, loaded) == 0);
+
+        free(original);
+        free(loaded);
+        deleteSVG(copy);
+        deleteSVG(img);
+
+        double parseTime = timeLoads(&createValidSVG, argv[i], argv[1]);
+        double loadTime = timeLoads(&loadSnapshot, SNAPSHOT_FILE, NULL);
+        printf("%s: createValidSVG %10.1f us, loadSVGSnapshot %10.1f us (%.1fx)%s\n", argv[i],
+               parseTime * 1e6, loadTime * 1e6, parseTime / loadTime, same ? "" : ", DIFFERENT");
+    }
+
+    remove(SNAPSHOT_FILE);
+    return 0;
+}
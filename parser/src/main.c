@@ -9,7 +9,7 @@
 #include "SVGHelpers.h"
 #include "LinkedListAPI.h"
 
-//gcc -Wall -I/usr/include/libxml2/ -lm -I../include/ main.c SVGParser.c SVGHelpers.c LinkedListAPI.c -lxml2 -ggdb3//
+//gcc -Wall -I/usr/include/libxml2/ -lm -I../include/ main.c SVGParser.c SVGHelpers.c SVGSchema.c SVGStream.c SVGArena.c SVGViews.c SVGKernels.c SVGIntern.c SVGPath.c SVGBounds.c SVGSpatial.c SVGJSON.c SVGSnapshot.c SVGWriter.c LinkedListAPI.c VectorListAPI.c StringBuilder.c -lxml2 -ggdb3//
 
 int main (int argc, char **argv) {
     // if (argc != 2){
@@ -0,0 +1,437 @@
+/*opendir() is POSIX, not C11*/
+#define _POSIX_C_SOURCE 200809L
+
+/**
+ * @file regressions.c
+ * @author Abdullah Khan (mkhan94@uoguelph.ca) - 1101209
+ * @brief Regression checks for bugs found in review.  Every check rebuilds the situation
+ * that used to fail and prints PASS or FAIL.  The regressions target in the Makefile builds
+ * it with AddressSanitizer, so memory errors stop the run
+ * Usage: make regressions && bin/regressions (from parser/)
+ * @date 2022-01-20
+ * @copyright Copyright (c) 2022
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <dirent.h>
+
+#include "SVGParser.h"
+#include "SVGHelpers.h"
+#include "SVGArena.h"
+#include "LinkedListAPI.h"
+#include "SVGBounds.h"
+#include "SVGViews.h"
+#include "SVGSpatial.h"
+#include "SVGSchema.h"
+#include "SVGStream.h"
+#include "SVGIntern.h"
+#include "StringBuilder.h"
+
+/*Directory of the test files, and a test file with shapes at the top level, read relative to parser/*/
+#define TEST_DIR "bin/testFiles"
+#define TEST_FILE "bin/testFiles/rects.svg"
+#define PATH_FILE "bin/testFiles/quad01.svg"
+#define SCHEMA_FILE "bin/testFiles/svg.xsd"
+
+/*Read by AddressSanitizer at startup.  deleteSVG() does not free the attribute list of the
+svg element yet, so leak reports would bury the results*/
+const char* __asan_default_options(void);
+const char* __asan_default_options(void) {
+    return "detect_leaks=0";
+}
+
+/*addComponent() then setAttribute() on an arena SVG used to free the new attribute twice:
+once through the arena and once through the heap list of the added circle*/
+static bool addComponentThenSetAttribute(void) {
+    SVG* img = createArenaSVG(TEST_FILE);
+    if (img == NULL) {
+        return false;
+    }
+
+    Circle* circle = createCircle(NULL);
+    circle->r = 5;
+    addComponent(img, CIRC, circle);
+
+    int index = getLength(img->circles) - 1;
+    bool set = setAttribute(img, CIRC, index, createAttribute(NULL, "fill", "red"));
+    bool found = set && strcmp(getAttributeValue(circle->otherAttributes, "fill"), "red") == 0;
+
+    deleteSVG(img);
+    return found;
+}
+
+/*validateSVG() validates the struct without a document, and used to skip the check that
+xs:ID values are unique*/
+static bool validateDuplicateIds(void) {
+    SVG* img = createSVG(TEST_FILE);
+    if (img == NULL) {
+        return false;
+    }
+
+    setAttribute(img, RECT, 0, createAttribute(NULL, "id", "a"));
+    setAttribute(img, RECT, 1, createAttribute(NULL, "id", "b"));
+    bool uniqueValid = validateSVG(img, SCHEMA_FILE);
+
+    /*Ids are compared after collapsing whitespace, so " a " is the same id as "a"*/
+    setAttribute(img, RECT, 2, createAttribute(NULL, "id", " a "));
+    bool duplicateValid = validateSVG(img, SCHEMA_FILE);
+
+    deleteSVG(img);
+    return uniqueValid && !duplicateValid;
+}
+
+/*A path built by the caller has no compiled commands, but addComponent() used to keep
+whatever its commands field held, so bounds and deleteSVG() followed a garbage pointer*/
+static bool addHandBuiltPath(void) {
+    SVG* img = createSVG(TEST_FILE);
+    if (img == NULL) {
+        return false;
+    }
+
+    const char* data = "M0 0 L1000 1000";
+    Path* path = malloc(sizeof(Path) + strlen(data) + 1);
+    memset(path, 0xAB, sizeof(Path));
+    strcpy(path->data, data);
+    path->otherAttributes = initializeList(&attributeToString, &deleteAttribute, &compareAttributes);
+    addComponent(img, PATH, path);
+
+    SVGBounds bounds = getSVGBounds(img);
+    deleteSVG(img);
+    return bounds.maxX >= 1000 && bounds.maxY >= 1000;
+}
+
+/*Every recompile of a path of an arena SVG after its data changed used to take a new
+block of the arena, which was only given back when the whole SVG was deleted*/
+static bool arenaPathRecompile(void) {
+    SVG* img = createArenaSVG(PATH_FILE);
+    const SVGView* paths = getPathView(img);
+    if (paths == NULL || paths->length == 0) {
+        deleteSVG(img);
+        return false;
+    }
+
+    SVGElementHandle handle = {PATH, paths->elements[0]};
+    getSVGBounds(img);
+    int numChunks = img->arena->numChunks;
+
+    for (int i = 0; i < 10000; i++) {
+        Attribute* data = createAttribute(NULL, "d", (i % 2 == 0) ? "M0 0 L10 10" : "M0 0 L20 20");
+
+        /*The new data is copied into the path, so the attribute is still the caller's*/
+        setElementAttribute(img, handle, data);
+        deleteAttribute(data);
+        getSVGBounds(img);
+    }
+
+    bool passed = (img->arena->numChunks == numChunks) && getSVGBounds(img).maxX >= 20;
+    deleteSVG(img);
+    return passed;
+}
+
+/*Returns whether a document is valid according to the streaming counter*/
+static bool countDocument(const char* document, const SVGSchema* schema) {
+    SVGCounts counts;
+    xmlTextReaderPtr reader = xmlReaderForMemory(document, (int)strlen(document), NULL, NULL, 0);
+    bool valid = countSVGFromReader(reader, schema, &counts);
+
+    xmlFreeTextReader(reader);
+    return valid;
+}
+
+/*The streaming counter behind validImageToJSON() used to accept files with duplicate ids,
+which createValidSVG() rejects - also when the second id is inside a skipped element*/
+static bool countDuplicateIds(void) {
+    static const char* unique = "<svg xmlns=\"http://www.w3.org/2000/svg\">"
+        "<rect id=\"a\" x=\"1\" y=\"1\" width=\"1\" height=\"1\"/>"
+        "<g><circle id=\"b\" cx=\"1\" cy=\"1\" r=\"1\"/></g></svg>";
+    static const char* duplicate = "<svg xmlns=\"http://www.w3.org/2000/svg\">"
+        "<rect id=\"a\" x=\"1\" y=\"1\" width=\"1\" height=\"1\"/>"
+        "<g><circle id=\" a\" cx=\"1\" cy=\"1\" r=\"1\"/></g></svg>";
+    static const char* nested = "<svg xmlns=\"http://www.w3.org/2000/svg\">"
+        "<rect id=\"a\" x=\"1\" y=\"1\" width=\"1\" height=\"1\">"
+        "<animate id=\"a\" attributeName=\"x\" from=\"1\" to=\"2\" dur=\"1s\"/></rect></svg>";
+
+    const SVGSchema* schema = getCachedSVGSchema(SCHEMA_FILE);
+    if (schema == NULL) {
+        return false;
+    }
+
+    return countDocument(unique, schema) && !countDocument(duplicate, schema) && !countDocument(nested, schema);
+}
+
+/*Builds and frees a list of 1000 nodes, and returns how many slabs the thread allocated*/
+static void* useListPool(void* slabs) {
+    List* list = initializeList(&attributeToString, &deleteAttribute, &compareAttributes);
+
+    for (int i = 0; i < 1000; i++) {
+        insertBack(list, (void*)createAttribute(NULL, "fill", "red"));
+    }
+    freeList(list);
+
+    *(unsigned long*)slabs = getListPoolStats().slabs;
+    return NULL;
+}
+
+/*The node pool slabs of a thread used to leak when it exited.  They now go to a depot,
+so the next thread reuses them instead of allocating its own*/
+static bool listPoolThreadExit(void) {
+    unsigned long slabs[2] = {0, 0};
+
+    for (int i = 0; i < 2; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, &useListPool, &slabs[i]) != 0) {
+            return false;
+        }
+        pthread_join(thread, NULL);
+    }
+
+    /*The first thread needs slabs (unless the list is array-backed), the second must not*/
+    return slabs[1] == 0;
+}
+
+/*The lists returned by getRects() etc. do not own their elements*/
+static void keepData(void* data) {
+}
+
+/*Appends the JSON of a list returned by getRects() etc. to text, and frees the list*/
+static void appendComponents(StringBuilder* text, List* list, char* (*listToJSON)(const List*)) {
+    char* json = listToJSON(list);
+
+    appendString(text, json);
+    free(json);
+    list->deleteData = &keepData;
+    freeList(list);
+}
+
+/*Returns everything the struct holds as text, or NULL for a NULL struct*/
+static char* describeSVG(const SVG* img) {
+    if (img == NULL) {
+        return NULL;
+    }
+
+    StringBuilder text = createStringBuilder(0);
+    char* parts[] = {SVGToString(img), SVGtoJSON(img), attrListToJSON(img->otherAttributes)};
+
+    for (int i = 0; i < 3; i++) {
+        appendString(&text, parts[i]);
+        free(parts[i]);
+    }
+    appendComponents(&text, getRects(img), &rectListToJSON);
+    appendComponents(&text, getCircles(img), &circListToJSON);
+    appendComponents(&text, getPaths(img), &pathListToJSON);
+    appendComponents(&text, getGroups(img), &groupListToJSON);
+
+    return finishString(&text);
+}
+
+/*Returns whether the DOM and the streaming builder made the same struct, or both failed*/
+static bool sameStructs(SVG* fromDOM, SVG* streamed) {
+    char* domText = describeSVG(fromDOM);
+    char* streamText = describeSVG(streamed);
+    bool same = (domText == NULL) ? (streamText == NULL) : (streamText != NULL && strcmp(domText, streamText) == 0);
+
+    free(domText);
+    free(streamText);
+    deleteSVG(fromDOM);
+    deleteSVG(streamed);
+    return same;
+}
+
+/*The streaming builder used to join all the text inside <title> and <desc>, while the DOM
+builder takes the content of their first child - a comment or CDATA section, for example*/
+static bool streamingMatchesDOM(void) {
+    static const char* documents[] = {
+        "<svg xmlns=\"http://www.w3.org/2000/svg\"><title><!--note-->Title</title>"
+            "<desc><![CDATA[first]]> and <b>second</b></desc></svg>",
+        "<svg xmlns=\"http://www.w3.org/2000/svg\"><title><b>nested</b> text</title><desc/></svg>",
+        "<svg xmlns=\"http://www.w3.org/2000/svg\"><title>Title</title><title>Second</title>"
+            "<g><title>In a group</title></g></svg>",
+    };
+    bool passed = true;
+
+    for (size_t i = 0; i < sizeof(documents) / sizeof(documents[0]); i++) {
+        int length = (int)strlen(documents[i]);
+        xmlTextReaderPtr reader = xmlReaderForMemory(documents[i], length, NULL, NULL, 0);
+        SVG* streamed = buildSVGFromReader(reader, NULL, NULL);
+
+        xmlFreeTextReader(reader);
+        passed = sameStructs(createSVGFromBuffer(documents[i], length), streamed) && passed;
+    }
+
+    DIR* dir = opendir(TEST_DIR);
+    struct dirent* entry;
+    int numFiles = 0;
+
+    while (dir != NULL && (entry = readdir(dir)) != NULL) {
+        size_t length = strlen(entry->d_name);
+        if (length < 4 || strcmp(entry->d_name + length - 4, ".svg") != 0) {
+            continue;
+        }
+
+        char fileName[512];
+        snprintf(fileName, sizeof(fileName), "%s/%s", TEST_DIR, entry->d_name);
+        passed = sameStructs(createSVG(fileName), createSVGStreaming(fileName)) && passed;
+        numFiles++;
+    }
+    if (dir != NULL) {
+        closedir(dir);
+    }
+
+    return passed && numFiles > 0;
+}
+
+/*The cache fields of an SVG built by hand used to be followed as if the library had set
+them, so getSVGStats(), the views and deleteSVG() read or freed garbage pointers*/
+static bool handBuiltSVG(void) {
+    SVG* img = malloc(sizeof(SVG));
+    if (img == NULL) {
+        return false;
+    }
+    memset(img, 0xAB, sizeof(SVG));
+    strcpy(img->namespace, "http://www.w3.org/2000/svg");
+    strcpy(img->title, "");
+    strcpy(img->description, "");
+    img->rectangles = initializeList(&rectangleToString, &deleteRectangle, &compareRectangles);
+    img->circles = initializeList(&circleToString, &deleteCircle, &compareCircles);
+    img->paths = initializeList(&pathToString, &deletePath, &comparePaths);
+    img->groups = initializeList(&groupToString, &deleteGroup, &compareGroups);
+    img->otherAttributes = initializeList(&attributeToString, &deleteAttribute, &compareAttributes);
+
+    Rectangle* rect = createRectangle(NULL);
+    addRectAttribute(NULL, rect, "width", "2");
+    addRectAttribute(NULL, rect, "height", "3");
+    addRectAttribute(NULL, rect, "id", "r");
+    addComponent(img, RECT, rect);
+
+    /*A copy of a struct the library created is not trusted either*/
+    SVG* parsed = createSVG(TEST_FILE);
+    SVG* copied = malloc(sizeof(SVG));
+    bool copyIsLibrary = true;
+    if (parsed != NULL && copied != NULL) {
+        *copied = *parsed;
+        copyIsLibrary = isLibrarySVG(copied);
+    }
+    free(copied);
+    deleteSVG(parsed);
+
+    enableSpatialIndex(img, true);
+    enableAreaIndex(img, true);
+    SVGElementHandle handle = getElementById(img, "r");
+    bool passed = !isLibrarySVG(img) && !copyIsLibrary && getSVGStats(img)->numRect == 1
+        && getRectView(img)->length == 1 && handle.element == rect && numRectsWithArea(img, 6) == 1
+        && getSVGBounds(img).maxY == 3 && validateSVG(img, SCHEMA_FILE);
+
+    /*Changes are seen by the next call, since nothing is cached*/
+    Attribute* height = createAttribute(NULL, "height", "4");
+    setElementAttribute(img, handle, height);
+    deleteAttribute(height);
+    passed = passed && numRectsWithArea(img, 8) == 1 && getSVGBounds(img).maxY == 4;
+
+    freeList(img->otherAttributes);
+    deleteSVG(img);
+    return passed;
+}
+
+/*Checks that the rect parsed from unitsDocument kept its units and its extra attribute*/
+static bool keptUnits(SVG* img) {
+    if (img == NULL || getLength(img->rectangles) != 1) {
+        return false;
+    }
+
+    Rectangle* rect = getFromFront(img->rectangles);
+    Attribute* attr = getFromFront(rect->otherAttributes);
+    return strcmp(rect->units, "regressionunits") == 0 && attr != NULL
+        && strcmp(attr->name, "data-regression") == 0 && strcmp(attr->value, "kept") == 0;
+}
+
+/*Once the intern table was full, shapes with units that were not interned yet failed to
+parse, so whether a valid file parsed depended on what the process had parsed before.
+This fills the table for good, so it runs last*/
+static bool fullInternTable(void) {
+    static const char* unitsDocument = "<svg xmlns=\"http://www.w3.org/2000/svg\">"
+        "<rect x=\"1regressionunits\" y=\"1regressionunits\" width=\"1regressionunits\" "
+        "height=\"1regressionunits\" data-regression=\"kept\"/></svg>";
+    static const char* unitsJSON = "{\"x\":1,\"y\":1,\"w\":1,\"h\":1,\"units\":\"regressionunits\"}";
+    char name[64];
+
+    /*Long strings fill most of the table, then shorter ones fill the gap they leave*/
+    for (int length = (int)sizeof(name) - 1; length > 0; length--) {
+        for (int i = 0; ; i++) {
+            snprintf(name, sizeof(name), "%0*d", length, i);
+            if (internString(name) == NULL) {
+                break;
+            }
+        }
+    }
+    if (internString("regressionunits") != NULL) {
+        return false;
+    }
+
+    SVG* parsed = createSVGFromBuffer(unitsDocument, (int)strlen(unitsDocument));
+
+    xmlTextReaderPtr reader = xmlReaderForMemory(unitsDocument, (int)strlen(unitsDocument), NULL, NULL, 0);
+    SVG* streamed = buildSVGFromReader(reader, NULL, NULL);
+    xmlFreeTextReader(reader);
+
+    reader = xmlReaderForMemory(unitsDocument, (int)strlen(unitsDocument), NULL, NULL, 0);
+    SVGArena* arena = createArena(0);
+    SVG* arenaStreamed = (arena != NULL) ? buildSVGFromReader(reader, NULL, arena) : NULL;
+    xmlFreeTextReader(reader);
+
+    Rectangle* rect = JSONtoRect(unitsJSON);
+
+    /*Units and names every SVG uses are seeded, so they never depend on the table either*/
+    float value = 0;
+    const char* units = NULL;
+    bool seeded = parseLength("2.5cm", &value, &units) && units != NULL && strcmp(units, "cm") == 0;
+
+    bool passed = keptUnits(parsed) && keptUnits(streamed) && keptUnits(arenaStreamed) && seeded
+        && rect != NULL && strcmp(rect->units, "regressionunits") == 0;
+
+    /*Rebuilding the units of a parsed shape frees the copy they replace*/
+    if (passed) {
+        Rectangle* parsedRect = getFromFront(parsed->rectangles);
+        passed = addRectAttribute(NULL, parsedRect, "x", "3otherunits") && strcmp(parsedRect->units, "otherunits") == 0
+            && addRectAttribute(NULL, parsedRect, "y", "4cm") && parsedRect->units == units;
+    }
+
+    deleteSVG(parsed);
+    deleteSVG(streamed);
+    deleteSVG(arenaStreamed);
+    deleteRectangle(rect);
+    return passed;
+}
+
+typedef struct {
+    const char* name;
+    bool (*check)(void);
+} Regression;
+
+static const Regression regressions[] = {
+    {"addComponent then setAttribute on an arena SVG", &addComponentThenSetAttribute},
+    {"validateSVG rejects duplicate ids", &validateDuplicateIds},
+    {"addComponent of a path built by hand", &addHandBuiltPath},
+    {"recompiling the paths of an arena SVG does not grow its arena", &arenaPathRecompile},
+    {"countSVGFromReader rejects duplicate ids", &countDuplicateIds},
+    {"list pool slabs are reused after their thread exits", &listPoolThreadExit},
+    {"the streaming builder matches the DOM builder", &streamingMatchesDOM},
+    {"SVG structs built by hand are not cached", &handBuiltSVG},
+    {"valid files still parse once the intern table is full", &fullInternTable},
+};
+
+int main(void) {
+    int failures = 0;
+
+    for (size_t i = 0; i < sizeof(regressions) / sizeof(regressions[0]); i++) {
+        bool passed = regressions[i].check();
+
+        printf("%s: %s\n", passed ? "PASS" : "FAIL", regressions[i].name);
+        failures += !passed;
+    }
+
+    printf("%d of %zu checks failed\n", failures, sizeof(regressions) / sizeof(regressions[0]));
+    return (failures == 0) ? 0 : 1;
+}